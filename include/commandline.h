@@ -0,0 +1,29 @@
+#pragma once
+#ifndef COMMANDLINE_H
+#define COMMANDLINE_H
+
+#include <QStringList>
+
+class Map;
+class Project;
+
+// Runs porymap without the main window, for batch jobs and CI, e.g.
+//   porymap export-map --output images/ path/to/project MAP_LITTLEROOT_TOWN
+// Commands:
+//   export-map       Writes an image of each map given (or of every map) to the output folder.
+//   export-stitched  Writes an image of the given map stitched together with every map reachable through its connections.
+//   validate         Loads every map and layout, and exits with an error if any of them fail to load.
+//   resave           Loads and saves every map, layout and project data file.
+//   dump-stats       Prints the project's map, layout, tileset and event counts as JSON.
+//   benchmark        Times parsing, drawing and serializing the project's data, and prints the results as JSON.
+// No window is opened. If QT_QPA_PLATFORM isn't set, the offscreen platform is used so a display isn't needed.
+namespace CommandLine {
+    // Returns true if the arguments start with one of the commands above.
+    bool isCommand(int argc, char *argv[]);
+    // Called before the application is created.
+    void prepare();
+    // Runs the command and returns the exit code.
+    int run(const QStringList &arguments);
+}
+
+#endif // COMMANDLINE_H
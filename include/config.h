@@ -11,6 +11,10 @@
 #include <QDateTime>
 #include <QUrl>
 #include <QVersionNumber>
+#include <QPointer>
+#include <QTimer>
+#include <QSet>
+#include <functional>
 
 #include "events.h"
 
@@ -25,19 +29,72 @@ static const QVersionNumber porymapVersion = QVersionNumber::fromString(PORYMAP_
 class KeyValueConfigBase
 {
 public:
+    // Writes the config file, unless nothing has changed since it was last read or written.
     void save();
+    // Saves after a short delay, so that several changes in a row are only written once.
+    void saveLater();
+    bool hasPendingSave() const { return this->saveTimer && this->saveTimer->isActive(); }
     void load();
     virtual ~KeyValueConfigBase();
     virtual void reset() = 0;
 protected:
+    // How a key is read from and written to the config file.
+    // Keys without a write function are only read, e.g. old names kept for backwards compatibility.
+    struct Key {
+        std::function<void(const QString &key, const QString &value)> read;
+        std::function<QString()> write;
+    };
+    // Keys that share a prefix, like "path/". The functions see each key without the prefix,
+    // and write returns every key that should be saved with its value.
+    struct KeyGroup {
+        std::function<void(const QString &name, const QString &value)> read;
+        std::function<QMap<QString, QString>()> write;
+    };
+
     virtual QString getConfigFilepath() = 0;
-    virtual void parseConfigKeyValue(QString key, QString value) = 0;
-    virtual QMap<QString, QString> getKeyValueMap() = 0;
+    // Adds every key of the config with addKey() and addKeyGroup(). Loading and saving both use these, so they can't disagree.
+    virtual void registerKeys() = 0;
     virtual void init() = 0;
     virtual void setUnreadKeys() = 0;
+    void addKey(const QString &key, const Key &handler);
+    void addKeyGroup(const QString &prefix, const KeyGroup &group);
+    Key boolKey(bool *value);
+    Key intKey(int *value, int min = INT_MIN, int max = INT_MAX, int defaultValue = 0);
+    Key stringKey(QString *value);
+    template <typename T>
+    Key uintKey(T *value, uint32_t min = 0, uint32_t max = UINT_MAX) {
+        return Key{
+            [this, value, min, max](const QString &key, const QString &text) { *value = getConfigUint32(key, text, min, max); },
+            [value] { return QString::number(*value); }
+        };
+    }
+    template <typename T>
+    Key hexKey(T *value, uint32_t max = UINT_MAX) {
+        return Key{
+            [this, value, max](const QString &key, const QString &text) { *value = getConfigUint32(key, text, 0, max); },
+            [value] { return "0x" + QString::number(*value, 16).toUpper(); }
+        };
+    }
     bool getConfigBool(QString key, QString value);
     int getConfigInteger(QString key, QString value, int min = INT_MIN, int max = INT_MAX, int defaultValue = 0);
     uint32_t getConfigUint32(QString key, QString value, uint32_t min = 0, uint32_t max = UINT_MAX, uint32_t defaultValue = 0);
+
+    // Keys found in the config file since the last reset().
+    QSet<QString> readKeys;
+
+private:
+    void registerKeysOnce();
+    void parseConfigKeyValue(const QString &key, const QString &value);
+    QMap<QString, QString> getKeyValueMap();
+
+    QMap<QString, Key> keys;
+    QList<QPair<QString, KeyGroup>> keyGroups;
+    bool keysRegistered = false;
+
+    // The file's contents as of the last load or save.
+    QString savedText;
+    QString savedFilepath;
+    QPointer<QTimer> saveTimer;
 };
 
 class PorymapConfig: public KeyValueConfigBase
@@ -81,6 +138,10 @@ public:
         this->lastUpdateCheckTime = QDateTime();
         this->lastUpdateCheckVersion = porymapVersion;
         this->rateLimitTimes.clear();
+        this->imageCacheSize = 256;
+        this->scriptCallbackBudget = 50;
+        this->structuredLog = false;
+        this->performanceTracing = false;
     }
     void addRecentProject(QString project);
     void setRecentProjects(QStringList projects);
@@ -133,11 +194,14 @@ public:
     QVersionNumber lastUpdateCheckVersion;
     QMap<QUrl, QDateTime> rateLimitTimes;
     QByteArray wildMonChartGeometry;
+    int imageCacheSize;
+    int scriptCallbackBudget;
+    bool structuredLog;
+    bool performanceTracing;
 
 protected:
     virtual QString getConfigFilepath() override;
-    virtual void parseConfigKeyValue(QString key, QString value) override;
-    virtual QMap<QString, QString> getKeyValueMap() override;
+    virtual void registerKeys() override;
     virtual void init() override {};
     virtual void setUnreadKeys() override {};
 
@@ -376,13 +440,11 @@ public:
 
 protected:
     virtual QString getConfigFilepath() override;
-    virtual void parseConfigKeyValue(QString key, QString value) override;
-    virtual QMap<QString, QString> getKeyValueMap() override;
+    virtual void registerKeys() override;
     virtual void init() override;
     virtual void setUnreadKeys() override;
 
 private:
-    QStringList readKeys;
     QMap<ProjectIdentifier, QString> identifiers;
     QMap<ProjectFilePath, QString> filePaths;
     QMap<Event::Group, QString> eventIconPaths;
@@ -415,8 +477,7 @@ public:
 
 protected:
     virtual QString getConfigFilepath() override;
-    virtual void parseConfigKeyValue(QString key, QString value) override;
-    virtual QMap<QString, QString> getKeyValueMap() override;
+    virtual void registerKeys() override;
     virtual void init() override;
     virtual void setUnreadKeys() override;
 #ifdef CONFIG_BACKWARDS_COMPATABILITY
@@ -424,7 +485,6 @@ protected:
 #endif
 
 private:
-    QStringList readKeys;
     QMap<QString, bool> customScripts;
 };
 
@@ -453,8 +513,7 @@ public:
 
 protected:
     virtual QString getConfigFilepath() override;
-    virtual void parseConfigKeyValue(QString key, QString value) override;
-    virtual QMap<QString, QString> getKeyValueMap() override;
+    virtual void registerKeys() override;
     virtual void init() override { };
     virtual void setUnreadKeys() override { };
 
@@ -479,4 +538,7 @@ private:
 
 extern ShortcutsConfig shortcutsConfig;
 
+// Writes any configs with a save waiting from saveLater(). Called before the project closes and before exiting.
+void savePendingConfigs();
+
 #endif // CONFIG_H
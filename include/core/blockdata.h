@@ -5,12 +5,45 @@
 #include "block.h"
 
 #include <QByteArray>
+#include <QSharedPointer>
 #include <QVector>
 
+class QFile;
+
 class Blockdata : public QVector<Block>
 {
 public:
     QByteArray serialize() const;
 };
 
+// A read-only view of a blockdata file, which is memory-mapped rather than read into memory.
+// Blocks are only decoded when they're accessed, so scanning many layouts doesn't copy each of them.
+// Use toBlockdata() to get blockdata that can be edited.
+class BlockdataView
+{
+public:
+    BlockdataView() = default;
+    explicit BlockdataView(const QByteArray &data);
+
+    // Returns an invalid view if the file can't be opened.
+    static BlockdataView fromFile(const QString &path);
+
+    bool isValid() const { return this->valid; }
+    int length() const { return this->size / 2; }
+    uint16_t rawValue(int i) const {
+        return static_cast<uint16_t>(this->data[i * 2] | (this->data[i * 2 + 1] << 8));
+    }
+    Block at(int i) const { return Block(rawValue(i)); }
+
+    Blockdata toBlockdata() const;
+
+private:
+    // Keeps the file (and so its mapping) or the bytes being viewed alive while the view is copied around.
+    QSharedPointer<QFile> file;
+    QByteArray bytes;
+    const uchar *data = nullptr;
+    qint64 size = 0;
+    bool valid = false;
+};
+
 #endif // BLOCKDATA_H
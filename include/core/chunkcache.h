@@ -0,0 +1,69 @@
+#pragma once
+#ifndef CHUNKCACHE_H
+#define CHUNKCACHE_H
+
+#include "block.h"
+
+#include <QHash>
+#include <QVector>
+#include <QImage>
+#include <QPainter>
+#include <functional>
+
+// Rasterizes a grid of 16x16 blocks in square "chunks", but only for the chunks that actually get drawn.
+// This lets a very large layout be displayed without ever rendering (or holding in memory) an image of the
+// entire layout. Rendered chunks are kept and reused until the cache grows beyond its budget, at which point
+// the chunks that were drawn least recently are evicted.
+class ChunkCache
+{
+public:
+    // Retrieves the block at the given metatile coordinates. Returns false if nothing should be drawn there.
+    using BlockSource = std::function<bool(int x, int y, Block *block)>;
+    // Draws one block into a chunk image with its top-left corner at the given pixel position.
+    // The 16x16 area is always cleared to transparent beforehand. Chunk images use 'ChunkCache::imageFormat'.
+    using BlockPainter = std::function<void(QImage *image, const QPoint &origin, const Block &block)>;
+
+    ChunkCache(BlockSource source, BlockPainter painter, int budget = ChunkCache::defaultBudget);
+
+    // Width/height of a chunk, in metatiles
+    static constexpr int chunkSize = 16;
+    // Default maximum number of chunks to keep rendered. At 256x256 pixels each, 128 chunks is 32 MiB.
+    static constexpr int defaultBudget = 128;
+    // Chunks are stored in the format the raster paint engine can draw without any conversion.
+    static constexpr QImage::Format imageFormat = QImage::Format_ARGB32_Premultiplied;
+
+    void setBudget(int budget);
+    int getBudget() const { return this->budget; }
+    int numCachedChunks() const { return this->chunks.size(); }
+
+    // Draws the part of the grid that intersects 'rect' (in pixels), rendering any chunks that are missing or out of date.
+    // Chunks are compared against the blocks they were rendered from, so only blocks that changed are redrawn.
+    void draw(QPainter *painter, const QRect &rect);
+
+    // Discards every rendered chunk. Use when something other than the blocks changes how they're drawn (e.g. tilesets).
+    void invalidate();
+    // Discards the rendered chunks that intersect the given area (in metatiles).
+    void invalidate(const QRect &metatileRect);
+
+private:
+    struct Chunk {
+        QImage image;
+        QVector<Block> blocks;   // The blocks this chunk was rendered from
+        QVector<bool> hasBlock;  // Whether the source provided a block at each position
+        quint64 lastUsed = 0;
+    };
+
+    BlockSource blockSource;
+    BlockPainter blockPainter;
+    int budget;
+    quint64 drawCount = 0;
+    QHash<quint64, Chunk> chunks;
+
+    static quint64 chunkKey(int chunkX, int chunkY);
+    static int chunkCoord(int metatileCoord);
+    void render(Chunk *chunk, int chunkX, int chunkY);
+    void refresh(Chunk *chunk, int chunkX, int chunkY);
+    void evict();
+};
+
+#endif // CHUNKCACHE_H
@@ -5,11 +5,13 @@
 #include <QString>
 #include <QMap>
 #include <QSet>
+#include <QHash>
 #include <QPixmap>
 #include <QJsonObject>
 #include <QPointer>
 
 #include "orderedjson.h"
+#include "symboltable.h"
 using OrderedJson = poryjson::Json;
 
 
@@ -45,9 +47,19 @@ public:
 struct EventGraphics
 {
     QImage spritesheet;
+    QString spritesheetPath;
     int spriteWidth;
     int spriteHeight;
     bool inanimate;
+    // The spritesheet is decoded the first time it's needed (see Project::requestEventSpritesheet).
+    bool loaded = false;
+
+    // Returns the sprite for a frame, ready to display. Each frame and flip is only made once, and shared by every event using these graphics.
+    QPixmap getFrame(int frame, bool hFlip);
+    void setSpritesheet(const QImage &image);
+
+private:
+    QHash<int, QPixmap> frames;
 };
 
 
@@ -243,10 +255,10 @@ public:
     virtual void loadPixmap(Project *project) override;
 
     void setGfx(QString newGfx) { this->gfx = newGfx; }
-    QString getGfx() { return this->gfx; }
+    QString getGfx() { return this->gfx.toString(); }
 
     void setMovement(QString newMovement) { this->movement = newMovement; }
-    QString getMovement() { return this->movement; }
+    QString getMovement() { return this->movement.toString(); }
 
     void setRadiusX(int newRadiusX) { this->radiusX = newRadiusX; }
     int getRadiusX() { return this->radiusX; }
@@ -255,16 +267,16 @@ public:
     int getRadiusY() { return this->radiusY; }
 
     void setTrainerType(QString newTrainerType) { this->trainerType = newTrainerType; }
-    QString getTrainerType() { return this->trainerType; }
+    QString getTrainerType() { return this->trainerType.toString(); }
 
     void setSightRadiusBerryTreeID(QString newValue) { this->sightRadiusBerryTreeID = newValue; }
     QString getSightRadiusBerryTreeID() { return this->sightRadiusBerryTreeID; }
 
     void setScript(QString newScript) { this->script = newScript; }
-    QString getScript() { return this->script; }
+    QString getScript() { return this->script.toString(); }
 
     void setFlag(QString newFlag) { this->flag = newFlag; }
-    QString getFlag() { return this->flag; }
+    QString getFlag() { return this->flag.toString(); }
 
 public:
     void setFrameFromMovement(QString movement);
@@ -272,14 +284,14 @@ public:
 
 
 protected:
-    QString gfx;
-    QString movement;
+    Symbol gfx;
+    Symbol movement;
     int radiusX = 0;
     int radiusY = 0;
-    QString trainerType;
+    Symbol trainerType;
     QString sightRadiusBerryTreeID;
-    QString script;
-    QString flag;
+    Symbol script;
+    Symbol flag;
 
     int frame = 0;
     bool hFlip = false;
@@ -314,13 +326,13 @@ public:
     virtual void loadPixmap(Project *project) override;
 
     void setTargetMap(QString newTargetMap) { this->targetMap = newTargetMap; }
-    QString getTargetMap() { return this->targetMap; }
+    QString getTargetMap() { return this->targetMap.toString(); }
 
     void setTargetID(int newTargetID) { this->targetID = newTargetID; }
     int getTargetID() { return this->targetID; }
 
 private:
-    QString targetMap;
+    Symbol targetMap;
     int targetID = 0;
 };
 
@@ -350,7 +362,7 @@ public:
     virtual QSet<QString> getExpectedFields() override;
 
     void setDestinationMap(QString newDestinationMap) { this->destinationMap = newDestinationMap; }
-    QString getDestinationMap() { return this->destinationMap; }
+    QString getDestinationMap() { return this->destinationMap.toString(); }
 
     void setDestinationWarpID(QString newDestinationWarpID) { this->destinationWarpID = newDestinationWarpID; }
     QString getDestinationWarpID() { return this->destinationWarpID; }
@@ -358,7 +370,7 @@ public:
     void setWarningEnabled(bool enabled);
 
 private:
-    QString destinationMap;
+    Symbol destinationMap;
     QString destinationWarpID;
 };
 
@@ -413,18 +425,18 @@ public:
     virtual QSet<QString> getExpectedFields() override;
 
     void setScriptVar(QString newScriptVar) { this->scriptVar = newScriptVar; }
-    QString getScriptVar() { return this->scriptVar; }
+    QString getScriptVar() { return this->scriptVar.toString(); }
 
     void setScriptVarValue(QString newScriptVarValue) { this->scriptVarValue = newScriptVarValue; }
     QString getScriptVarValue() { return this->scriptVarValue; }
 
     void setScriptLabel(QString newScriptLabel) { this->scriptLabel = newScriptLabel; }
-    QString getScriptLabel() { return this->scriptLabel; }
+    QString getScriptLabel() { return this->scriptLabel.toString(); }
 
 private:
-    QString scriptVar;
+    Symbol scriptVar;
     QString scriptVarValue;
-    QString scriptLabel;
+    Symbol scriptLabel;
 };
 
 
@@ -453,10 +465,10 @@ public:
     virtual QSet<QString> getExpectedFields() override;
 
     void setWeather(QString newWeather) { this->weather = newWeather; }
-    QString getWeather() { return this->weather; }
+    QString getWeather() { return this->weather.toString(); }
 
 private:
-    QString weather;
+    Symbol weather;
 };
 
 
@@ -511,14 +523,14 @@ public:
     virtual QSet<QString> getExpectedFields() override;
 
     void setFacingDirection(QString newFacingDirection) { this->facingDirection = newFacingDirection; }
-    QString getFacingDirection() { return this->facingDirection; }
+    QString getFacingDirection() { return this->facingDirection.toString(); }
 
     void setScriptLabel(QString newScriptLabel) { this->scriptLabel = newScriptLabel; }
-    QString getScriptLabel() { return this->scriptLabel; }
+    QString getScriptLabel() { return this->scriptLabel.toString(); }
 
 private:
-    QString facingDirection;
-    QString scriptLabel;
+    Symbol facingDirection;
+    Symbol scriptLabel;
 };
 
 
@@ -546,10 +558,10 @@ public:
     virtual QSet<QString> getExpectedFields() override;
 
     void setItem(QString newItem) { this->item = newItem; }
-    QString getItem() { return this->item; }
+    QString getItem() { return this->item.toString(); }
 
     void setFlag(QString newFlag) { this->flag = newFlag; }
-    QString getFlag() { return this->flag; }
+    QString getFlag() { return this->flag.toString(); }
 
     void setQuantity(int newQuantity) { this->quantity = newQuantity; }
     int getQuantity() { return this->quantity; }
@@ -558,8 +570,8 @@ public:
     bool getUnderfoot() { return this->underfoot; }
 
 private:
-    QString item;
-    QString flag;
+    Symbol item;
+    Symbol flag;
 
     // optional
     int quantity = 0;
@@ -591,10 +603,10 @@ public:
     virtual QSet<QString> getExpectedFields() override;
 
     void setBaseID(QString newBaseID) { this->baseID = newBaseID; }
-    QString getBaseID() { return this->baseID; }
+    QString getBaseID() { return this->baseID.toString(); }
 
 private:
-    QString baseID;
+    Symbol baseID;
 };
 
 
@@ -632,7 +644,7 @@ public:
     QString getIdName() { return this->idName; }
 
     void setRespawnMap(QString newRespawnMap) { this->respawnMap = newRespawnMap; }
-    QString getRespawnMap() { return this->respawnMap; }
+    QString getRespawnMap() { return this->respawnMap.toString(); }
 
     void setRespawnNPC(uint8_t newRespawnNPC) { this->respawnNPC = newRespawnNPC; }
     uint8_t getRespawnNPC() { return this->respawnNPC; }
@@ -641,7 +653,7 @@ private:
     int index = -1;
     QString locationName;
     QString idName;
-    QString respawnMap;
+    Symbol respawnMap;
     uint8_t respawnNPC = 0;
 };
 
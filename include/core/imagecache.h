@@ -0,0 +1,57 @@
+#pragma once
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <QDateTime>
+#include <QImage>
+#include <QList>
+#include <QRect>
+#include <QString>
+
+// Decoded images loaded from files in the project (script overlay images, event sprite sheets, region map tilesets, etc.).
+// Images are keyed by their canonical path and modification time, so the same file referenced by different paths is only
+// decoded once and a file that changes on disk is decoded again. Copies with a transform applied are cached the same way.
+// Once the images in the cache are larger than its budget, the least recently used images are dropped.
+// The cache is only used from the GUI thread, but images can be decoded on other threads with read() and added with insert().
+namespace ImageCache {
+    // Changes to apply to an image, in this order.
+    struct Transform {
+        // The area of the image to keep. A null rect keeps the whole image.
+        QRect crop;
+        // Negative scales flip the image.
+        qreal hScale = 1;
+        qreal vScale = 1;
+        // Replaces the first colors in an indexed image's color table.
+        QList<QRgb> palette;
+        // Makes color 0 of an indexed image transparent.
+        bool setTransparency = false;
+
+        bool isIdentity() const;
+    };
+
+    // An image decoded from a file, and the file's modification time from before it was decoded.
+    struct File {
+        QString canonicalPath;
+        QDateTime lastModified;
+        QImage image;
+    };
+
+    // Returns the image at 'filepath' with 'transform' applied, or a null image if it can't be read.
+    QImage get(const QString &filepath, const Transform &transform = Transform());
+    // Returns the image at 'filepath' if it's in the cache, otherwise a null image.
+    QImage find(const QString &filepath);
+    // Decodes the image at 'filepath' without using the cache. Unlike the rest of the cache, this can be used from any thread.
+    File read(const QString &filepath);
+    // Adds an image returned by read() to the cache.
+    void insert(const File &file);
+    // Drops every cached image of the file at 'filepath'.
+    void remove(const QString &filepath);
+    void clear();
+
+    // The budget is in bytes.
+    void setBudget(qint64 bytes);
+    qint64 budget();
+    qint64 size();
+}
+
+#endif // IMAGECACHE_H
@@ -0,0 +1,24 @@
+#pragma once
+#ifndef INDEXEDPNG_H
+#define INDEXEDPNG_H
+
+#include <QImage>
+#include <QString>
+
+// Reads and writes paletted PNG files (like tileset tile images) directly as QImage::Format_Indexed8,
+// without going through Qt's general-purpose image plugins and format conversions.
+// These functions don't touch any shared state, so they're safe to call from worker threads.
+namespace IndexedPng {
+    // Standard (zlib/PNG) CRC-32 of 'length' bytes, continuing from 'crc'.
+    quint32 crc32(const uchar *data, qsizetype length, quint32 crc = 0);
+
+    // Decodes a non-interlaced PNG with a bit depth of 1, 2, 4 or 8 and a color palette.
+    // Returns a null image (and sets 'error', if provided) if the file can't be read or uses any other format.
+    QImage read(const QString &filepath, QString *error = nullptr);
+
+    // Encodes an indexed image as a paletted PNG with the given bit depth (1, 2, 4 or 8).
+    // Pixel values that don't fit in the bit depth are truncated.
+    bool write(const QImage &image, const QString &filepath, int bitDepth, QString *error = nullptr);
+}
+
+#endif // INDEXEDPNG_H
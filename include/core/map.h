@@ -47,9 +47,9 @@ public:
     QString weather;
     QString type;
     bool show_location;
-    bool allowRunning;
-    bool allowBiking;
-    bool allowEscaping;
+    bool allowRunning = true;
+    bool allowBiking = true;
+    bool allowEscaping = true;
     int floorNumber = 0;
     QString battle_scene;
 
@@ -96,7 +96,6 @@ public:
     void addConnection(MapConnection *);
     void loadConnection(MapConnection *);
     QRect getConnectionRect(const QString &direction, Layout *fromLayout = nullptr);
-    QPixmap renderConnection(const QString &direction, Layout *fromLayout = nullptr);
 
     QUndoStack editHistory;
     void modify();
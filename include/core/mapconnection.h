@@ -2,12 +2,18 @@
 #ifndef MAPCONNECTION_H
 #define MAPCONNECTION_H
 
+#include "blockdata.h"
+
 #include <QString>
 #include <QObject>
 #include <QMap>
+#include <QPixmap>
+#include <QRect>
 
 class Project;
 class Map;
+class Layout;
+class Tileset;
 
 class MapConnection : public QObject
 {
@@ -32,7 +38,7 @@ public:
     MapConnection* findMirror();
     MapConnection* createMirror();
 
-    QPixmap getPixmap();
+    QPixmap getPixmap(bool forceRender = false);
 
     static QPointer<Project> project;
     static const QMap<QString, QString> oppositeDirections;
@@ -50,6 +56,20 @@ private:
     QString m_direction;
     int m_offset;
 
+    // The last rendered image of the connected map, and everything that was used to render it.
+    struct {
+        QPixmap pixmap;
+        Blockdata blocks;
+        QRect bounds;
+        QString direction;
+        Layout *layout = nullptr;
+        Tileset *primaryTileset = nullptr;
+        Tileset *secondaryTileset = nullptr;
+        quint64 primaryRevision = 0;
+        quint64 secondaryRevision = 0;
+        size_t paletteKey = 0;
+    } m_pixmapCache;
+
     void markMapEdited();
     Map* getMap(const QString& mapName) const;
 
@@ -0,0 +1,62 @@
+#pragma once
+#ifndef MAPIMAGERENDERER_H
+#define MAPIMAGERENDERER_H
+
+#include <QPixmap>
+#include <QString>
+#include <functional>
+
+class Project;
+class Map;
+class Layout;
+
+// How many metatiles of border are drawn around each map in stitched and timelapse images.
+#define STITCH_MODE_BORDER_DISTANCE 2
+
+struct ImageExporterSettings {
+    bool showObjects = false;
+    bool showWarps = false;
+    bool showBGs = false;
+    bool showTriggers = false;
+    bool showHealLocations = false;
+    bool showUpConnections = false;
+    bool showDownConnections = false;
+    bool showLeftConnections = false;
+    bool showRightConnections = false;
+    bool showGrid = false;
+    bool showBorder = false;
+    bool showCollision = false;
+    bool previewActualSize = false;
+    int timelapseSkipAmount = 1;
+    int timelapseDelayMs = 200;
+    qreal collisionOpacity = 0.5;
+
+    bool showEvents() const { return showObjects || showWarps || showBGs || showTriggers || showHealLocations; }
+    bool showConnections() const { return showUpConnections || showDownConnections || showLeftConnections || showRightConnections; }
+};
+
+// Draws the images of the map image exporter. It only needs the project,
+// so the command line draws its images with it too.
+class MapImageRenderer
+{
+public:
+    // Returns false to cancel. 'label' describes the current step.
+    using Progress = std::function<bool(const QString &label, int value, int maximum)>;
+
+    MapImageRenderer(Project *project, const ImageExporterSettings &settings, int borderDistance);
+
+    // Draws the map, or only the layout if there's no map.
+    // With 'ignoreBorder' the border and connections are left out and the image is only the size of the map.
+    QPixmap render(Map *map, Layout *layout, bool ignoreBorder = false) const;
+
+    // Draws the map together with every map reachable through its up/down/left/right connections.
+    // Returns a null pixmap if it was canceled.
+    QPixmap renderStitched(Map *startMap, const Progress &progress = nullptr) const;
+
+private:
+    Project *project;
+    ImageExporterSettings settings;
+    int borderDistance;
+};
+
+#endif // MAPIMAGERENDERER_H
@@ -20,6 +20,8 @@ public:
     Layout() {}
 
     static QString layoutConstantFromName(QString mapName);
+    // How many metatiles of a border with the given width or height are drawn on each side of the layout.
+    static int getBorderDrawDistance(int dimension);
 
     bool loaded = false;
 
@@ -51,8 +53,14 @@ public:
 
     Blockdata border;
     Blockdata cached_blockdata;
-    Blockdata cached_collision;
     Blockdata cached_border;
+    // The tilesets that 'image' was last drawn with. If they change, every metatile is redrawn.
+    struct {
+        Tileset *primary = nullptr;
+        Tileset *secondary = nullptr;
+        quint64 primaryRevision = 0;
+        quint64 secondaryRevision = 0;
+    } cached_tilesets;
     struct {
         Blockdata blocks;
         QSize layoutDimensions;
@@ -100,7 +108,6 @@ public:
     void setBorderDimensions(int newWidth, int newHeight, bool setNewBlockdata = true, bool enableScriptCallback = false);
 
     void cacheBlockdata();
-    void cacheCollision();
     void clearBorderCache();
     void cacheBorder();
 
@@ -116,12 +123,12 @@ public:
     void _floodFillCollisionElevation(int x, int y, uint16_t collision, uint16_t elevation);
     void magicFillCollisionElevation(int x, int y, uint16_t collision, uint16_t elevation);
 
-    QPixmap render(bool ignoreCache = false, Layout *fromLayout = nullptr, QRect bounds = QRect(0, 0, -1, -1));
-    QPixmap renderCollision(bool ignoreCache);
-    // QPixmap renderConnection(MapConnection, Layout *);
+    QPixmap render(bool ignoreCache = false);
+    QPixmap renderCollision();
     QPixmap renderBorder(bool ignoreCache = false);
 
-    QPixmap getLayoutItemPixmap();
+    Blockdata getBlocks(const QRect &area);
+    QImage renderBlocks(const Blockdata &blocks, int blocksWidth, Tileset *primaryTileset, Tileset *secondaryTileset) const;
 
     void setLayoutItem(LayoutPixmapItem *item) { layoutItem = item; }
     void setCollisionItem(CollisionPixmapItem *item) { collisionItem = item; }
@@ -11,6 +11,25 @@ class MapParser
 public:
     MapParser();
     Layout *parse(QString filepath, bool *error, Project *project);
+    // Parses each of the files in parallel. The layouts are returned in the same order as their files,
+    // with nullptr for any files that couldn't be parsed.
+    QList<Layout *> parseAll(const QStringList &filepaths, Project *project);
+
+private:
+    // The contents of a .map file. Reading it doesn't touch the project, so it can be done on any thread.
+    struct MapData {
+        bool error = false;
+        int width = 0;
+        int height = 0;
+        int borderWidth = 0;
+        int borderHeight = 0;
+        int primaryTilesetNum = 0;
+        int secondaryTilesetNum = 0;
+        Blockdata blockdata;
+        Blockdata border;
+    };
+    static MapData read(const QString &filepath);
+    Layout *createLayout(const MapData &data, Project *project);
 };
 
 #endif // MAPPARSER_H
@@ -0,0 +1,54 @@
+#pragma once
+#ifndef PALETTETABLE_H
+#define PALETTETABLE_H
+
+#include <QList>
+#include <QRgb>
+#include <QSharedPointer>
+#include <QVector>
+
+class Tileset;
+
+// The colors of every palette available to a primary/secondary tileset pair, stored in one contiguous array
+// as premultiplied ARGB, ready to be written straight into an image. For each palette there is a copy with the colors
+// as-is, and for each metatile layer a copy with that layer's opacity applied, both with and without color 0 transparent.
+// Tables are cached and only rebuilt when the tilesets' palettes or the layer opacities change.
+class PaletteTable
+{
+public:
+    static constexpr int numColors = 16;
+    static constexpr int numLayers = 3;
+
+    static QSharedPointer<const PaletteTable> get(Tileset *primaryTileset, Tileset *secondaryTileset, const QList<float> &layerOpacity, bool useTruePalettes = false);
+
+    int numPalettes() const { return this->m_numPalettes; }
+
+    // Returns the 16 colors of the palette unchanged, or nullptr if there's no such palette.
+    const QRgb *colors(int paletteId) const;
+    // Returns the 16 colors of the palette as drawn on the given metatile layer, or nullptr if there's no such palette.
+    const QRgb *colors(int paletteId, int layer, bool transparentFirstColor) const;
+
+    // Fills 'out' with 'palette' adjusted the same way as the layer colors above. Missing colors are black.
+    static void makeLayerColors(const QList<QRgb> &palette, float opacity, bool transparentFirstColor, QRgb *out);
+
+private:
+    PaletteTable() = default;
+
+    Tileset *primaryTileset = nullptr;
+    Tileset *secondaryTileset = nullptr;
+    bool useTruePalettes = false;
+    float opacity[numLayers] = {};
+    int numPalettesPrimary = 0;
+    int m_numPalettes = 0;
+    // The palettes the table was built from. These share data with the tilesets' palettes until they're modified,
+    // so comparing against them is nearly free when nothing has changed.
+    QList<QList<QRgb>> primaryPalettes;
+    QList<QList<QRgb>> secondaryPalettes;
+    QVector<QRgb> table;
+
+    void build();
+    bool isCurrent(Tileset *primaryTileset, Tileset *secondaryTileset, const float *opacity, bool useTruePalettes) const;
+    static int layerVariant(int layer, bool transparentFirstColor);
+};
+
+#endif // PALETTETABLE_H
@@ -0,0 +1,122 @@
+#pragma once
+#ifndef PROJECTVALIDATOR_H
+#define PROJECTVALIDATOR_H
+
+#include <QHash>
+#include <QList>
+#include <QPoint>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+#include "wildmoninfo.h"
+
+class Project;
+class Map;
+class Layout;
+class Tileset;
+
+// A problem found in the project's data.
+struct ValidationIssue {
+    enum class Severity {
+        Error,
+        Warning,
+    };
+
+    Severity severity = Severity::Warning;
+    QString rule;
+    // Where the problem is. One of these is set.
+    QString mapName;
+    QString layoutId;
+    QString tilesetLabel;
+    // The metatile coordinates of the problem on the map or layout, if it has one.
+    QPoint position = QPoint(-1, -1);
+    QString message;
+
+    QString location() const;
+};
+
+class ValidationContext;
+
+// A check run over every map, layout or tileset in the project.
+struct ValidationRule {
+    enum class Target {
+        Map,
+        Layout,
+        Tileset,
+    };
+
+    QString name;
+    QString description;
+    Target target;
+    // Rules run on worker threads, so they may only read the project's data.
+    std::function<void(ValidationContext &)> check;
+};
+
+// The data a rule is checking, and where it reports the problems it finds.
+class ValidationContext {
+public:
+    Project *project = nullptr;
+    Map *map = nullptr;
+    Layout *layout = nullptr;
+    Tileset *tileset = nullptr;
+
+    // Names that are looked up by many rules, gathered before the rules run.
+    const QSet<QString> *mapNames = nullptr;
+    const QSet<QString> *flagNames = nullptr;
+    const QSet<QString> *varNames = nullptr;
+    const QSet<QString> *speciesNames = nullptr;
+    // The script labels the map's events can use.
+    QSet<QString> scriptLabels;
+    // The number of warps on each map.
+    const QHash<QString, int> *warpCounts = nullptr;
+    // The map's wild encounter groups, read before the rules run so that encounters that weren't loaded stay unloaded.
+    tsl::ordered_map<QString, WildPokemonHeader> encounters;
+
+    void error(const QString &message, QPoint position = QPoint(-1, -1)) { report(ValidationIssue::Severity::Error, message, position); }
+    void warning(const QString &message, QPoint position = QPoint(-1, -1)) { report(ValidationIssue::Severity::Warning, message, position); }
+
+private:
+    friend class ProjectValidator;
+    QString rule;
+    QList<ValidationIssue> issues;
+    void report(ValidationIssue::Severity severity, const QString &message, QPoint position);
+};
+
+// Checks every map, layout and tileset in the project against the rules below.
+// Everything is loaded on the calling thread first, since loading isn't thread-safe,
+// then the rules are run on the thread pool. The issues found are kept for each map, layout and tileset,
+// so after an edit only the data that changed needs to be checked again.
+class ProjectValidator
+{
+public:
+    explicit ProjectValidator(Project *project);
+
+    static const QList<ValidationRule> &rules();
+
+    // Loads and checks everything. Returns false if any maps or layouts failed to load, which are also reported as errors.
+    bool validateAll();
+    // Checks a map (and its layout and tilesets) again, replacing its previous issues.
+    void revalidateMap(const QString &mapName);
+
+    QList<ValidationIssue> getIssues() const;
+    int errorCount() const;
+
+private:
+    Project *project;
+    QHash<QString, QList<ValidationIssue>> issuesByTarget;
+    QList<ValidationIssue> loadIssues;
+
+    QSet<QString> mapNames;
+    QSet<QString> flagNames;
+    QSet<QString> varNames;
+    QSet<QString> speciesNames;
+    QSet<QString> globalScriptLabels;
+    QHash<QString, int> warpCounts;
+
+    void gatherNames();
+    void run(const QList<Map *> &maps, const QList<Layout *> &layouts, const QList<Tileset *> &tilesets);
+};
+
+#endif // PROJECTVALIDATOR_H
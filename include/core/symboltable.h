@@ -0,0 +1,49 @@
+#pragma once
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+// A project-wide table of the identifiers read from the project (flags, vars, scripts, gfx constants, species, etc.).
+// Each distinct name is stored once and given a 32-bit ID, so data that repeats the same identifiers many times
+// (like events and wild encounters) only needs to store the ID, and everything that asks for the name gets the same string data.
+// IDs aren't removed or reused while a project is open. The table is cleared once no projects are open,
+// so names from a closed project don't carry over to the next one. The table is only modified on the GUI thread.
+namespace SymbolTable {
+    // Returns the ID for 'name', adding it to the table if it's new. The empty string is always ID 0.
+    quint32 intern(const QString &name);
+    // Returns the ID for 'name', or 0 if it isn't in the table. Doesn't modify the table.
+    quint32 find(const QString &name);
+    QString name(quint32 id);
+    // Replaces each string in the list with the table's copy, adding any that are new.
+    void intern(QStringList *names);
+    int size();
+    // Removes every name. Any Symbols still in use become invalid.
+    void clear();
+}
+
+// A reference to a name in the SymbolTable. Comparing and hashing symbols only compares their IDs.
+class Symbol
+{
+public:
+    Symbol() = default;
+    Symbol(const QString &name) : m_id(SymbolTable::intern(name)) {}
+
+    quint32 id() const { return this->m_id; }
+    bool isEmpty() const { return this->m_id == 0; }
+    QString toString() const { return SymbolTable::name(this->m_id); }
+
+    bool operator==(const Symbol &other) const { return this->m_id == other.m_id; }
+    bool operator!=(const Symbol &other) const { return this->m_id != other.m_id; }
+
+private:
+    quint32 m_id = 0;
+};
+
+inline uint qHash(const Symbol &symbol, uint seed = 0) {
+    return qHash(symbol.id(), seed);
+}
+
+#endif // SYMBOLTABLE_H
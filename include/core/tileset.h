@@ -40,6 +40,11 @@ public:
 
     bool hasUnsavedTilesImage;
 
+    // Increased whenever the tileset's tiles, metatiles or palettes change,
+    // so that images drawn from the tileset can tell when they're out of date.
+    quint64 revision() const { return m_revision; }
+    void markChanged() { m_revision++; }
+
     static Tileset* getMetatileTileset(int, Tileset*, Tileset*);
     static Tileset* getTileTileset(int, Tileset*, Tileset*);
     static Metatile* getMetatile(int, Tileset*, Tileset*);
@@ -50,7 +55,6 @@ public:
     static bool setMetatileLabel(int, QString, Tileset *, Tileset *);
     QString getMetatileLabelPrefix();
     static QString getMetatileLabelPrefix(const QString &name);
-    static QList<QList<QRgb>> getBlockPalettes(Tileset*, Tileset*, bool useTruePalettes = false);
     static QList<QRgb> getPalette(int, Tileset*, Tileset*, bool useTruePalettes = false);
     static bool metatileIsValid(uint16_t metatileId, Tileset *, Tileset *);
     static QHash<int, QString> getHeaderMemberMap(bool usingAsm);
@@ -72,6 +76,7 @@ public:
 
 private:
     QList<Metatile*> m_metatiles;
+    quint64 m_revision = 0;
 };
 
 #endif // TILESET_H
@@ -0,0 +1,44 @@
+#pragma once
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+// Records how long instrumented scopes take (project loading, rendering, saving, etc.).
+// When recording stops the scopes are written to a trace file in Chrome's trace event format, which can be
+// opened in Perfetto or chrome://tracing, and a summary of the time spent in each scope is logged.
+// Recording is turned on in the preferences, or by setting the PORYMAP_TRACE environment variable
+// (to 1, or to the path to write the trace to).
+// Scopes can be recorded on any thread.
+namespace Tracer {
+    void init(bool enabled);
+    void setEnabled(bool enabled);
+    bool isEnabled();
+    // Writes the trace and the summary of everything recorded so far, then clears it.
+    void finish();
+    QString getTracePath();
+
+    void record(const char *name, qint64 startUs, qint64 durationUs);
+    qint64 now();
+}
+
+// Records the time from its construction to the end of the scope. 'name' must be a string literal.
+class TraceScope {
+public:
+    explicit TraceScope(const char *name) : name(name), start(Tracer::isEnabled() ? Tracer::now() : -1) {}
+    ~TraceScope() {
+        if (this->start >= 0)
+            Tracer::record(this->name, this->start, Tracer::now() - this->start);
+    }
+
+private:
+    const char *name;
+    qint64 start;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+
+#endif // TRACER_H
@@ -4,11 +4,12 @@
 
 #include <QtWidgets>
 #include "orderedmap.h"
+#include "symboltable.h"
 
 struct WildPokemon {
     int minLevel = 5;
     int maxLevel = 5;
-    QString species = "SPECIES_NONE"; // TODO: Use define_species_prefix
+    Symbol species = Symbol(QStringLiteral("SPECIES_NONE")); // TODO: Use define_species_prefix
 };
 
 struct WildMonInfo {
@@ -23,6 +23,7 @@
 #include "currentselectedmetatilespixmapitem.h"
 #include "collisionpixmapitem.h"
 #include "layoutpixmapitem.h"
+#include "mapborderitem.h"
 #include "settings.h"
 #include "gridsettings.h"
 #include "movablerect.h"
@@ -89,7 +90,7 @@ public:
     void displayWildMonTables();
 
     void updateMapBorder();
-    void updateMapConnections();
+    void updateMapConnections(bool forceRender = false);
 
     void setConnectionsVisibility(bool visible);
     void updateDivingMapsVisibility();
@@ -133,7 +134,7 @@ public:
     QPointer<CollisionPixmapItem> collision_item = nullptr;
     QGraphicsItemGroup *events_group = nullptr;
 
-    QList<QGraphicsPixmapItem*> borderItems;
+    MapBorderItem *border_item = nullptr;
     QGraphicsItemGroup *mapGrid = nullptr;
     MapRuler *map_ruler = nullptr;
 
@@ -178,12 +179,11 @@ public:
 
     int scaleIndex = 2;
     qreal collisionOpacity = 0.5;
-    static QList<QList<const QImage*>> collisionIcons;
+    // One 16x16 icon for each collision (column) and elevation (row), in ChunkCache::imageFormat.
+    static QImage collisionAtlas;
 
     void objectsView_onMousePress(QMouseEvent *event);
 
-    int getBorderDrawDistance(int dimension);
-
     bool selectingEvent = false;
 
     void deleteSelectedEvents();
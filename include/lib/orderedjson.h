@@ -56,6 +56,7 @@
 #define ORDERED_JSON_H
 
 #include <QString>
+#include <QByteArray>
 #include <QVector>
 #include <QPair>
 #include <QFile>
@@ -170,6 +171,9 @@ public:
 
     // Serialize.
     void dump(QString &out, int *) const;
+    // Serialize as UTF-8, appending to 'out'. 'indent' is the nesting level of this value,
+    // and 'afterKey' should be set if it's being written on the same line as an object key.
+    void dump(QByteArray &out, int indent = 0, bool afterKey = false) const;
     QString dump(int *indent = nullptr) const {
         QString out;
         if (!indent) {
@@ -181,6 +185,10 @@ public:
     }
 
     // Parse. If parse fails, return Json() and assign an error message to err.
+    // The input is parsed as UTF-8, so reading a file's bytes and passing them here directly is fastest.
+    static Json parse(const QByteArray & in,
+                      QString & err,
+                      JsonParse strategy = JsonParse::STANDARD);
     static Json parse(const QString & in,
                       QString & err,
                       JsonParse strategy = JsonParse::STANDARD);
@@ -188,7 +196,7 @@ public:
                       QString & err,
                       JsonParse strategy = JsonParse::STANDARD) {
         if (in) {
-            return parse(QString(in), err, strategy);
+            return parse(QByteArray(in), err, strategy);
         } else {
             err = "null input";
             return nullptr;
@@ -213,10 +221,12 @@ public:
         this->m_indent = 0;
     };
 
+    // The whole document is serialized into one UTF-8 buffer, then written with a single call.
     void dump(QFile *file) {
-        QTextStream fileStream(file);
-        fileStream << m_obj->dump(&m_indent);
-        fileStream << "\n"; // pad file with newline
+        QByteArray out;
+        m_obj->dump(out, m_indent);
+        out += '\n'; // pad file with newline
+        file->write(out);
     }
 
 private:
@@ -233,7 +243,7 @@ protected:
     virtual Json::Type type() const = 0;
     virtual bool equals(const JsonValue * other) const = 0;
     virtual bool less(const JsonValue * other) const = 0;
-    virtual void dump(QString &out, int *indent) const = 0;
+    virtual void dump(QByteArray &out, int indent, bool afterKey) const = 0;
     virtual double number_value() const;
     virtual int int_value() const;
     virtual bool bool_value() const;
@@ -8,6 +8,7 @@
 #include <QTextStream>
 #include <QString>
 #include <QDebug>
+#include <QElapsedTimer>
 
 enum LogType {
     LOG_ERROR,
@@ -22,5 +23,19 @@ void log(QString message, LogType type);
 QString getLogPath();
 QString getMostRecentError();
 bool cleanupLargeLog();
+void flushLog();
+void setLogStructured(bool structured);
+
+// Logs how long a scope took when it ends, e.g. "Loading project data took 250 ms".
+// In the structured log the duration is also recorded as a number.
+class LogTimer {
+public:
+    explicit LogTimer(const QString &name);
+    ~LogTimer();
+
+private:
+    QString name;
+    QElapsedTimer timer;
+};
 
 #endif // LOG_H
@@ -29,6 +29,8 @@
 #include "projectsettingseditor.h"
 #include "gridsettings.h"
 #include "customscriptseditor.h"
+#include "scriptstatsdialog.h"
+#include "validationreport.h"
 #include "wildmonchart.h"
 #include "updatepromoter.h"
 #include "aboutporymap.h"
@@ -187,9 +189,11 @@ private slots:
     void onOpenConnectedMap(MapConnection*);
     void onTilesetsSaved(QString, QString);
     void openNewMapPopupWindow();
+    void insertNewMapItems(Map *newMap, int newMapGroup, bool existingLayout);
     void onNewMapCreated();
     void onMapLoaded(Map *map);
     void importMapFromAdvanceMap1_92();
+    void importMapsFromAdvanceMap1_92Folder();
     void onMapRulerStatusChanged(const QString &);
     void applyUserShortcuts();
     void markMapEdited();
@@ -244,6 +248,7 @@ private slots:
     void on_actionExport_Stitched_Map_Image_triggered();
     void on_actionExport_Map_Timelapse_Image_triggered();
     void on_actionImport_Map_from_Advance_Map_1_92_triggered();
+    void on_actionImport_Maps_from_Advance_Map_1_92_Folder_triggered();
 
     void on_pushButton_AddConnection_clicked();
     void on_button_OpenDiveMap_clicked();
@@ -299,6 +304,8 @@ private slots:
     void togglePreferenceSpecificUi();
     void on_actionProject_Settings_triggered();
     void on_actionCustom_Scripts_triggered();
+    void on_actionScript_Callback_Stats_triggered();
+    void on_actionValidate_Project_triggered();
     void reloadScriptEngine();
     void on_actionShow_Grid_triggered();
     void on_actionGrid_Settings_triggered();
@@ -318,6 +325,8 @@ private:
     QPointer<ProjectSettingsEditor> projectSettingsEditor = nullptr;
     QPointer<GridSettingsDialog> gridSettingsDialog = nullptr;
     QPointer<CustomScriptsEditor> customScriptsEditor = nullptr;
+    QPointer<ScriptStatsDialog> scriptStatsDialog = nullptr;
+    QPointer<ValidationReport> validationReport = nullptr;
 
     QPointer<FilterChildrenProxyModel> groupListProxyModel = nullptr;
     QPointer<MapGroupModel> mapGroupModel = nullptr;
@@ -386,6 +395,7 @@ private:
     void clickToolButtonFromEditAction(Editor::EditAction editAction);
 
     void updateWindowTitle();
+    void updateMapTabIcon();
 
     void initWindow();
     void initCustomUI();
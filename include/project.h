@@ -9,6 +9,8 @@
 #include "parseutil.h"
 #include "orderedjson.h"
 #include "regionmap.h"
+#include "symboltable.h"
+#include "imagecache.h"
 
 #include <QStringList>
 #include <QList>
@@ -17,10 +19,13 @@
 #include <QStandardItem>
 #include <QVariant>
 #include <QFileSystemWatcher>
+#include <QFutureWatcher>
 
 // The displayed name of the special map value used by warps with multiple potential destinations
 static QString DYNAMIC_MAP_NAME = "Dynamic";
 
+class IdentifierListModel;
+
 class Project : public QObject
 {
     Q_OBJECT
@@ -49,8 +54,9 @@ public:
     QMap<QString, QString> layoutIdsToNames;
     QMap<QString, Layout*> mapLayouts;
     QMap<QString, Layout*> mapLayoutsMaster;
-    QMap<QString, EventGraphics*> eventGraphicsMap;
+    QHash<Symbol, EventGraphics*> eventGraphicsMap;
     QMap<QString, int> gfxDefines;
+    QStringList gfxDefineNames;
     QString defaultSong;
     QStringList songNames;
     QStringList itemNames;
@@ -71,7 +77,7 @@ public:
     QMap<QString, uint16_t> unusedMetatileLabels;
     QMap<QString, uint32_t> metatileBehaviorMap;
     QMap<uint32_t, QString> metatileBehaviorMapInverse;
-    QMap<QString, QString> facingDirections;
+    QHash<Symbol, QString> facingDirections;
     ParseUtil parser;
     QFileSystemWatcher fileWatcher;
     QMap<QString, qint64> modifiedFileTimestamps;
@@ -89,6 +95,8 @@ public:
     void clearTilesetCache();
     void clearMapLayouts();
     void clearEventGraphics();
+    bool requestEventSpritesheet(EventGraphics *eventGraphics);
+    void waitForEventSpritesheets();
 
     struct DataQualifiers
     {
@@ -114,6 +122,7 @@ public:
     QStringList tilesetLabelsOrdered;
 
     Blockdata readBlockdata(QString);
+    BlockdataView readBlockdataView(QString);
     bool loadBlockdata(Layout *);
     bool loadLayoutBorder(Layout *);
 
@@ -129,7 +138,16 @@ public:
     QString readMapLayoutId(QString map_name);
     QString readMapLocation(QString map_name);
 
+    void internIdentifiers();
+    // Returns a model of one of the lists above that can be shared by every widget that displays it.
+    IdentifierListModel *getIdentifierModel(const QStringList &list);
     bool readWildMonData();
+    // Encounter groups for each map, by base label. A map's groups are read from the wild encounters file
+    // the first time they're requested, maps that are never viewed or edited are saved back out unchanged.
+    bool hasWildMonData(const QString &mapConstant) const;
+    tsl::ordered_map<QString, WildPokemonHeader> &getWildMonData(const QString &mapConstant);
+    tsl::ordered_map<QString, WildPokemonHeader> readWildMonData(const QString &mapConstant) const;
+    void loadAllWildMonData();
     tsl::ordered_map<QString, tsl::ordered_map<QString, WildPokemonHeader>> wildMonData;
 
     QVector<EncounterField> wildMonFields;
@@ -158,6 +176,7 @@ public:
     void loadTilesetMetatiles(Tileset*);
     void loadTilesetMetatileLabels(Tileset*);
     void loadTilesetPalettes(Tileset*);
+    static QImage readTilesImage(const QString &path);
     void readTilesetPaths(Tileset* tileset);
 
     void saveLayout(Layout *);
@@ -256,6 +275,27 @@ private:
 
     void ignoreWatchedFileTemporarily(QString filepath);
 
+    QHash<const QStringList*, IdentifierListModel*> identifierModels;
+
+    // Event spritesheets are watched separately from the project's source files,
+    // because an edited spritesheet can be reloaded without reopening the project.
+    // Only spritesheets that have been loaded are watched, because each watched file can hold a file descriptor.
+    QFileSystemWatcher spritesheetWatcher;
+    QSet<QString> watchedSpritesheets;
+    void watchSpritesheet(const QString &filepath);
+    void reloadSpritesheet(const QString &filepath);
+
+    // The event spritesheets being decoded in the background, by filepath.
+    QHash<QString, QFutureWatcher<ImageCache::File>*> pendingSpritesheets;
+    bool loadSpritesheet(const QString &filepath);
+    void setSpritesheet(const QString &filepath, const QImage &spritesheet);
+
+    // The map encounter entries from the wild encounters file, and the indexes of each map's entries.
+    QVector<poryjson::Json> wildMonEntries;
+    QHash<QString, QVector<int>> wildMonEntryIndex;
+    WildPokemonHeader readWildMonHeader(const poryjson::Json &encounterObj) const;
+    void appendWildMonEntries(poryjson::Json::array *encounters, const QString &mapConstant, const tsl::ordered_map<QString, WildPokemonHeader> &groups) const;
+
     static int num_tiles_primary;
     static int num_tiles_total;
     static int num_metatiles_primary;
@@ -269,6 +309,7 @@ signals:
     void fileChanged(QString filepath);
     void mapSectionIdNamesChanged();
     void mapLoaded(Map *map);
+    void eventGraphicsChanged();
 };
 
 #endif // PROJECT_H
@@ -5,6 +5,8 @@
 #include "mainwindow.h"
 #include "block.h"
 #include "scriptutility.h"
+#include "imagecache.h"
+#include "scriptprofiler.h"
 
 #include <QStringList>
 #include <QJSEngine>
@@ -56,16 +58,18 @@ public:
     static Tile toTile(QJSValue obj);
     static QJSValue dimensions(int width, int height);
     static QJSValue position(int x, int y);
-    static const QImage * getImage(const QString &filepath, bool useCache);
+    static QImage getImage(const QString &filepath, bool useCache, const ImageCache::Transform &transform = ImageCache::Transform());
     static QJSValue dialogInput(QJSValue input, bool selectedOk);
+    static QList<ScriptProfiler::Stats> getCallbackStats();
+    static void resetCallbackStats();
 
 private:
     MainWindow *mainWindow;
     QJSEngine *engine;
     QStringList filepaths;
     QList<QJSValue> modules;
-    QMap<QString, const QImage*> imageCache;
     ScriptUtility *scriptUtility;
+    ScriptProfiler profiler;
 
     void loadModules(QStringList moduleFiles);
     void invokeCallback(CallbackType type, QJSValueList args);
@@ -0,0 +1,73 @@
+#pragma once
+#ifndef SCRIPTPROFILER_H
+#define SCRIPTPROFILER_H
+
+#include <QJSValue>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QTimer;
+
+// Times the callbacks run for each script module. A callback that goes over the time budget
+// (porymapConfig.scriptCallbackBudget) several calls in a row is throttled: frequent callbacks,
+// like the hover callbacks, are debounced so they only run once the mouse settles, and the others are disabled.
+// Throttled callbacks are reset when the scripts are reloaded, or with reset().
+class ScriptProfiler
+{
+public:
+    struct Stats {
+        QString module;
+        QString callback;
+        int calls = 0;
+        // Calls that didn't run because the callback was throttled.
+        int skipped = 0;
+        double totalMs = 0;
+        double maxMs = 0;
+        double p95Ms = 0;
+        bool debounced = false;
+        bool disabled = false;
+
+        double averageMs() const { return this->calls > 0 ? this->totalMs / this->calls : 0; }
+    };
+
+    ScriptProfiler() {}
+    ~ScriptProfiler();
+
+    void addModule(const QString &name);
+    // Calls 'function' for the module at 'moduleIndex', unless the callback is throttled.
+    // 'frequent' callbacks are debounced rather than disabled if they're too slow.
+    void invoke(int moduleIndex, const QString &callbackName, bool frequent, QJSValue function, const QJSValueList &args);
+
+    QList<Stats> getStats() const;
+    void reset();
+
+private:
+    struct Entry {
+        Stats stats;
+        // The most recent durations, for the 95th percentile.
+        QVector<double> recentMs;
+        int nextRecent = 0;
+        int overBudgetStreak = 0;
+    };
+
+    struct Module {
+        QString name;
+        QMap<QString, Entry> entries;
+        // A module's debounced callbacks share a single pending call, so they still run in the order they happened.
+        QTimer *debounceTimer = nullptr;
+        QString pendingCallback;
+        QJSValue pendingFunction;
+        QJSValueList pendingArgs;
+    };
+
+    QVector<Module> modules;
+
+    Entry &getEntry(int moduleIndex, const QString &callbackName);
+    void call(int moduleIndex, const QString &callbackName, bool frequent, QJSValue function, const QJSValueList &args);
+    void record(Entry *entry, double ms, bool frequent);
+    void debounce(int moduleIndex, const QString &callbackName, QJSValue function, const QJSValueList &args);
+};
+
+#endif // SCRIPTPROFILER_H
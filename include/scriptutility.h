@@ -3,6 +3,7 @@
 #define SCRIPTUTILITY_H
 
 #include "mainwindow.h"
+#include "scriptworker.h"
 
 class ScriptUtility : public QObject
 {
@@ -16,6 +17,9 @@ public:
     Q_INVOKABLE bool registerAction(QString functionName, QString actionName, QString shortcut = "");
     Q_INVOKABLE bool registerToggleAction(QString functionName, QString actionName, QString shortcut = "", bool checked = false);
     Q_INVOKABLE void setTimeout(QJSValue callback, int milliseconds);
+    Q_INVOKABLE int startWorker(QString filepath, QJSValue onMessages = QJSValue(), QJSValue onFinished = QJSValue());
+    Q_INVOKABLE void stopWorker(int workerId);
+    Q_INVOKABLE QJSValue getCallbackStats();
     Q_INVOKABLE void log(QString message);
     Q_INVOKABLE void warn(QString message);
     Q_INVOKABLE void error(QString message);
@@ -61,6 +65,8 @@ private:
     MainWindow *window;
     QList<QAction *> registeredActions;
     QSet<QTimer *> activeTimers;
+    QHash<int, ScriptWorker *> activeWorkers;
+    int nextWorkerId = 0;
     QHash<int, QString> actionMap;
 };
 
@@ -0,0 +1,88 @@
+#pragma once
+#ifndef SCRIPTWORKER_H
+#define SCRIPTWORKER_H
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QJSValue>
+#include <QMutex>
+#include <QThread>
+#include <QVariant>
+#include <functional>
+
+class Project;
+class QJSEngine;
+
+// Runs a script module on its own thread, in its own JS engine, so long project-wide scripts don't block the editor.
+// The module's exported 'main' function is called with no arguments. The worker can't touch the project directly:
+// it reads copies of project data through the global 'worker' object, which asks the GUI thread for them, and sends
+// results back with worker.postMessage. Messages are passed to the main script engine in batches.
+class ScriptWorker : public QThread
+{
+    Q_OBJECT
+
+public:
+    ScriptWorker(int id, const QString &filepath, Project *project, QJSValue onMessages, QJSValue onFinished);
+    ~ScriptWorker();
+
+    int getId() const { return this->id; }
+    void stop();
+    bool isStopping() const { return this->stopping.loadAcquire() != 0; }
+
+    // Called on the worker thread. Runs 'function' on the GUI thread and returns its result,
+    // or an invalid QVariant if the worker is stopped while waiting.
+    QVariant requestProjectData(std::function<QVariant(Project *)> function);
+    // Called on the worker thread.
+    void postMessage(const QVariant &message);
+
+signals:
+    void messagesPosted(QVariantList messages);
+
+protected:
+    void run() override;
+
+private:
+    const int id;
+    const QString filepath;
+    Project *project;
+    QJSValue onMessages;
+    QJSValue onFinished;
+
+    QAtomicInt stopping;
+    bool succeeded = false;
+    QMutex engineMutex;
+    QJSEngine *engine = nullptr;
+
+    // Only used on the worker thread.
+    QVariantList pendingMessages;
+    QElapsedTimer flushTimer;
+    void flushMessages();
+
+    void deliverMessages(const QVariantList &messages);
+};
+
+// The 'worker' object available to worker scripts. Everything it returns is a copy taken when it's called.
+class ScriptWorkerApi : public QObject
+{
+    Q_OBJECT
+
+public:
+    ScriptWorkerApi(ScriptWorker *worker) : worker(worker) {}
+
+    Q_INVOKABLE QList<QString> getMapNames();
+    Q_INVOKABLE QVariant getMap(QString mapName);
+    Q_INVOKABLE QList<QString> getLayoutIds();
+    Q_INVOKABLE QVariant getLayout(QString layoutId);
+    Q_INVOKABLE QList<QString> getTilesetNames();
+    Q_INVOKABLE QVariant getTileset(QString tilesetName);
+    Q_INVOKABLE void postMessage(QJSValue message);
+    Q_INVOKABLE bool isStopping();
+    Q_INVOKABLE void log(QString message);
+    Q_INVOKABLE void warn(QString message);
+    Q_INVOKABLE void error(QString message);
+
+private:
+    ScriptWorker *worker;
+};
+
+#endif // SCRIPTWORKER_H
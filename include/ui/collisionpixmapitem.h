@@ -29,6 +29,10 @@ public:
     virtual void pick(QGraphicsSceneMouseEvent*);
     void draw(bool ignoreCache = false);
 
+protected:
+    bool getChunkBlock(int x, int y, Block *block) const override;
+    void drawBlock(QImage *image, const QPoint &origin, const Block &block) override;
+
 private:
     unsigned actionId_ = 0;
     QPoint previousPos;
@@ -2,18 +2,55 @@
 #define FILTERCHILDRENPROXYMODEL_H
 
 #include <QSortFilterProxyModel>
+#include <QStandardItemModel>
+#include <QHash>
+#include <QSet>
+#include <QVector>
 
+// Filters the map list trees (map groups, areas and layouts). A row is shown if its text, its parent's text,
+// or any of its children's text fuzzily matches the filter. While filtering, the rows in each folder are ranked by how well they match.
+// The source model must be a QStandardItemModel.
 class FilterChildrenProxyModel : public QSortFilterProxyModel
 {
     Q_OBJECT
 
 public:
     explicit FilterChildrenProxyModel(QObject *parent = nullptr);
-    void setHideEmpty(bool hidden) { this->hideEmpty = hidden; }
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+    void setHideEmpty(bool hidden);
+    void setFilterText(const QString &text);
+
+    // Returns how well 'key' matches 'query' (both case-folded), or -1 if it doesn't match.
+    // Keys containing the query score higher than keys that only contain its characters in order.
+    static int matchScore(const QString &key, const QString &query);
+
 protected:
-    bool filterAcceptsRow(int source_row, const QModelIndex & source_parent) const;
+    bool filterAcceptsRow(int source_row, const QModelIndex & source_parent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
 private:
+    struct Entry {
+        const QStandardItem *item;
+        const QStandardItem *parent;
+        QString key;
+    };
+
     bool hideEmpty = false;
+    QString query;
+    QList<QMetaObject::Connection> sourceConnections;
+
+    // The text of every item in the source model, built when first needed and rebuilt when the source model changes.
+    mutable bool indexDirty = true;
+    mutable QVector<Entry> entries;
+    // The entries that match the current query, and their scores.
+    mutable QVector<int> matches;
+    mutable QHash<const QStandardItem *, int> scores;
+    // The items shown for the current query: the matches, their parents and their children.
+    mutable QSet<const QStandardItem *> accepted;
+
+    void buildIndex() const;
+    void updateMatches(const QVector<int> &candidates) const;
+    const QStandardItem *itemAt(int source_row, const QModelIndex &source_parent) const;
 };
 
 #endif // FILTERCHILDRENPROXYMODEL_H
@@ -0,0 +1,82 @@
+#pragma once
+#ifndef IDENTIFIERLISTMODEL_H
+#define IDENTIFIERLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QCompleter>
+#include <QHash>
+#include <QPointer>
+#include <QStringList>
+#include <QVector>
+
+// A read-only list model over one of the project's identifier lists (flags, vars, script labels, etc.).
+// One model is shared by every combo box and completer that offers that list, so showing an event frame
+// doesn't copy the list. The lookup and search indexes are only built the first time they're needed.
+class IdentifierListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit IdentifierListModel(QObject *parent = nullptr);
+
+    // Replaces the list. This is nearly free if 'strings' shares data with the current list.
+    void setStrings(const QStringList &strings);
+    const QStringList &strings() const { return this->m_strings; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // Returns the first row that exactly matches 'text', or -1.
+    int indexOf(const QString &text) const;
+    // Returns the rows that contain 'text' (case-insensitive), in order.
+    QVector<int> search(const QString &text) const;
+
+private:
+    QStringList m_strings;
+
+    mutable bool indexed = false;
+    mutable QStringList folded;
+    mutable QHash<QString, int> rows;
+    mutable QHash<quint64, QVector<int>> trigrams;
+
+    void buildIndex() const;
+    static quint64 trigramKey(const QChar *chars);
+};
+
+// The rows of an IdentifierListModel that contain the filter text.
+class IdentifierFilterModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit IdentifierFilterModel(IdentifierListModel *source, QObject *parent = nullptr);
+
+    void setFilterText(const QString &text);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    QPointer<IdentifierListModel> source;
+    QString filterText;
+    QVector<int> matches;
+
+    void refilter();
+};
+
+// A completer that suggests every identifier containing the typed text. Matching is done by an
+// IdentifierFilterModel rather than by QCompleter, which would scan the whole list for each key press.
+class IdentifierCompleter : public QCompleter
+{
+    Q_OBJECT
+
+public:
+    IdentifierCompleter(IdentifierListModel *model, QObject *parent = nullptr);
+
+    IdentifierFilterModel *filterModel() const { return this->m_filterModel; }
+
+private:
+    IdentifierFilterModel *m_filterModel;
+};
+
+#endif // IDENTIFIERLISTMODEL_H
@@ -8,6 +8,8 @@
 
 QImage getCollisionMetatileImage(Block);
 QImage getCollisionMetatileImage(int, int);
+void drawCollisionMetatile(QImage *dest, const QPoint &origin, int collision, int elevation);
+void blitImage(QImage *dest, const QPoint &origin, const QImage &source, const QRect &sourceRect);
 QImage getMetatileImage(uint16_t, Tileset*, Tileset*, QList<int>, QList<float>, bool useTruePalettes = false);
 QImage getMetatileImage(Metatile*, Tileset*, Tileset*, QList<int>, QList<float>, bool useTruePalettes = false);
 QImage getTileImage(uint16_t, Tileset*, Tileset*);
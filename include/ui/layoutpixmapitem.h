@@ -3,6 +3,7 @@
 
 #include "settings.h"
 #include "metatileselector.h"
+#include "chunkcache.h"
 #include <QGraphicsPixmapItem>
 
 class Layout;
@@ -10,19 +11,8 @@ class Layout;
 class LayoutPixmapItem : public QObject, public QGraphicsPixmapItem {
     Q_OBJECT
 
-private:
-    using QGraphicsPixmapItem::paint;
-
 public:
-    LayoutPixmapItem(Layout *layout, MetatileSelector *metatileSelector, Settings *settings) {
-        this->layout = layout;
-        // this->map->setMapItem(this);
-        this->metatileSelector = metatileSelector;
-        this->settings = settings;
-        this->lockedAxis = LayoutPixmapItem::Axis::None;
-        this->prevStraightPathState = false;
-        setAcceptHoverEvents(true);
-    }
+    LayoutPixmapItem(Layout *layout, MetatileSelector *metatileSelector, Settings *settings);
 
     Layout *layout;
 
@@ -81,6 +71,14 @@ public:
     void shift(int xDelta, int yDelta, bool fromScriptCall = false);
     virtual void draw(bool ignoreCache = false);
 
+    // The layout is rendered in chunks as they become visible, rather than as one pixmap.
+    QRectF boundingRect() const override;
+    QPainterPath shape() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+    // A small image of the whole layout, no larger than 'maxSize' pixels on either side (e.g. for icons).
+    // Layouts larger than 'maxSize' metatiles are sampled, so it costs about the same for any layout.
+    QImage thumbnail(int maxSize);
+
     void updateMetatileSelection(QGraphicsSceneMouseEvent *event);
     void paintNormal(int x, int y, bool fromScriptCall = false);
     void lockNondominantAxis(QGraphicsSceneMouseEvent *event);
@@ -89,7 +87,17 @@ public:
     void setEditsEnabled(bool enabled) { this->editsEnabled = enabled; }
     bool getEditsEnabled() { return this->editsEnabled; }
 
+protected:
+    ChunkCache chunks;
+    void redraw(bool ignoreCache);
+    // The block the chunk cache compares against to decide whether a position needs to be redrawn.
+    virtual bool getChunkBlock(int x, int y, Block *block) const;
+    virtual void drawBlock(QImage *image, const QPoint &origin, const Block &block);
+
 private:
+    QSize layoutSize;
+    QHash<uint16_t, QImage> metatileImageCache;
+
     void paintSmartPath(int x, int y, bool fromScriptCall = false);
     static QList<int> smartPathTable;
 
@@ -0,0 +1,33 @@
+#ifndef MAPBORDERITEM_H
+#define MAPBORDERITEM_H
+
+#include "chunkcache.h"
+#include <QGraphicsItem>
+#include <QHash>
+#include <QImage>
+
+class Layout;
+
+// Draws the layout's border blocks repeated around the outside of the map.
+// The repetitions are produced procedurally as they become visible, rather than as one pixmap item per repetition.
+class MapBorderItem : public QGraphicsItem
+{
+public:
+    MapBorderItem(Layout *layout);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+    void draw(bool ignoreCache = false);
+
+private:
+    Layout *layout;
+    QRect area; // The area covered by the border, in metatiles
+    ChunkCache chunks;
+    QHash<uint16_t, QImage> metatileImageCache;
+
+    bool getBlock(int x, int y, Block *block) const;
+    void drawBlock(QImage *image, const QPoint &origin, const Block &block);
+};
+
+#endif // MAPBORDERITEM_H
@@ -3,6 +3,7 @@
 
 #include "map.h"
 #include "editor.h"
+#include "mapimagerenderer.h"
 
 #include <QDialog>
 
@@ -16,24 +17,6 @@ enum ImageExporterMode {
     Timelapse,
 };
 
-struct ImageExporterSettings {
-    bool showObjects = false;
-    bool showWarps = false;
-    bool showBGs = false;
-    bool showTriggers = false;
-    bool showHealLocations = false;
-    bool showUpConnections = false;
-    bool showDownConnections = false;
-    bool showLeftConnections = false;
-    bool showRightConnections = false;
-    bool showGrid = false;
-    bool showBorder = false;
-    bool showCollision = false;
-    bool previewActualSize = false;
-    int timelapseSkipAmount = 1;
-    int timelapseDelayMs = 200;
-};
-
 class MapImageExporter : public QDialog
 {
     Q_OBJECT
@@ -59,8 +42,9 @@ private:
     void scalePreview();
     void updateShowBorderState();
     void saveImage();
-    QPixmap getStitchedImage(QProgressDialog *progress, bool includeBorder);
-    QPixmap getFormattedMapPixmap(Map *map, bool ignoreBorder = false);
+    MapImageRenderer getRenderer() const;
+    QPixmap getStitchedImage(QProgressDialog *progress);
+    QPixmap getFormattedMapPixmap(Map *map);
     bool historyItemAppliesToFrame(const QUndoCommand *command);
 
 protected:
@@ -69,6 +69,10 @@ public:
     virtual void removeItemAt(const QModelIndex &index);
     virtual QStandardItem *getItem(const QModelIndex &index) const = 0;
 
+    // Notify views that the icons of these items need to be redrawn.
+    void updateItemIcon(const QString &id);
+    void updateItemIcons(const QStringList &ids);
+
 protected:
     virtual void removeItem(QStandardItem *item) = 0;
 };
@@ -90,7 +94,7 @@ public:
     virtual bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
 
 public:
-    void setMap(QString mapName) { this->openMap = mapName; }
+    void setMap(QString mapName);
 
     QStandardItem *createGroupItem(QString groupName, int groupIndex, QStandardItem *fromItem = nullptr);
     QStandardItem *createMapItem(QString mapName, QStandardItem *fromItem = nullptr);
@@ -135,7 +139,7 @@ public:
     QVariant data(const QModelIndex &index, int role) const override;
 
 public:
-    void setMap(QString mapName) { this->openMap = mapName; }
+    void setMap(QString mapName);
 
     QStandardItem *createAreaItem(QString areaName);
     QStandardItem *createMapItem(QString mapName, int areaIndex, int mapIndex);
@@ -176,7 +180,7 @@ public:
     QVariant data(const QModelIndex &index, int role) const override;
 
 public:
-    void setLayout(QString layoutId) { this->openLayout = layoutId; }
+    void setLayout(QString layoutId);
 
     QStandardItem *createLayoutItem(QString layoutId);
     QStandardItem *createMapItem(QString mapName);
@@ -69,9 +69,15 @@ public:
     Q_INVOKABLE void addTileImage(int x, int y, int tileId, bool xflip, bool yflip, int paletteId, bool setTransparency = false, int layer = 0);
     Q_INVOKABLE void addTileImage(int x, int y, QJSValue tileObj, bool setTransparency = false, int layer = 0);
     Q_INVOKABLE void addMetatileImage(int x, int y, int metatileId, bool setTransparency = false, int layer = 0);
+    Q_INVOKABLE void addTexts(QJSValue textObjs, int layer = 0);
+    Q_INVOKABLE void addTileImages(QJSValue tileObjs, bool setTransparency = false, int layer = 0);
+    Q_INVOKABLE void addMetatileImages(QJSValue metatileObjs, bool setTransparency = false, int layer = 0);
+    Q_INVOKABLE double getRenderTime(int layer = 0);
 
 private:
     QMap<int, Overlay*> overlayMap;
+    void updateOverlayItems(int layer);
+    bool hasOverlayTilesets();
 protected:
     virtual void drawForeground(QPainter *painter, const QRectF &rect) override;
     virtual void keyPressEvent(QKeyEvent*) override;
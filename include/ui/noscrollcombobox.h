@@ -2,6 +2,10 @@
 #define NOSCROLLCOMBOBOX_H
 
 #include <QComboBox>
+#include <QPointer>
+
+class IdentifierListModel;
+class IdentifierCompleter;
 
 class NoScrollComboBox : public QComboBox
 {
@@ -17,11 +21,16 @@ public:
     void setEditable(bool editable);
     void setLineEdit(QLineEdit *edit);
     void setFocusedScrollingEnabled(bool enabled);
+    void setSharedModel(IdentifierListModel *model);
+    void setSharedCompleterModel(IdentifierListModel *model);
 
 private:
     void setItem(int index, const QString &text);
 
     bool focusedScrollingEnabled = true;
+    QPointer<IdentifierListModel> sharedModel;
+    QPointer<IdentifierCompleter> sharedCompleter;
+    QString textBeforeReset;
 };
 
 #endif // NOSCROLLCOMBOBOX_H
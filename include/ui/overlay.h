@@ -7,12 +7,15 @@
 #include <QPainter>
 #include <QStaticText>
 #include <QPainterPath>
+#include <QPixmap>
 
 class OverlayItem {
 public:
     OverlayItem() {}
     virtual ~OverlayItem() {};
     virtual void render(QPainter *) {};
+    // The area drawn by the item, in the overlay's coordinates.
+    virtual QRectF boundingRect() const { return QRectF(); }
 };
 
 class OverlayText : public OverlayItem {
@@ -27,6 +30,7 @@ public:
     }
     ~OverlayText() {}
     virtual void render(QPainter *painter);
+    virtual QRectF boundingRect() const;
 private:
     const QStaticText text;
     int x;
@@ -44,6 +48,7 @@ public:
     }
     ~OverlayPath() {}
     virtual void render(QPainter *painter);
+    virtual QRectF boundingRect() const;
 private:
     QPainterPath path;
     QColor borderColor;
@@ -59,6 +64,7 @@ public:
     }
     ~OverlayPixmap() {}
     virtual void render(QPainter *painter);
+    virtual QRectF boundingRect() const;
 private:
     int x;
     int y;
@@ -77,6 +83,9 @@ public:
         this->hidden = false;
         this->opacity = 1.0;
         this->clippingRect = nullptr;
+        this->cacheValid = false;
+        this->cacheScale = 0;
+        this->renderTime = 0;
     }
     ~Overlay() {
         this->clearItems();
@@ -102,16 +111,22 @@ public:
     void setPosition(int x, int y);
     void move(int deltaX, int deltaY);
     void renderItems(QPainter *painter);
+    double getRenderTime();
+    QRectF takeChangedRect();
     QList<OverlayItem*> getItems();
     void clearItems();
     void addText(const QString text, int x, int y, QString colorStr, int fontSize);
     bool addRect(int x, int y, int width, int height, QString borderColorStr, QString fillColorStr, int rounding);
     bool addImage(int x, int y, QString filepath, bool useCache = true, int width = -1, int height = -1, int xOffset = 0, int yOffset = 0, qreal hScale = 1, qreal vScale = 1, QList<QRgb> palette = QList<QRgb>(), bool setTransparency = false);
     bool addImage(int x, int y, QImage image);
+    bool addImage(int x, int y, QPixmap pixmap);
     bool addPath(QList<int> xCoords, QList<int> yCoords, QString borderColorStr, QString fillColorStr);
 private:
     void clampAngle();
     QColor getColor(QString colorStr);
+    void addItem(OverlayItem *item);
+    bool updateCache(qreal scale);
+    QTransform getTransform();
     QList<OverlayItem*> items;
     int x;
     int y;
@@ -121,6 +136,18 @@ private:
     bool hidden;
     qreal opacity;
     QRectF *clippingRect;
+
+    // The items are drawn once into 'cache' (at the map view's zoom level), which is
+    // then drawn with the layer's transformations until the items or the zoom level change.
+    QPixmap cache;
+    QRectF cacheRect;
+    qreal cacheScale;
+    bool cacheValid;
+    // The area covered by all items, and by the items added since the last call to takeChangedRect.
+    QRectF itemsRect;
+    QRectF changedRect;
+    // The time in milliseconds it took to draw this layer the last time it was drawn.
+    double renderTime;
 };
 
 #endif // OVERLAY_H
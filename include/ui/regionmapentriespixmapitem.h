@@ -3,11 +3,12 @@
 
 #include "tilemaptileselector.h"
 #include "regionmap.h"
+#include "regionmaprenderer.h"
 
 class RegionMapEntriesPixmapItem : public SelectablePixmapItem {
     Q_OBJECT
 public:
-    RegionMapEntriesPixmapItem(RegionMap *rm, TilemapTileSelector *ts) : SelectablePixmapItem(8, 8, 1, 1) {
+    RegionMapEntriesPixmapItem(RegionMap *rm, TilemapTileSelector *ts) : SelectablePixmapItem(8, 8, 1, 1), renderer(rm, ts) {
             this->region_map = rm;
             this->tile_selector = ts;
     }
@@ -24,6 +25,7 @@ public:
     bool draggingEntry = false;
 
 private:
+    RegionMapRenderer renderer;
     void updateSelectedTile();
 
 signals:
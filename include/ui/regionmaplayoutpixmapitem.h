@@ -3,11 +3,12 @@
 
 #include "tilemaptileselector.h"
 #include "regionmap.h"
+#include "regionmaprenderer.h"
 
 class RegionMapLayoutPixmapItem : public SelectablePixmapItem {
     Q_OBJECT
 public:
-    RegionMapLayoutPixmapItem(RegionMap *rmap, TilemapTileSelector *ts) : SelectablePixmapItem(8, 8, 1, 1) {
+    RegionMapLayoutPixmapItem(RegionMap *rmap, TilemapTileSelector *ts) : SelectablePixmapItem(8, 8, 1, 1), renderer(rmap, ts) {
             this->region_map = rmap;
             this->tile_selector = ts;
             setAcceptHoverEvents(true);
@@ -22,6 +23,7 @@ public:
     void highlight(int, int, int);
 
 private:
+    RegionMapRenderer renderer;
     void updateSelectedTile();
 
 signals:
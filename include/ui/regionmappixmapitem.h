@@ -3,6 +3,7 @@
 
 #include "regionmap.h"
 #include "tilemaptileselector.h"
+#include "regionmaprenderer.h"
 #include <QGraphicsPixmapItem>
 
 class RegionMapPixmapItem : public QObject, public QGraphicsPixmapItem {
@@ -12,7 +13,7 @@ private:
     using QGraphicsPixmapItem::paint;
 
 public:
-    RegionMapPixmapItem(RegionMap *rmap, TilemapTileSelector *tile_selector) {
+    RegionMapPixmapItem(RegionMap *rmap, TilemapTileSelector *tile_selector) : renderer(rmap, tile_selector) {
         this->region_map = rmap;
         this->tile_selector = tile_selector;
         setAcceptHoverEvents(true);
@@ -26,6 +27,9 @@ public:
     virtual void draw();
     void floodFill(int x, int y, std::shared_ptr<TilemapTile> oldTile, std::shared_ptr<TilemapTile> newTile);
 
+private:
+    RegionMapRenderer renderer;
+
 signals:
     void mouseEvent(QGraphicsSceneMouseEvent *, RegionMapPixmapItem *);
     void hoveredRegionMapTileChanged(int x, int y);
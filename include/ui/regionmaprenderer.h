@@ -0,0 +1,39 @@
+#ifndef REGIONMAPRENDERER_H
+#define REGIONMAPRENDERER_H
+
+#include "regionmap.h"
+#include "tilemaptileselector.h"
+
+#include <QHash>
+#include <QImage>
+#include <QVector>
+#include <functional>
+
+// Draws a region map's tilemap, optionally with a translucent color over each tile, into an image that's kept between draws.
+// Each render only redraws the tiles whose tile data or overlay color changed since the last one, so editing
+// a few tiles (or undoing an edit) doesn't redraw the whole map. The image of each distinct tile is only made once.
+// The tile images are never remade, so a renderer must not outlive its tile selector; the region map editor
+// makes new pixmap items (and so new renderers) whenever it loads a new tileset or palette.
+class RegionMapRenderer
+{
+public:
+    RegionMapRenderer(RegionMap *regionMap, TilemapTileSelector *tileSelector)
+        : regionMap(regionMap), tileSelector(tileSelector) {}
+
+    // 'overlay' returns the color drawn over the tile at each tilemap index. Its alpha is the overlay's opacity.
+    const QImage &render(std::function<QRgb(int index)> overlay = nullptr);
+
+private:
+    RegionMap *regionMap;
+    TilemapTileSelector *tileSelector;
+
+    QImage image;
+    // The tile data and overlay color last drawn at each tilemap index.
+    QVector<quint64> drawnTiles;
+    // Tile images by their raw tile data.
+    QHash<unsigned, QImage> tileImages;
+
+    const QImage &getTileImage(shared_ptr<TilemapTile> tile);
+};
+
+#endif // REGIONMAPRENDERER_H
@@ -0,0 +1,27 @@
+#ifndef SCRIPTSTATSDIALOG_H
+#define SCRIPTSTATSDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QTimer>
+
+// Shows how long each custom script's callbacks are taking, refreshed while it's open.
+class ScriptStatsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ScriptStatsDialog(QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    QTableWidget *table;
+    QTimer refreshTimer;
+
+    void refresh();
+};
+
+#endif // SCRIPTSTATSDIALOG_H
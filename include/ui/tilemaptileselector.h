@@ -5,7 +5,9 @@
 #include "selectablepixmapitem.h"
 #include "paletteutil.h"
 #include "imageproviders.h"
+#include "imagecache.h"
 
+#include <QHash>
 #include <memory>
 using std::shared_ptr;
 
@@ -125,7 +127,7 @@ class TilemapTileSelector: public SelectablePixmapItem {
     Q_OBJECT
 public:
     TilemapTileSelector(QString tilesetFilepath, TilemapFormat format, QString palFilepath): SelectablePixmapItem(8, 8, 1, 1) {
-        this->tileset = QImage(tilesetFilepath);
+        this->tileset = ImageCache::get(tilesetFilepath);
         this->format = format;
         if (this->tileset.format() == QImage::Format::Format_Indexed8 && this->format == TilemapFormat::BPP_4) {
             flattenTo4bppImage(&this->tileset);
@@ -175,6 +177,7 @@ protected:
 private:
     int numTilesWide;
     size_t numTiles;
+    QHash<int, QImage> palettedTilesets;
     void updateSelectedTile();
     unsigned getTileId(int x, int y);
     QPoint getTileIdCoords(unsigned);
@@ -0,0 +1,33 @@
+#ifndef VALIDATIONREPORT_H
+#define VALIDATIONREPORT_H
+
+#include "projectvalidator.h"
+
+#include <QDialog>
+#include <QLabel>
+#include <QTableWidget>
+
+// Lists the problems the ProjectValidator found. Double-clicking a problem jumps to where it is.
+class ValidationReport : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ValidationReport(Project *project, QWidget *parent = nullptr);
+
+    void validateAll();
+    void revalidateMap(const QString &mapName);
+
+signals:
+    void jumpTo(const ValidationIssue &issue);
+
+private:
+    ProjectValidator validator;
+    QList<ValidationIssue> issues;
+    QTableWidget *table;
+    QLabel *summaryLabel;
+
+    void refresh();
+};
+
+#endif // VALIDATIONREPORT_H
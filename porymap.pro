@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui qml network
+QT       += core gui qml network concurrent
 
 !win32 {
     QT += charts
@@ -24,21 +24,29 @@ DEFINES += PORYMAP_VERSION=\\\"$$VERSION\\\"
 SOURCES += src/core/block.cpp \
     src/core/bitpacker.cpp \
     src/core/blockdata.cpp \
+    src/core/chunkcache.cpp \
     src/core/events.cpp \
     src/core/filedialog.cpp \
     src/core/heallocation.cpp \
+    src/core/imagecache.cpp \
     src/core/imageexport.cpp \
+    src/core/indexedpng.cpp \
     src/core/map.cpp \
     src/core/mapconnection.cpp \
+    src/core/mapimagerenderer.cpp \
     src/core/maplayout.cpp \
     src/core/mapparser.cpp \
     src/core/metatile.cpp \
     src/core/metatileparser.cpp \
     src/core/network.cpp \
+    src/core/palettetable.cpp \
     src/core/paletteutil.cpp \
     src/core/parseutil.cpp \
+    src/core/projectvalidator.cpp \
+    src/core/symboltable.cpp \
     src/core/tile.cpp \
     src/core/tileset.cpp \
+    src/core/tracer.cpp \
     src/core/regionmap.cpp \
     src/core/wildmoninfo.cpp \
     src/core/editcommands.cpp \
@@ -50,6 +58,8 @@ SOURCES += src/core/block.cpp \
     src/scriptapi/apioverlay.cpp \
     src/scriptapi/apiutility.cpp \
     src/scriptapi/scripting.cpp \
+    src/scriptapi/scriptprofiler.cpp \
+    src/scriptapi/scriptworker.cpp \
     src/ui/aboutporymap.cpp \
     src/ui/colorinputwidget.cpp \
     src/ui/connectionslistitem.cpp \
@@ -76,10 +86,13 @@ SOURCES += src/core/block.cpp \
     src/ui/maplistmodels.cpp \
     src/ui/maplisttoolbar.cpp \
     src/ui/graphicsview.cpp \
+    src/ui/identifierlistmodel.cpp \
     src/ui/imageproviders.cpp \
     src/ui/layoutpixmapitem.cpp \
+    src/ui/mapborderitem.cpp \
     src/ui/prefabcreationdialog.cpp \
     src/ui/regionmappixmapitem.cpp \
+    src/ui/regionmaprenderer.cpp \
     src/ui/citymappixmapitem.cpp \
     src/ui/metatilelayersitem.cpp \
     src/ui/metatileselector.cpp \
@@ -92,6 +105,8 @@ SOURCES += src/core/block.cpp \
     src/ui/encountertablemodel.cpp \
     src/ui/encountertabledelegates.cpp \
     src/ui/paletteeditor.cpp \
+    src/ui/scriptstatsdialog.cpp \
+    src/ui/validationreport.cpp \
     src/ui/selectablepixmapitem.cpp \
     src/ui/tileseteditor.cpp \
     src/ui/tileseteditormetatileselector.cpp \
@@ -110,6 +125,7 @@ SOURCES += src/core/block.cpp \
     src/ui/preferenceeditor.cpp \
     src/ui/regionmappropertiesdialog.cpp \
     src/ui/colorpicker.cpp \
+    src/commandline.cpp \
     src/config.cpp \
     src/editor.cpp \
     src/main.cpp \
@@ -124,22 +140,30 @@ SOURCES += src/core/block.cpp \
 HEADERS  += include/core/block.h \
     include/core/bitpacker.h \
     include/core/blockdata.h \
+    include/core/chunkcache.h \
     include/core/events.h \
     include/core/filedialog.h \
     include/core/heallocation.h \
     include/core/history.h \
+    include/core/imagecache.h \
     include/core/imageexport.h \
+    include/core/indexedpng.h \
     include/core/map.h \
     include/core/mapconnection.h \
+    include/core/mapimagerenderer.h \
     include/core/maplayout.h \
     include/core/mapparser.h \
     include/core/metatile.h \
     include/core/metatileparser.h \
     include/core/network.h \
+    include/core/palettetable.h \
     include/core/paletteutil.h \
     include/core/parseutil.h \
+    include/core/projectvalidator.h \
+    include/core/symboltable.h \
     include/core/tile.h \
     include/core/tileset.h \
+    include/core/tracer.h \
     include/core/regionmap.h \
     include/core/wildmoninfo.h \
     include/core/editcommands.h \
@@ -175,11 +199,14 @@ HEADERS  += include/core/block.h \
     include/ui/maplistmodels.h \
     include/ui/maplisttoolbar.h \
     include/ui/graphicsview.h \
+    include/ui/identifierlistmodel.h \
     include/ui/imageproviders.h \
     include/ui/layoutpixmapitem.h \
+    include/ui/mapborderitem.h \
     include/ui/mapview.h \
     include/ui/prefabcreationdialog.h \
     include/ui/regionmappixmapitem.h \
+    include/ui/regionmaprenderer.h \
     include/ui/citymappixmapitem.h \
     include/ui/colorinputwidget.h \
     include/ui/metatilelayersitem.h \
@@ -194,6 +221,8 @@ HEADERS  += include/core/block.h \
     include/ui/encountertabledelegates.h \
     include/ui/adjustingstackedwidget.h \
     include/ui/paletteeditor.h \
+    include/ui/scriptstatsdialog.h \
+    include/ui/validationreport.h \
     include/ui/selectablepixmapitem.h \
     include/ui/tileseteditor.h \
     include/ui/tileseteditormetatileselector.h \
@@ -213,12 +242,15 @@ HEADERS  += include/core/block.h \
     include/ui/preferenceeditor.h \
     include/ui/regionmappropertiesdialog.h \
     include/ui/colorpicker.h \
+    include/commandline.h \
     include/config.h \
     include/editor.h \
     include/mainwindow.h \
     include/project.h \
     include/scripting.h \
+    include/scriptprofiler.h \
     include/scriptutility.h \
+    include/scriptworker.h \
     include/settings.h \
     include/log.h \
     include/ui/uintspinbox.h \
@@ -0,0 +1,759 @@
+#include "commandline.h"
+#include "config.h"
+#include "project.h"
+#include "map.h"
+#include "mapconnection.h"
+#include "events.h"
+#include "imagecache.h"
+#include "log.h"
+#include "tracer.h"
+#include "tileset.h"
+#include "imageproviders.h"
+#include "orderedjson.h"
+#include "projectvalidator.h"
+#include "editcommands.h"
+#include "mapimagerenderer.h"
+#include "layoutpixmapitem.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+static const QStringList commands = {
+    "export-map",
+    "export-stitched",
+    "validate",
+    "resave",
+    "dump-stats",
+    "benchmark",
+};
+
+struct Options {
+    QString command;
+    QString projectDir;
+    QStringList mapNames;
+    QString outputDir;
+    // What's drawn on exported maps, like the options of the map image exporter.
+    ImageExporterSettings imageSettings;
+    int iterations = 3;
+    // The project generated for the benchmark command. Nothing is generated if there are no maps.
+    struct {
+        int mapCount = 0;
+        QSize mapSize = QSize(64, 64);
+        int tilesetCount = 2;
+        int eventCount = 32;
+    } synthetic;
+};
+
+static QTextStream &out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+bool CommandLine::isCommand(int argc, char *argv[]) {
+    return argc > 1 && commands.contains(QString::fromLocal8Bit(argv[1]));
+}
+
+void CommandLine::prepare() {
+    // The maps are drawn with QPixmap, which needs a GUI application, but not a display.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+}
+
+static Project *openProject(const QString &dir) {
+    if (!QDir(dir).exists()) {
+        logError(QString("Failed to open project '%1': No such directory").arg(dir));
+        return nullptr;
+    }
+    logInfo(QString("Opening project '%1'").arg(QDir::toNativeSeparators(dir)));
+
+    userConfig.projectDir = dir;
+    userConfig.load();
+    projectConfig.projectDir = dir;
+    projectConfig.load();
+
+    auto project = new Project;
+    project->set_root(dir);
+    MapConnection::project = project;
+    if (!project->sanityCheck()) {
+        logError(QString("The directory '%1' failed the project sanity check.").arg(dir));
+        delete project;
+        return nullptr;
+    }
+    if (!project->load()) {
+        logError(QString("Failed to open project '%1'").arg(dir));
+        delete project;
+        return nullptr;
+    }
+    Event::setIcons();
+    return project;
+}
+
+// Draws the map, or the map together with every map reachable through its connections, like the map image exporter does.
+static QImage renderMap(Project *project, Map *map, const Options &options, bool stitched) {
+    MapImageRenderer renderer(project, options.imageSettings, stitched ? STITCH_MODE_BORDER_DISTANCE : BORDER_DISTANCE);
+    const QPixmap pixmap = stitched ? renderer.renderStitched(map) : renderer.render(map, nullptr);
+    return pixmap.toImage();
+}
+
+// Maps are loaded and drawn on the main thread, because the project and QPixmap aren't thread-safe,
+// but the images are encoded and written on the thread pool while the next maps are drawn.
+static int exportMaps(Project *project, const Options &options, bool stitched) {
+    QStringList mapNames = options.mapNames;
+    if (mapNames.isEmpty()) {
+        if (stitched) {
+            logError("export-stitched needs the name of the map to start from.");
+            return 1;
+        }
+        mapNames = project->mapNames;
+    }
+
+    const QString outputDir = options.outputDir.isEmpty() ? QDir::currentPath() : options.outputDir;
+    if (!QDir().mkpath(outputDir)) {
+        logError(QString("Failed to create output folder '%1'").arg(outputDir));
+        return 1;
+    }
+
+    int numFailed = 0;
+    QList<QFuture<bool>> writes;
+    auto finishWrite = [&writes, &numFailed] {
+        if (!writes.takeFirst().result())
+            numFailed++;
+    };
+    for (const QString &mapName : mapNames) {
+        Map *map = project->getMap(mapName);
+        if (!map) {
+            logError(QString("Failed to load map '%1'").arg(mapName));
+            numFailed++;
+            continue;
+        }
+        const QImage image = renderMap(project, map, options, stitched);
+        const QString filepath = QDir(outputDir).filePath(mapName + (stitched ? "_stitched.png" : ".png"));
+
+        // Don't let the drawn images pile up faster than they can be written.
+        while (writes.size() >= QThreadPool::globalInstance()->maxThreadCount() * 2)
+            finishWrite();
+        writes.append(QtConcurrent::run([image, filepath] {
+            if (image.save(filepath, "PNG"))
+                return true;
+            logError(QString("Failed to write image '%1'").arg(filepath));
+            return false;
+        }));
+    }
+    while (!writes.isEmpty())
+        finishWrite();
+
+    out() << QString("Exported %1 of %2 maps to %3\n").arg(mapNames.size() - numFailed).arg(mapNames.size()).arg(QDir::toNativeSeparators(outputDir));
+    return numFailed ? 1 : 0;
+}
+
+static int validate(Project *project) {
+    ProjectValidator validator(project);
+    validator.validateAll();
+    const QList<ValidationIssue> issues = validator.getIssues();
+    int numErrors = 0;
+    for (const ValidationIssue &issue : issues) {
+        const bool isError = issue.severity == ValidationIssue::Severity::Error;
+        if (isError) numErrors++;
+        out() << QString("%1: %2: [%3] %4\n").arg(isError ? "error" : "warning").arg(issue.location()).arg(issue.rule).arg(issue.message);
+    }
+    out() << QString("Checked %1 layouts and %2 maps, found %3 errors and %4 warnings\n")
+                .arg(project->mapLayoutsTable.size()).arg(project->mapNames.size()).arg(numErrors).arg(issues.size() - numErrors);
+    return numErrors ? 1 : 0;
+}
+
+static int resave(Project *project) {
+    int numFailed = 0;
+    for (const QString &mapName : project->mapNames) {
+        Map *map = project->getMap(mapName);
+        if (!map) {
+            logError(QString("Failed to load map '%1'").arg(mapName));
+            numFailed++;
+            continue;
+        }
+        project->saveMap(map);
+    }
+    // Layouts that aren't used by any map are saved as well.
+    for (const QString &layoutId : project->mapLayoutsTable) {
+        Layout *layout = project->loadLayout(layoutId);
+        if (layout)
+            project->saveLayout(layout);
+    }
+    project->saveAllDataStructures();
+    out() << QString("Saved %1 of %2 maps\n").arg(project->mapNames.size() - numFailed).arg(project->mapNames.size());
+    return numFailed ? 1 : 0;
+}
+
+static int dumpStats(Project *project) {
+    QJsonObject stats;
+    stats["map_groups"] = project->groupNames.size();
+    stats["maps"] = project->mapNames.size();
+    stats["layouts"] = project->mapLayoutsTable.size();
+    stats["primary_tilesets"] = project->primaryTilesetLabels.size();
+    stats["secondary_tilesets"] = project->secondaryTilesetLabels.size();
+    stats["event_graphics"] = project->eventGraphicsMap.size();
+
+    int numFailed = 0;
+    qint64 numMetatiles = 0;
+    QMap<Event::Group, int> eventCounts;
+    for (const QString &mapName : project->mapNames) {
+        Map *map = project->getMap(mapName);
+        if (!map) {
+            numFailed++;
+            continue;
+        }
+        numMetatiles += static_cast<qint64>(map->getWidth()) * map->getHeight();
+        for (const Event *event : map->getAllEvents())
+            eventCounts[event->getEventGroup()]++;
+    }
+    QJsonObject events;
+    for (auto it = eventCounts.constBegin(); it != eventCounts.constEnd(); it++)
+        events[Event::eventGroupToString(it.key())] = it.value();
+    stats["events"] = events;
+    stats["map_metatiles"] = numMetatiles;
+    stats["maps_failed_to_load"] = numFailed;
+
+    out() << QJsonDocument(stats).toJson(QJsonDocument::Indented);
+    return numFailed ? 1 : 0;
+}
+
+// Times a function over several iterations, after one untimed run to warm up any caches.
+static QJsonObject benchmark(const QString &name, int iterations, std::function<void()> function) {
+    function();
+    QVector<qint64> times;
+    QElapsedTimer timer;
+    for (int i = 0; i < iterations; i++) {
+        timer.start();
+        function();
+        times.append(timer.nsecsElapsed() / 1000);
+    }
+    std::sort(times.begin(), times.end());
+    qint64 total = 0;
+    for (qint64 time : times)
+        total += time;
+
+    QJsonObject result;
+    result["name"] = name;
+    result["iterations"] = iterations;
+    result["min_us"] = times.first();
+    result["median_us"] = times.at(times.size() / 2);
+    result["mean_us"] = total / times.size();
+    result["max_us"] = times.last();
+    logInfo(QString("Benchmark %1: median %2 ms").arg(name).arg(times.at(times.size() / 2) / 1000.0, 0, 'f', 3));
+    return result;
+}
+
+// Makes a tileset of random tiles, palettes and metatiles, with as many tiles and metatiles as the project allows.
+static Tileset *generateTileset(const QString &name, bool isSecondary, QRandomGenerator *random) {
+    auto tileset = new Tileset;
+    tileset->name = name;
+    tileset->is_secondary = isSecondary;
+    tileset->hasUnsavedTilesImage = false;
+
+    const int numTiles = isSecondary ? Project::getNumTilesTotal() - Project::getNumTilesPrimary() : Project::getNumTilesPrimary();
+    for (int i = 0; i < numTiles; i++) {
+        QImage tile(8, 8, QImage::Format_Indexed8);
+        tile.setColorTable(greyscalePalette.toVector());
+        for (int y = 0; y < 8; y++)
+        for (int x = 0; x < 8; x++)
+            tile.setPixel(x, y, random->bounded(16));
+        tileset->tiles.append(tile);
+    }
+
+    for (int i = 0; i < Project::getNumPalettesTotal(); i++) {
+        QList<QRgb> palette;
+        for (int j = 0; j < 16; j++)
+            palette.append(qRgb(random->bounded(256), random->bounded(256), random->bounded(256)));
+        tileset->palettes.append(palette);
+    }
+    tileset->palettePreviews = tileset->palettes;
+
+    const int numMetatiles = isSecondary ? Project::getNumMetatilesTotal() - Project::getNumMetatilesPrimary() : Project::getNumMetatilesPrimary();
+    QList<Metatile *> metatiles;
+    for (int i = 0; i < numMetatiles; i++) {
+        auto metatile = new Metatile(projectConfig.getNumTilesInMetatile());
+        for (Tile &tile : metatile->tiles)
+            tile = Tile(random->bounded(Project::getNumTilesTotal()), random->bounded(2), random->bounded(2), random->bounded(Project::getNumPalettesTotal()));
+        metatile->setLayerType(random->bounded(static_cast<int>(NUM_METATILE_LAYER_TYPES)));
+        metatiles.append(metatile);
+    }
+    tileset->setMetatiles(metatiles);
+    return tileset;
+}
+
+// Generates the maps, layouts and tilesets described by the synthetic options, and adds them to the project's caches,
+// which own them from then on. Nothing is written to the project's files. The maps are laid out in a grid with
+// connections between neighbors, and the same options always generate the same project.
+static QList<Map *> generateSyntheticMaps(Project *project, const Options &options) {
+    QRandomGenerator random(1);
+    QList<Map *> maps;
+
+    QList<QPair<Tileset *, Tileset *>> tilesets;
+    for (int i = 0; i < options.synthetic.tilesetCount; i++) {
+        Tileset *primary = generateTileset(QString("gTileset_SyntheticPrimary%1").arg(i), false, &random);
+        Tileset *secondary = generateTileset(QString("gTileset_SyntheticSecondary%1").arg(i), true, &random);
+        project->tilesetCache.insert(primary->name, primary);
+        project->tilesetCache.insert(secondary->name, secondary);
+        tilesets.append(qMakePair(primary, secondary));
+    }
+
+    const QList<Event::Type> eventTypes = {
+        Event::Type::Object,
+        Event::Type::Warp,
+        Event::Type::Trigger,
+        Event::Type::Sign,
+    };
+    const int width = options.synthetic.mapSize.width();
+    const int height = options.synthetic.mapSize.height();
+    for (int i = 0; i < options.synthetic.mapCount; i++) {
+        auto layout = new Layout;
+        layout->id = QString("LAYOUT_SYNTHETIC_%1").arg(i);
+        layout->name = QString("Synthetic%1_Layout").arg(i);
+        layout->width = width;
+        layout->height = height;
+        layout->border_width = 2;
+        layout->border_height = 2;
+        layout->tileset_primary = tilesets.at(i % tilesets.size()).first;
+        layout->tileset_secondary = tilesets.at(i % tilesets.size()).second;
+        layout->tileset_primary_label = layout->tileset_primary->name;
+        layout->tileset_secondary_label = layout->tileset_secondary->name;
+        // About a quarter of the blocks are impassable obstacles with random metatiles, and the rest share one ground metatile,
+        // so the fills stop at irregular edges. The center, where the fills start, is always ground.
+        const int center = (height / 2) * width + width / 2;
+        const uint16_t groundMetatileId = random.bounded(Project::getNumMetatilesTotal());
+        for (int j = 0; j < width * height; j++) {
+            const bool impassable = random.bounded(4) == 0 && j != center;
+            if (impassable)
+                layout->blockdata.append(Block(random.bounded(Project::getNumMetatilesTotal()), 1, 0));
+            else
+                layout->blockdata.append(Block(groundMetatileId, 0, 3));
+        }
+        for (int j = 0; j < layout->border_width * layout->border_height; j++)
+            layout->border.append(Block(random.bounded(Project::getNumMetatilesTotal()), 0, 0));
+        layout->lastCommitBlocks.blocks = layout->blockdata;
+        layout->lastCommitBlocks.layoutDimensions = QSize(width, height);
+        layout->lastCommitBlocks.border = layout->border;
+        layout->lastCommitBlocks.borderDimensions = QSize(layout->border_width, layout->border_height);
+        layout->loaded = true;
+        project->mapLayouts.insert(layout->id, layout);
+
+        auto map = new Map;
+        map->setName(QString("Synthetic%1").arg(i));
+        map->setLayout(layout);
+        for (int j = 0; j < options.synthetic.eventCount; j++) {
+            Event *event = Event::create(eventTypes.at(j % eventTypes.size()));
+            map->addEvent(event);
+            event->setDefaultValues(project);
+            event->setX(random.bounded(width));
+            event->setY(random.bounded(height));
+            auto object = dynamic_cast<ObjectEvent *>(event);
+            if (object && !project->gfxDefineNames.isEmpty())
+                object->setGfx(project->gfxDefineNames.at(random.bounded(project->gfxDefineNames.size())));
+        }
+        project->mapCache.insert(map->name, map);
+        maps.append(map);
+    }
+
+    const int columns = qMax(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(maps.size())))));
+    for (int i = 0; i < maps.size(); i++) {
+        if ((i + 1) % columns != 0 && i + 1 < maps.size()) {
+            maps.at(i)->loadConnection(new MapConnection(maps.at(i + 1)->name, "right"));
+            maps.at(i + 1)->loadConnection(new MapConnection(maps.at(i)->name, "left"));
+        }
+        if (i + columns < maps.size()) {
+            maps.at(i)->loadConnection(new MapConnection(maps.at(i + columns)->name, "down"));
+            maps.at(i + columns)->loadConnection(new MapConnection(maps.at(i)->name, "up"));
+        }
+    }
+    logInfo(QString("Generated %1 maps of %2x%3 metatiles, %4 tileset pairs and %5 events per map")
+            .arg(maps.size()).arg(width).arg(height).arg(tilesets.size()).arg(options.synthetic.eventCount));
+    return maps;
+}
+
+// The map.json content for a generated map's events, since generated maps have no files.
+static QByteArray syntheticMapJson(Project *project, Map *map) {
+    OrderedJson::object mapObj;
+    mapObj["id"] = map->constantName;
+    mapObj["name"] = map->name;
+    mapObj["layout"] = map->layoutId;
+    const QList<QPair<Event::Group, QString>> eventGroups = {
+        {Event::Group::Object, "object_events"},
+        {Event::Group::Warp, "warp_events"},
+        {Event::Group::Coord, "coord_events"},
+        {Event::Group::Bg, "bg_events"},
+    };
+    for (const auto &group : eventGroups) {
+        OrderedJson::array eventsArr;
+        for (Event *event : map->events.value(group.first))
+            eventsArr.append(event->buildEventJson(project));
+        mapObj[group.second] = eventsArr;
+    }
+    QByteArray json;
+    OrderedJson(mapObj).dump(json);
+    return json;
+}
+
+// Fills the collision and elevation of each layout from its center, starting from its original blocks.
+static void fillLayouts(const QList<Map *> &maps, const QList<Blockdata> &originalBlocks, void (Layout::*fill)(int, int, uint16_t, uint16_t)) {
+    for (int i = 0; i < maps.size(); i++) {
+        Layout *layout = maps.at(i)->layout;
+        layout->blockdata = originalBlocks.at(i);
+        const int x = layout->getWidth() / 2;
+        const int y = layout->getHeight() / 2;
+        Block block;
+        if (!layout->getBlock(x, y, &block))
+            continue;
+        const uint16_t elevation = block.elevation() < Block::getMaxElevation() ? block.elevation() + 1 : 0;
+        (layout->*fill)(x, y, block.collision(), elevation);
+    }
+}
+
+// Fills the metatiles of each layout from its center with the next metatile, using the map editor's bucket or magic fill.
+// Like in the editor, each fill is added to the layout's edit history. Each layout starts from its original blocks and an empty history.
+static void fillLayoutMetatiles(const QList<LayoutPixmapItem *> &items, const QList<Blockdata> &originalBlocks, bool magic) {
+    for (int i = 0; i < items.size(); i++) {
+        LayoutPixmapItem *item = items.at(i);
+        Layout *layout = item->layout;
+        layout->editHistory.clear();
+        layout->blockdata = originalBlocks.at(i);
+        const int x = layout->getWidth() / 2;
+        const int y = layout->getHeight() / 2;
+        Block block;
+        if (!layout->getBlock(x, y, &block))
+            continue;
+        const uint16_t metatileId = (block.metatileId() + 1) % Project::getNumMetatilesTotal();
+        if (magic)
+            item->magicFill(x, y, metatileId);
+        else
+            item->floodFill(x, y, metatileId);
+    }
+}
+
+// Times the parts of loading, drawing, editing and saving a project that don't need the editor, on the project itself.
+// The maps given are used for the per-map benchmarks, otherwise every map is. If the synthetic options ask for maps,
+// the per-map benchmarks use generated maps instead, so results don't depend on the contents of a particular project.
+static int runBenchmarks(Project *project, const Options &options) {
+    QList<Map *> maps;
+    QStringList blockdataPaths;
+    QList<QByteArray> mapJsons;
+    QTemporaryDir syntheticDir;
+    if (options.synthetic.mapCount > 0) {
+        if (!syntheticDir.isValid()) {
+            logError(QString("Failed to create a folder for the generated blockdata: %1").arg(syntheticDir.errorString()));
+            return 1;
+        }
+        maps = generateSyntheticMaps(project, options);
+        for (Map *map : maps) {
+            // The generated blockdata is written out so that reading it can be timed.
+            const QString path = syntheticDir.filePath(map->layout->name + ".bin");
+            QFile file(path);
+            if (file.open(QIODevice::WriteOnly))
+                file.write(map->layout->blockdata.serialize());
+            blockdataPaths.append(path);
+            mapJsons.append(syntheticMapJson(project, map));
+        }
+    } else {
+        const QStringList mapNames = options.mapNames.isEmpty() ? project->mapNames : options.mapNames;
+        for (const QString &mapName : mapNames) {
+            Map *map = project->getMap(mapName);
+            if (!map) {
+                logError(QString("Failed to load map '%1'").arg(mapName));
+                return 1;
+            }
+            maps.append(map);
+            blockdataPaths.append(QString("%1/%2").arg(project->root).arg(map->layout->blockdata_path));
+            QFile file(QString("%1/%2%3/map.json").arg(project->root).arg(projectConfig.getFilePath(ProjectFilePath::data_map_folders)).arg(map->name));
+            if (file.open(QIODevice::ReadOnly))
+                mapJsons.append(file.readAll());
+        }
+    }
+    if (maps.isEmpty()) {
+        logError("The project has no maps to benchmark.");
+        return 1;
+    }
+    const int iterations = options.iterations;
+    QJsonArray results;
+
+    results.append(benchmark("project_load", iterations, [project] {
+        Project loadedProject;
+        loadedProject.set_root(project->root);
+        loadedProject.load();
+    }));
+    MapConnection::project = project;
+
+    results.append(benchmark("parse_defines", iterations, [project] {
+        const QStringList regexList = {projectConfig.getIdentifier(ProjectIdentifier::regex_obj_event_gfx)};
+        project->parser.readCDefinesByRegex(projectConfig.getFilePath(ProjectFilePath::constants_obj_events), regexList);
+    }));
+    results.append(benchmark("parse_c_structs", iterations, [project] {
+        project->parser.readCStructs(projectConfig.getFilePath(ProjectFilePath::data_obj_event_gfx_info));
+    }));
+
+    QList<poryjson::Json> parsedJsons;
+    results.append(benchmark("json_parse", iterations, [&mapJsons, &parsedJsons] {
+        parsedJsons.clear();
+        QString error;
+        for (const QByteArray &json : mapJsons)
+            parsedJsons.append(poryjson::Json::parse(json, error));
+    }));
+    results.append(benchmark("json_dump", iterations, [&parsedJsons] {
+        for (const poryjson::Json &json : parsedJsons) {
+            QByteArray out;
+            json.dump(out);
+        }
+    }));
+
+    results.append(benchmark("blockdata_read", iterations, [project, &blockdataPaths] {
+        for (const QString &path : blockdataPaths)
+            project->readBlockdata(path);
+    }));
+    results.append(benchmark("blockdata_scan", iterations, [project, &blockdataPaths] {
+        for (const QString &path : blockdataPaths) {
+            const BlockdataView view = project->readBlockdataView(path);
+            int metatileIdSum = 0;
+            for (int i = 0; i < view.length(); i++)
+                metatileIdSum += view.at(i).metatileId();
+            Q_UNUSED(metatileIdSum);
+        }
+    }));
+    results.append(benchmark("blockdata_serialize", iterations, [&maps] {
+        for (const Map *map : maps)
+            map->layout->blockdata.serialize();
+    }));
+
+    results.append(benchmark("metatile_images", iterations, [&maps] {
+        const Layout *layout = maps.first()->layout;
+        for (Tileset *tileset : {layout->tileset_primary, layout->tileset_secondary}) {
+            if (!tileset)
+                continue;
+            for (Metatile *metatile : tileset->metatiles())
+                getMetatileImage(metatile, layout->tileset_primary, layout->tileset_secondary, layout->metatileLayerOrder, layout->metatileLayerOpacity);
+        }
+    }));
+    results.append(benchmark("layout_render", iterations, [&maps] {
+        for (Map *map : maps)
+            map->layout->render(true);
+    }));
+
+    // The fills change the layouts, so each run starts again from the original blocks, which are put back afterwards.
+    QList<Blockdata> originalBlocks;
+    for (const Map *map : maps)
+        originalBlocks.append(map->layout->blockdata);
+    results.append(benchmark("flood_fill", iterations, [&maps, &originalBlocks] {
+        fillLayouts(maps, originalBlocks, &Layout::floodFillCollisionElevation);
+    }));
+    results.append(benchmark("magic_fill", iterations, [&maps, &originalBlocks] {
+        fillLayouts(maps, originalBlocks, &Layout::magicFillCollisionElevation);
+    }));
+    // The metatile fills go through the map editor's fill tools, which don't need the item to be shown.
+    QList<LayoutPixmapItem *> layoutItems;
+    for (Map *map : maps)
+        layoutItems.append(new LayoutPixmapItem(map->layout, nullptr, nullptr));
+    results.append(benchmark("bucket_fill_metatiles", iterations, [&layoutItems, &originalBlocks] {
+        fillLayoutMetatiles(layoutItems, originalBlocks, false);
+    }));
+    results.append(benchmark("magic_fill_metatiles", iterations, [&layoutItems, &originalBlocks] {
+        fillLayoutMetatiles(layoutItems, originalBlocks, true);
+    }));
+    qDeleteAll(layoutItems);
+    for (int i = 0; i < maps.size(); i++) {
+        Layout *layout = maps.at(i)->layout;
+        layout->editHistory.clear();
+        layout->blockdata = originalBlocks.at(i);
+        layout->lastCommitBlocks.blocks = layout->blockdata;
+    }
+
+    // Paints each row of the first layout with a separate command, like strokes of the pencil tool,
+    // then times undoing and redoing all of them, drawing the layout after each one like the editor does.
+    Layout *paintedLayout = maps.first()->layout;
+    paintedLayout->editHistory.clear();
+    for (int y = 0; y < paintedLayout->getHeight(); y++) {
+        const Blockdata oldBlocks = paintedLayout->blockdata;
+        Blockdata newBlocks = oldBlocks;
+        for (int x = 0; x < paintedLayout->getWidth(); x++) {
+            const int index = y * paintedLayout->getWidth() + x;
+            Block block = newBlocks.at(index);
+            block.setMetatileId((block.metatileId() + 1) % Project::getNumMetatilesTotal());
+            newBlocks.replace(index, block);
+        }
+        paintedLayout->editHistory.push(new PaintMetatile(paintedLayout, oldBlocks, newBlocks, y));
+    }
+    results.append(benchmark("undo_redo", iterations, [paintedLayout] {
+        QUndoStack *history = &paintedLayout->editHistory;
+        while (history->canUndo()) {
+            history->undo();
+            paintedLayout->render();
+        }
+        while (history->canRedo()) {
+            history->redo();
+            paintedLayout->render();
+        }
+    }));
+    paintedLayout->editHistory.clear();
+    paintedLayout->blockdata = originalBlocks.first();
+    paintedLayout->lastCommitBlocks.blocks = paintedLayout->blockdata;
+
+    results.append(benchmark("stitched_export", iterations, [project, &maps, &options] {
+        renderMap(project, maps.first(), options, true);
+    }));
+
+    QJsonObject output;
+    output["porymap_version"] = QCoreApplication::applicationVersion();
+    output["project"] = project->root;
+    output["maps"] = maps.size();
+    output["synthetic"] = options.synthetic.mapCount > 0;
+    output["benchmarks"] = results;
+    out() << QJsonDocument(output).toJson(QJsonDocument::Indented);
+    return 0;
+}
+
+int CommandLine::run(const QStringList &arguments) {
+    QCoreApplication::setOrganizationName("pret");
+    QCoreApplication::setApplicationName("porymap");
+    QCoreApplication::setApplicationVersion(PORYMAP_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs a porymap command without opening the main window.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", commands.join(", "));
+    parser.addPositionalArgument("project", "The project's folder.");
+    parser.addPositionalArgument("maps", "The maps to use. export-map uses every map if none are given.", "[maps...]");
+    QCommandLineOption outputOption({"o", "output"}, "The folder to write images to. Defaults to the current folder.", "folder");
+    QCommandLineOption jobsOption({"j", "jobs"}, "The number of threads used to write images. Defaults to the number of cores.", "count");
+    QCommandLineOption noEventsOption("no-events", "Don't draw events on exported maps.");
+    QCommandLineOption borderOption("border", "Draw the border around exported maps.");
+    QCommandLineOption connectionsOption("connections", "Draw the connected maps around exported maps. Implies --border. export-stitched ignores it.");
+    QCommandLineOption gridOption("grid", "Draw the metatile grid on exported maps.");
+    QCommandLineOption collisionOption("collision", "Draw collision and elevation on exported maps.");
+    QCommandLineOption iterationsOption("iterations", "The number of times each benchmark is run. Defaults to 3.", "count");
+    QCommandLineOption syntheticMapsOption("synthetic-maps", "Benchmark this many generated maps instead of the project's maps.", "count");
+    QCommandLineOption syntheticSizeOption("synthetic-size", "The size of each generated map, in metatiles. Defaults to 64x64.", "widthxheight");
+    QCommandLineOption syntheticTilesetsOption("synthetic-tilesets", "The number of generated primary and secondary tileset pairs. Defaults to 2.", "count");
+    QCommandLineOption syntheticEventsOption("synthetic-events", "The number of events on each generated map. Defaults to 32.", "count");
+    parser.addOption(outputOption);
+    parser.addOption(iterationsOption);
+    parser.addOption(syntheticMapsOption);
+    parser.addOption(syntheticSizeOption);
+    parser.addOption(syntheticTilesetsOption);
+    parser.addOption(syntheticEventsOption);
+    parser.addOption(jobsOption);
+    parser.addOption(noEventsOption);
+    parser.addOption(borderOption);
+    parser.addOption(connectionsOption);
+    parser.addOption(gridOption);
+    parser.addOption(collisionOption);
+    parser.process(arguments);
+
+    const QStringList positional = parser.positionalArguments();
+    if (positional.size() < 2) {
+        out() << parser.helpText();
+        return 1;
+    }
+
+    Options options;
+    options.command = positional.at(0);
+    options.projectDir = QDir(positional.at(1)).absolutePath();
+    options.mapNames = positional.mid(2);
+    options.outputDir = parser.value(outputOption);
+    ImageExporterSettings &imageSettings = options.imageSettings;
+    const bool showEvents = !parser.isSet(noEventsOption);
+    imageSettings.showObjects = showEvents;
+    imageSettings.showWarps = showEvents;
+    imageSettings.showBGs = showEvents;
+    imageSettings.showTriggers = showEvents;
+    imageSettings.showHealLocations = showEvents;
+    // Like in the exporter, connections aren't drawn on stitched images, and showing them implicitly shows the border.
+    const bool showConnections = parser.isSet(connectionsOption) && options.command != "export-stitched";
+    imageSettings.showUpConnections = showConnections;
+    imageSettings.showDownConnections = showConnections;
+    imageSettings.showLeftConnections = showConnections;
+    imageSettings.showRightConnections = showConnections;
+    imageSettings.showBorder = parser.isSet(borderOption) || showConnections;
+    imageSettings.showGrid = parser.isSet(gridOption);
+    imageSettings.showCollision = parser.isSet(collisionOption);
+    if (parser.isSet(jobsOption)) {
+        bool ok;
+        const int jobs = parser.value(jobsOption).toInt(&ok);
+        if (!ok || jobs < 1) {
+            logError(QString("Invalid number of jobs '%1'").arg(parser.value(jobsOption)));
+            return 1;
+        }
+        QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+    }
+    if (parser.isSet(iterationsOption)) {
+        bool ok;
+        options.iterations = parser.value(iterationsOption).toInt(&ok);
+        if (!ok || options.iterations < 1) {
+            logError(QString("Invalid number of iterations '%1'").arg(parser.value(iterationsOption)));
+            return 1;
+        }
+    }
+    const QList<QPair<QCommandLineOption, int *>> syntheticCounts = {
+        {syntheticMapsOption, &options.synthetic.mapCount},
+        {syntheticTilesetsOption, &options.synthetic.tilesetCount},
+        {syntheticEventsOption, &options.synthetic.eventCount},
+    };
+    for (const auto &count : syntheticCounts) {
+        if (!parser.isSet(count.first))
+            continue;
+        bool ok;
+        *count.second = parser.value(count.first).toInt(&ok);
+        if (!ok || *count.second < 0) {
+            logError(QString("Invalid value '%1' for --%2").arg(parser.value(count.first)).arg(count.first.names().first()));
+            return 1;
+        }
+    }
+    if (options.synthetic.tilesetCount < 1) {
+        logError("At least one synthetic tileset pair is needed.");
+        return 1;
+    }
+    if (parser.isSet(syntheticSizeOption)) {
+        const QStringList size = parser.value(syntheticSizeOption).split('x');
+        bool widthOk = false, heightOk = false;
+        if (size.length() == 2)
+            options.synthetic.mapSize = QSize(size.at(0).toInt(&widthOk), size.at(1).toInt(&heightOk));
+        if (!widthOk || !heightOk || options.synthetic.mapSize.isEmpty()) {
+            logError(QString("Invalid map size '%1'").arg(parser.value(syntheticSizeOption)));
+            return 1;
+        }
+    }
+
+    porymapConfig.load();
+    options.imageSettings.collisionOpacity = static_cast<qreal>(porymapConfig.collisionOpacity) / 100;
+    ImageCache::setBudget(static_cast<qint64>(porymapConfig.imageCacheSize) * 1024 * 1024);
+    setLogStructured(porymapConfig.structuredLog);
+    Tracer::init(porymapConfig.performanceTracing);
+
+    Project *project = openProject(options.projectDir);
+    if (!project)
+        return 1;
+
+    int result = 1;
+    if (options.command == "export-map") {
+        result = exportMaps(project, options, false);
+    } else if (options.command == "export-stitched") {
+        result = exportMaps(project, options, true);
+    } else if (options.command == "validate") {
+        result = validate(project);
+    } else if (options.command == "resave") {
+        result = resave(project);
+    } else if (options.command == "dump-stats") {
+        result = dumpStats(project);
+    } else if (options.command == "benchmark") {
+        result = runBenchmarks(project, options);
+    }
+    out().flush();
+    delete project;
+    return result;
+}
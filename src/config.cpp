@@ -4,6 +4,8 @@
 #include "map.h"
 #include <QDir>
 #include <QFile>
+#include <QSaveFile>
+#include <QCoreApplication>
 #include <QFormLayout>
 #include <QDialog>
 #include <QDialogButtonBox>
@@ -196,54 +198,100 @@ KeyValueConfigBase::~KeyValueConfigBase() {
 
 }
 
+// How long saveLater() waits for more changes before writing.
+#define SAVE_DELAY_MS 1000
+
 void KeyValueConfigBase::load() {
+    // Anything waiting to be saved is replaced by what's loaded.
+    if (this->saveTimer)
+        this->saveTimer->stop();
+
     reset();
-    QFile file(this->getConfigFilepath());
+    const QString filepath = this->getConfigFilepath();
+    this->savedText.clear();
+    this->savedFilepath = filepath;
+    QString text;
+    QFile file(filepath);
     if (!file.exists()) {
         this->init();
     } else if (!file.open(QIODevice::ReadOnly)) {
-        logError(QString("Could not open config file '%1': ").arg(this->getConfigFilepath()) + file.errorString());
+        logError(QString("Could not open config file '%1': ").arg(filepath) + file.errorString());
+    } else {
+        text = QString::fromUtf8(file.readAll());
+        file.close();
+        this->savedText = text;
     }
 
-    QTextStream in(&file);
-    static const QRegularExpression re("^(?<key>[^=]+)=(?<value>.*)$");
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
+    const QStringList lines = text.split('\n');
+    for (QString line : lines) {
         int commentIndex = line.indexOf("#");
         if (commentIndex >= 0) {
-            line = line.left(commentIndex).trimmed();
+            line.truncate(commentIndex);
         }
+        line = line.trimmed();
 
         if (line.length() == 0) {
             continue;
         }
 
-        QRegularExpressionMatch match = re.match(line);
-        if (!match.hasMatch()) {
-            logWarn(QString("Invalid config line in %1: '%2'").arg(this->getConfigFilepath()).arg(line));
+        int separatorIndex = line.indexOf('=');
+        if (separatorIndex <= 0) {
+            logWarn(QString("Invalid config line in %1: '%2'").arg(filepath).arg(line));
             continue;
         }
 
-        this->parseConfigKeyValue(match.captured("key").trimmed().toLower(), match.captured("value").trimmed());
+        this->parseConfigKeyValue(line.left(separatorIndex).trimmed().toLower(), line.mid(separatorIndex + 1).trimmed());
     }
     this->setUnreadKeys();
-
-    file.close();
 }
 
 void KeyValueConfigBase::save() {
-    QString text = "";
-    QMap<QString, QString> map = this->getKeyValueMap();
-    for (QMap<QString, QString>::iterator it = map.begin(); it != map.end(); it++) {
-        text += QString("%1=%2\n").arg(it.key()).arg(it.value());
+    if (this->saveTimer)
+        this->saveTimer->stop();
+
+    QString text;
+    const QMap<QString, QString> map = this->getKeyValueMap();
+    for (auto it = map.constBegin(); it != map.constEnd(); it++) {
+        text += it.key();
+        text += '=';
+        text += it.value();
+        text += '\n';
     }
 
-    QFile file(this->getConfigFilepath());
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(text.toUtf8());
-        file.close();
-    } else {
-        logError(QString("Could not open config file '%1' for writing: ").arg(this->getConfigFilepath()) + file.errorString());
+    const QString filepath = this->getConfigFilepath();
+    if (text == this->savedText && filepath == this->savedFilepath && QFile::exists(filepath))
+        return;
+
+    // The text is written to a temporary file, which then replaces the config file, so the config is never left half-written.
+    QSaveFile file(filepath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        logError(QString("Could not open config file '%1' for writing: ").arg(filepath) + file.errorString());
+        return;
+    }
+    file.write(text.toUtf8());
+    if (!file.commit()) {
+        logError(QString("Could not write config file '%1': ").arg(filepath) + file.errorString());
+        return;
+    }
+    this->savedText = text;
+    this->savedFilepath = filepath;
+}
+
+void KeyValueConfigBase::saveLater() {
+    if (!this->saveTimer) {
+        // The configs are created before the application, so the timer is only created once it's needed.
+        this->saveTimer = new QTimer(QCoreApplication::instance());
+        this->saveTimer->setSingleShot(true);
+        this->saveTimer->setInterval(SAVE_DELAY_MS);
+        QObject::connect(this->saveTimer, &QTimer::timeout, [this] { this->save(); });
+    }
+    this->saveTimer->start();
+}
+
+void savePendingConfigs() {
+    for (KeyValueConfigBase *config : QList<KeyValueConfigBase *>{&porymapConfig, &projectConfig, &userConfig, &shortcutsConfig}) {
+        if (config->hasPendingSave())
+            config->save();
     }
 }
 
@@ -276,6 +324,79 @@ uint32_t KeyValueConfigBase::getConfigUint32(QString key, QString value, uint32_
     return qMin(max, qMax(min, result));
 }
 
+void KeyValueConfigBase::registerKeysOnce() {
+    if (this->keysRegistered)
+        return;
+    this->keysRegistered = true;
+    this->registerKeys();
+}
+
+void KeyValueConfigBase::addKey(const QString &key, const Key &handler) {
+    this->keys.insert(key, handler);
+}
+
+void KeyValueConfigBase::addKeyGroup(const QString &prefix, const KeyGroup &group) {
+    this->keyGroups.append(qMakePair(prefix, group));
+}
+
+KeyValueConfigBase::Key KeyValueConfigBase::boolKey(bool *value) {
+    return Key{
+        [this, value](const QString &key, const QString &text) { *value = getConfigBool(key, text); },
+        [value] { return QString::number(*value); }
+    };
+}
+
+KeyValueConfigBase::Key KeyValueConfigBase::intKey(int *value, int min, int max, int defaultValue) {
+    return Key{
+        [this, value, min, max, defaultValue](const QString &key, const QString &text) { *value = getConfigInteger(key, text, min, max, defaultValue); },
+        [value] { return QString::number(*value); }
+    };
+}
+
+KeyValueConfigBase::Key KeyValueConfigBase::stringKey(QString *value) {
+    return Key{
+        [value](const QString &, const QString &text) { *value = text; },
+        [value] { return *value; }
+    };
+}
+
+void KeyValueConfigBase::parseConfigKeyValue(const QString &key, const QString &value) {
+    this->registerKeysOnce();
+
+    auto it = this->keys.constFind(key);
+    if (it != this->keys.constEnd()) {
+        this->readKeys.insert(key);
+        it.value().read(key, value);
+        return;
+    }
+    for (const auto &group : this->keyGroups) {
+        if (key.startsWith(group.first)) {
+            this->readKeys.insert(key);
+            group.second.read(key.mid(group.first.length()), value);
+            return;
+        }
+    }
+    logWarn(QString("Invalid config key found in config file %1: '%2'").arg(this->getConfigFilepath()).arg(key));
+}
+
+QMap<QString, QString> KeyValueConfigBase::getKeyValueMap() {
+    this->registerKeysOnce();
+
+    QMap<QString, QString> map;
+    for (auto it = this->keys.constBegin(); it != this->keys.constEnd(); it++) {
+        if (it.value().write)
+            map.insert(it.key(), it.value().write());
+    }
+    for (const auto &group : this->keyGroups) {
+        if (!group.second.write)
+            continue;
+        const QMap<QString, QString> groupMap = group.second.write();
+        for (auto it = groupMap.constBegin(); it != groupMap.constEnd(); it++)
+            map.insert(group.first + it.key(), it.value());
+    }
+    return map;
+}
+
 PorymapConfig porymapConfig;
 
 QString PorymapConfig::getConfigFilepath() {
@@ -290,188 +411,112 @@ QString PorymapConfig::getConfigFilepath() {
     return configPath;
 }
 
-void PorymapConfig::parseConfigKeyValue(QString key, QString value) {
-    if (key == "recent_project") {
-        this->recentProjects = value.split(",", Qt::SkipEmptyParts);
-        this->recentProjects.removeDuplicates();
-    } else if (key == "project_manually_closed") {
-        this->projectManuallyClosed = getConfigBool(key, value);
-    } else if (key == "reopen_on_launch") {
-        this->reopenOnLaunch = getConfigBool(key, value);
-    } else if (key == "pretty_cursors") {
-        this->prettyCursors = getConfigBool(key, value);
-    } else if (key == "map_list_tab") {
-        this->mapListTab = getConfigInteger(key, value, 0, 2, 0);
-    } else if (key == "main_window_geometry") {
-        this->mainWindowGeometry = bytesFromString(value);
-    } else if (key == "main_window_state") {
-        this->mainWindowState = bytesFromString(value);
-    } else if (key == "map_splitter_state") {
-        this->mapSplitterState = bytesFromString(value);
-    } else if (key == "main_splitter_state") {
-        this->mainSplitterState = bytesFromString(value);
-    } else if (key == "metatiles_splitter_state") {
-        this->metatilesSplitterState = bytesFromString(value);
-    } else if (key == "mirror_connecting_maps") {
-        this->mirrorConnectingMaps = getConfigBool(key, value);
-    } else if (key == "show_dive_emerge_maps") {
-        this->showDiveEmergeMaps = getConfigBool(key, value);
-    } else if (key == "dive_emerge_map_opacity") {
-        this->diveEmergeMapOpacity = getConfigInteger(key, value, 10, 90, 30);
-    } else if (key == "dive_map_opacity") {
-        this->diveMapOpacity = getConfigInteger(key, value, 10, 90, 15);
-    } else if (key == "emerge_map_opacity") {
-        this->emergeMapOpacity = getConfigInteger(key, value, 10, 90, 15);
-    } else if (key == "collision_opacity") {
-        this->collisionOpacity = getConfigInteger(key, value, 0, 100, 50);
-    } else if (key == "tileset_editor_geometry") {
-        this->tilesetEditorGeometry = bytesFromString(value);
-    } else if (key == "tileset_editor_state") {
-        this->tilesetEditorState = bytesFromString(value);
-    } else if (key == "tileset_editor_splitter_state") {
-        this->tilesetEditorSplitterState = bytesFromString(value);
-    } else if (key == "palette_editor_geometry") {
-        this->paletteEditorGeometry = bytesFromString(value);
-    } else if (key == "palette_editor_state") {
-        this->paletteEditorState = bytesFromString(value);
-    } else if (key == "region_map_editor_geometry") {
-        this->regionMapEditorGeometry = bytesFromString(value);
-    } else if (key == "region_map_editor_state") {
-        this->regionMapEditorState = bytesFromString(value);
-    } else if (key == "project_settings_editor_geometry") {
-        this->projectSettingsEditorGeometry = bytesFromString(value);
-    } else if (key == "project_settings_editor_state") {
-        this->projectSettingsEditorState = bytesFromString(value);
-    } else if (key == "custom_scripts_editor_geometry") {
-        this->customScriptsEditorGeometry = bytesFromString(value);
-    } else if (key == "custom_scripts_editor_state") {
-        this->customScriptsEditorState = bytesFromString(value);
-    } else if (key == "wild_mon_chart_geometry") {
-        this->wildMonChartGeometry = bytesFromString(value);
-    } else if (key == "metatiles_zoom") {
-        this->metatilesZoom = getConfigInteger(key, value, 10, 100, 30);
-    } else if (key == "collision_zoom") {
-        this->collisionZoom = getConfigInteger(key, value, 10, 100, 30);
-    } else if (key == "tileset_editor_metatiles_zoom") {
-        this->tilesetEditorMetatilesZoom = getConfigInteger(key, value, 10, 100, 30);
-    } else if (key == "tileset_editor_tiles_zoom") {
-        this->tilesetEditorTilesZoom = getConfigInteger(key, value, 10, 100, 30);
-    } else if (key == "show_player_view") {
-        this->showPlayerView = getConfigBool(key, value);
-    } else if (key == "show_cursor_tile") {
-        this->showCursorTile = getConfigBool(key, value);
-    } else if (key == "show_border") {
-        this->showBorder = getConfigBool(key, value);
-    } else if (key == "show_grid") {
-        this->showGrid = getConfigBool(key, value);
-    } else if (key == "show_tileset_editor_metatile_grid") {
-        this->showTilesetEditorMetatileGrid = getConfigBool(key, value);
-    } else if (key == "show_tileset_editor_layer_grid") {
-        this->showTilesetEditorLayerGrid = getConfigBool(key, value);
-    } else if (key == "monitor_files") {
-        this->monitorFiles = getConfigBool(key, value);
-    } else if (key == "tileset_checkerboard_fill") {
-        this->tilesetCheckerboardFill = getConfigBool(key, value);
-    } else if (key == "theme") {
-        this->theme = value;
-    } else if (key == "wild_mon_chart_theme") {
-        this->wildMonChartTheme = value;
-    } else if (key == "text_editor_open_directory") {
-        this->textEditorOpenFolder = value;
-    } else if (key == "text_editor_goto_line") {
-        this->textEditorGotoLine = value;
-    } else if (key == "palette_editor_bit_depth") {
-        this->paletteEditorBitDepth = getConfigInteger(key, value, 15, 24, 24);
-        if (this->paletteEditorBitDepth != 15 && this->paletteEditorBitDepth != 24){
-            this->paletteEditorBitDepth = 24;
-        }
-    } else if (key == "project_settings_tab") {
-        this->projectSettingsTab = getConfigInteger(key, value, 0);
-    } else if (key == "warp_behavior_warning_disabled") {
-        this->warpBehaviorWarningDisabled = getConfigBool(key, value);
-    } else if (key == "check_for_updates") {
-        this->checkForUpdates = getConfigBool(key, value);
-    } else if (key == "last_update_check_time") {
-        this->lastUpdateCheckTime = QDateTime::fromString(value).toLocalTime();
-    } else if (key == "last_update_check_version") {
-        auto version = QVersionNumber::fromString(value);
-        if (version.segmentCount() != 3) {
-            logWarn(QString("Invalid config value for %1: '%2'. Must be 3 numbers separated by '.'").arg(key).arg(value));
-            this->lastUpdateCheckVersion = porymapVersion;
-        } else {
-            this->lastUpdateCheckVersion = version;
-        }
-    } else if (key.startsWith("rate_limit_time/")) {
-        static const QRegularExpression regex("\\brate_limit_time/(?<url>.+)");
-        QRegularExpressionMatch match = regex.match(key);
-        if (match.hasMatch()) {
-            this->rateLimitTimes.insert(match.captured("url"), QDateTime::fromString(value).toLocalTime());
+void PorymapConfig::registerKeys() {
+    auto bytesKey = [this](QByteArray *bytes) {
+        return Key{
+            [this, bytes](const QString &, const QString &value) { *bytes = bytesFromString(value); },
+            [this, bytes] { return stringFromByteArray(*bytes); }
+        };
+    };
+
+    addKey("recent_project", Key{
+        [this](const QString &, const QString &value) {
+            this->recentProjects = value.split(",", Qt::SkipEmptyParts);
+            this->recentProjects.removeDuplicates();
+        },
+        [this] { return this->recentProjects.join(","); }
+    });
+    addKey("project_manually_closed", boolKey(&this->projectManuallyClosed));
+    addKey("reopen_on_launch", boolKey(&this->reopenOnLaunch));
+    addKey("pretty_cursors", boolKey(&this->prettyCursors));
+    addKey("map_list_tab", intKey(&this->mapListTab, 0, 2, 0));
+    addKey("main_window_geometry", bytesKey(&this->mainWindowGeometry));
+    addKey("main_window_state", bytesKey(&this->mainWindowState));
+    addKey("map_splitter_state", bytesKey(&this->mapSplitterState));
+    addKey("main_splitter_state", bytesKey(&this->mainSplitterState));
+    addKey("metatiles_splitter_state", bytesKey(&this->metatilesSplitterState));
+    addKey("mirror_connecting_maps", boolKey(&this->mirrorConnectingMaps));
+    addKey("show_dive_emerge_maps", boolKey(&this->showDiveEmergeMaps));
+    addKey("dive_emerge_map_opacity", intKey(&this->diveEmergeMapOpacity, 10, 90, 30));
+    addKey("dive_map_opacity", intKey(&this->diveMapOpacity, 10, 90, 15));
+    addKey("emerge_map_opacity", intKey(&this->emergeMapOpacity, 10, 90, 15));
+    addKey("collision_opacity", intKey(&this->collisionOpacity, 0, 100, 50));
+    addKey("tileset_editor_geometry", bytesKey(&this->tilesetEditorGeometry));
+    addKey("tileset_editor_state", bytesKey(&this->tilesetEditorState));
+    addKey("tileset_editor_splitter_state", bytesKey(&this->tilesetEditorSplitterState));
+    addKey("palette_editor_geometry", bytesKey(&this->paletteEditorGeometry));
+    addKey("palette_editor_state", bytesKey(&this->paletteEditorState));
+    addKey("region_map_editor_geometry", bytesKey(&this->regionMapEditorGeometry));
+    addKey("region_map_editor_state", bytesKey(&this->regionMapEditorState));
+    addKey("project_settings_editor_geometry", bytesKey(&this->projectSettingsEditorGeometry));
+    addKey("project_settings_editor_state", bytesKey(&this->projectSettingsEditorState));
+    addKey("custom_scripts_editor_geometry", bytesKey(&this->customScriptsEditorGeometry));
+    addKey("custom_scripts_editor_state", bytesKey(&this->customScriptsEditorState));
+    addKey("wild_mon_chart_geometry", bytesKey(&this->wildMonChartGeometry));
+    addKey("metatiles_zoom", intKey(&this->metatilesZoom, 10, 100, 30));
+    addKey("collision_zoom", intKey(&this->collisionZoom, 10, 100, 30));
+    addKey("tileset_editor_metatiles_zoom", intKey(&this->tilesetEditorMetatilesZoom, 10, 100, 30));
+    addKey("tileset_editor_tiles_zoom", intKey(&this->tilesetEditorTilesZoom, 10, 100, 30));
+    addKey("show_player_view", boolKey(&this->showPlayerView));
+    addKey("show_cursor_tile", boolKey(&this->showCursorTile));
+    addKey("show_border", boolKey(&this->showBorder));
+    addKey("show_grid", boolKey(&this->showGrid));
+    addKey("show_tileset_editor_metatile_grid", boolKey(&this->showTilesetEditorMetatileGrid));
+    addKey("show_tileset_editor_layer_grid", boolKey(&this->showTilesetEditorLayerGrid));
+    addKey("monitor_files", boolKey(&this->monitorFiles));
+    addKey("tileset_checkerboard_fill", boolKey(&this->tilesetCheckerboardFill));
+    addKey("theme", stringKey(&this->theme));
+    addKey("wild_mon_chart_theme", stringKey(&this->wildMonChartTheme));
+    addKey("text_editor_open_directory", stringKey(&this->textEditorOpenFolder));
+    addKey("text_editor_goto_line", stringKey(&this->textEditorGotoLine));
+    addKey("palette_editor_bit_depth", Key{
+        [this](const QString &key, const QString &value) {
+            this->paletteEditorBitDepth = getConfigInteger(key, value, 15, 24, 24);
+            if (this->paletteEditorBitDepth != 15 && this->paletteEditorBitDepth != 24){
+                this->paletteEditorBitDepth = 24;
+            }
+        },
+        [this] { return QString::number(this->paletteEditorBitDepth); }
+    });
+    addKey("image_cache_size", intKey(&this->imageCacheSize, 16, 4096, 256));
+    addKey("script_callback_budget", intKey(&this->scriptCallbackBudget, 0, 10000, 50));
+    addKey("structured_log", boolKey(&this->structuredLog));
+    addKey("performance_tracing", boolKey(&this->performanceTracing));
+    addKey("project_settings_tab", intKey(&this->projectSettingsTab, 0));
+    addKey("warp_behavior_warning_disabled", boolKey(&this->warpBehaviorWarningDisabled));
+    addKey("check_for_updates", boolKey(&this->checkForUpdates));
+    addKey("last_update_check_time", Key{
+        [this](const QString &, const QString &value) { this->lastUpdateCheckTime = QDateTime::fromString(value).toLocalTime(); },
+        [this] { return this->lastUpdateCheckTime.toUTC().toString(); }
+    });
+    addKey("last_update_check_version", Key{
+        [this](const QString &key, const QString &value) {
+            auto version = QVersionNumber::fromString(value);
+            if (version.segmentCount() != 3) {
+                logWarn(QString("Invalid config value for %1: '%2'. Must be 3 numbers separated by '.'").arg(key).arg(value));
+                this->lastUpdateCheckVersion = porymapVersion;
+            } else {
+                this->lastUpdateCheckVersion = version;
+            }
+        },
+        [this] { return this->lastUpdateCheckVersion.toString(); }
+    });
+    addKeyGroup("rate_limit_time/", KeyGroup{
+        [this](const QString &url, const QString &value) {
+            if (!url.isEmpty())
+                this->rateLimitTimes.insert(url, QDateTime::fromString(value).toLocalTime());
+        },
+        [this] {
+            QMap<QString, QString> map;
+            for (auto i = this->rateLimitTimes.cbegin(), end = this->rateLimitTimes.cend(); i != end; i++){
+                // Only include rate limit times that are still active (i.e., in the future)
+                const QDateTime time = i.value();
+                if (!time.isNull() && time > QDateTime::currentDateTime())
+                    map.insert(i.key().toString(), time.toUTC().toString());
+            }
+            return map;
         }
-    } else {
-        logWarn(QString("Invalid config key found in config file %1: '%2'").arg(this->getConfigFilepath()).arg(key));
-    }
-}
-
-QMap<QString, QString> PorymapConfig::getKeyValueMap() {
-    QMap<QString, QString> map;
-    map.insert("recent_project", this->recentProjects.join(","));
-    map.insert("project_manually_closed", this->projectManuallyClosed ? "1" : "0");
-    map.insert("reopen_on_launch", this->reopenOnLaunch ? "1" : "0");
-    map.insert("pretty_cursors", this->prettyCursors ? "1" : "0");
-    map.insert("map_list_tab", QString::number(this->mapListTab));
-    map.insert("main_window_geometry", stringFromByteArray(this->mainWindowGeometry));
-    map.insert("main_window_state", stringFromByteArray(this->mainWindowState));
-    map.insert("map_splitter_state", stringFromByteArray(this->mapSplitterState));
-    map.insert("main_splitter_state", stringFromByteArray(this->mainSplitterState));
-    map.insert("metatiles_splitter_state", stringFromByteArray(this->metatilesSplitterState));
-    map.insert("tileset_editor_geometry", stringFromByteArray(this->tilesetEditorGeometry));
-    map.insert("tileset_editor_state", stringFromByteArray(this->tilesetEditorState));
-    map.insert("tileset_editor_splitter_state", stringFromByteArray(this->tilesetEditorSplitterState));
-    map.insert("palette_editor_geometry", stringFromByteArray(this->paletteEditorGeometry));
-    map.insert("palette_editor_state", stringFromByteArray(this->paletteEditorState));
-    map.insert("region_map_editor_geometry", stringFromByteArray(this->regionMapEditorGeometry));
-    map.insert("region_map_editor_state", stringFromByteArray(this->regionMapEditorState));
-    map.insert("project_settings_editor_geometry", stringFromByteArray(this->projectSettingsEditorGeometry));
-    map.insert("project_settings_editor_state", stringFromByteArray(this->projectSettingsEditorState));
-    map.insert("custom_scripts_editor_geometry", stringFromByteArray(this->customScriptsEditorGeometry));
-    map.insert("custom_scripts_editor_state", stringFromByteArray(this->customScriptsEditorState));
-    map.insert("wild_mon_chart_geometry", stringFromByteArray(this->wildMonChartGeometry));
-    map.insert("mirror_connecting_maps", this->mirrorConnectingMaps ? "1" : "0");
-    map.insert("show_dive_emerge_maps", this->showDiveEmergeMaps ? "1" : "0");
-    map.insert("dive_emerge_map_opacity", QString::number(this->diveEmergeMapOpacity));
-    map.insert("dive_map_opacity", QString::number(this->diveMapOpacity));
-    map.insert("emerge_map_opacity", QString::number(this->emergeMapOpacity));
-    map.insert("collision_opacity", QString::number(this->collisionOpacity));
-    map.insert("collision_zoom", QString::number(this->collisionZoom));
-    map.insert("metatiles_zoom", QString::number(this->metatilesZoom));
-    map.insert("tileset_editor_metatiles_zoom", QString::number(this->tilesetEditorMetatilesZoom));
-    map.insert("tileset_editor_tiles_zoom", QString::number(this->tilesetEditorTilesZoom));
-    map.insert("show_player_view", this->showPlayerView ? "1" : "0");
-    map.insert("show_cursor_tile", this->showCursorTile ? "1" : "0");
-    map.insert("show_border", this->showBorder ? "1" : "0");
-    map.insert("show_grid", this->showGrid ? "1" : "0");
-    map.insert("show_tileset_editor_metatile_grid", this->showTilesetEditorMetatileGrid ? "1" : "0");
-    map.insert("show_tileset_editor_layer_grid", this->showTilesetEditorLayerGrid ? "1" : "0");
-    map.insert("monitor_files", this->monitorFiles ? "1" : "0");
-    map.insert("tileset_checkerboard_fill", this->tilesetCheckerboardFill ? "1" : "0");
-    map.insert("theme", this->theme);
-    map.insert("wild_mon_chart_theme", this->wildMonChartTheme);
-    map.insert("text_editor_open_directory", this->textEditorOpenFolder);
-    map.insert("text_editor_goto_line", this->textEditorGotoLine);
-    map.insert("palette_editor_bit_depth", QString::number(this->paletteEditorBitDepth));
-    map.insert("project_settings_tab", QString::number(this->projectSettingsTab));
-    map.insert("warp_behavior_warning_disabled", QString::number(this->warpBehaviorWarningDisabled));
-    map.insert("check_for_updates", QString::number(this->checkForUpdates));
-    map.insert("last_update_check_time", this->lastUpdateCheckTime.toUTC().toString());
-    map.insert("last_update_check_version", this->lastUpdateCheckVersion.toString());
-    for (auto i = this->rateLimitTimes.cbegin(), end = this->rateLimitTimes.cend(); i != end; i++){
-        // Only include rate limit times that are still active (i.e., in the future)
-        const QDateTime time = i.value();
-        if (!time.isNull() && time > QDateTime::currentDateTime())
-            map.insert("rate_limit_time/" + i.key().toString(), time.toUTC().toString());
-    }
-    
-    return map;
+    });
 }
 
 QString PorymapConfig::stringFromByteArray(QByteArray bytearray) {
@@ -649,134 +694,163 @@ QString ProjectConfig::getConfigFilepath() {
     return QDir(this->projectDir).filePath("porymap.project.cfg");
 }
 
-void ProjectConfig::parseConfigKeyValue(QString key, QString value) {
-    if (key == "base_game_version") {
-        this->baseGameVersion = this->stringToBaseGameVersion(value.toLower());
-        if (this->baseGameVersion == BaseGameVersion::none) {
-            logWarn(QString("Invalid config value for base_game_version: '%1'. Must be 'pokeruby', 'pokefirered' or 'pokeemerald'.").arg(value));
-            this->baseGameVersion = BaseGameVersion::pokeemerald;
-        }
-    } else if (key == "use_poryscript") {
-        this->usePoryScript = getConfigBool(key, value);
-    } else if (key == "use_custom_border_size") {
-        this->useCustomBorderSize = getConfigBool(key, value);
-    } else if (key == "enable_event_weather_trigger") {
-        this->eventWeatherTriggerEnabled = getConfigBool(key, value);
-    } else if (key == "enable_event_secret_base") {
-        this->eventSecretBaseEnabled = getConfigBool(key, value);
-    } else if (key == "enable_hidden_item_quantity") {
-        this->hiddenItemQuantityEnabled = getConfigBool(key, value);
-    } else if (key == "enable_hidden_item_requires_itemfinder") {
-        this->hiddenItemRequiresItemfinderEnabled = getConfigBool(key, value);
-    } else if (key == "enable_heal_location_respawn_data") {
-        this->healLocationRespawnDataEnabled = getConfigBool(key, value);
-    } else if (key == "enable_event_clone_object" || key == "enable_object_event_in_connection") {
-        this->eventCloneObjectEnabled = getConfigBool(key, value);
-        key = "enable_event_clone_object"; // Backwards compatibiliy, replace old name above
-    } else if (key == "enable_floor_number") {
-        this->floorNumberEnabled = getConfigBool(key, value);
-    } else if (key == "create_map_text_file") {
-        this->createMapTextFileEnabled = getConfigBool(key, value);
-    } else if (key == "enable_triple_layer_metatiles") {
-        this->tripleLayerMetatilesEnabled = getConfigBool(key, value);
-    } else if (key == "default_metatile") {
-        this->defaultMetatileId = getConfigUint32(key, value, 0, Block::maxValue);
-    } else if (key == "default_elevation") {
-        this->defaultElevation = getConfigUint32(key, value, 0, Block::maxValue);
-    } else if (key == "default_collision") {
-        this->defaultCollision = getConfigUint32(key, value, 0, Block::maxValue);
-    } else if (key == "new_map_border_metatiles") {
-        this->newMapBorderMetatileIds.clear();
-        QList<QString> metatileIds = value.split(",");
-        for (int i = 0; i < metatileIds.size(); i++) {
-            int metatileId = getConfigUint32(key, metatileIds.at(i), 0, Block::maxValue);
-            this->newMapBorderMetatileIds.append(metatileId);
-        }
-    } else if (key == "default_primary_tileset") {
-        this->defaultPrimaryTileset = value;
-    } else if (key == "default_secondary_tileset") {
-        this->defaultSecondaryTileset = value;
-    } else if (key == "metatile_attributes_size") {
-        int size = getConfigInteger(key, value, 1, 4, 2);
-        if (size & (size - 1)) {
-            logWarn(QString("Invalid config value for %1: must be 1, 2, or 4").arg(key));
-            return; // Don't set a default now, it will be set later based on the base game version
-        }
-        this->metatileAttributesSize = size;
-    } else if (key == "metatile_behavior_mask") {
-        this->metatileBehaviorMask = getConfigUint32(key, value);
-    } else if (key == "metatile_terrain_type_mask") {
-        this->metatileTerrainTypeMask = getConfigUint32(key, value);
-    } else if (key == "metatile_encounter_type_mask") {
-        this->metatileEncounterTypeMask = getConfigUint32(key, value);
-    } else if (key == "metatile_layer_type_mask") {
-        this->metatileLayerTypeMask = getConfigUint32(key, value);
-    } else if (key == "block_metatile_id_mask") {
-        this->blockMetatileIdMask = getConfigUint32(key, value, 0, Block::maxValue);
-    } else if (key == "block_collision_mask") {
-        this->blockCollisionMask = getConfigUint32(key, value, 0, Block::maxValue);
-    } else if (key == "block_elevation_mask") {
-        this->blockElevationMask = getConfigUint32(key, value, 0, Block::maxValue);
-    } else if (key == "enable_map_allow_flags") {
-        this->mapAllowFlagsEnabled = getConfigBool(key, value);
+void ProjectConfig::registerKeys() {
+    addKey("base_game_version", Key{
+        [this](const QString &, const QString &value) {
+            this->baseGameVersion = this->stringToBaseGameVersion(value.toLower());
+            if (this->baseGameVersion == BaseGameVersion::none) {
+                logWarn(QString("Invalid config value for base_game_version: '%1'. Must be 'pokeruby', 'pokefirered' or 'pokeemerald'.").arg(value));
+                this->baseGameVersion = BaseGameVersion::pokeemerald;
+            }
+        },
+        [this] { return baseGameVersionMap.value(this->baseGameVersion); }
+    });
+    addKey("use_poryscript", boolKey(&this->usePoryScript));
+    addKey("use_custom_border_size", boolKey(&this->useCustomBorderSize));
+    addKey("enable_event_weather_trigger", boolKey(&this->eventWeatherTriggerEnabled));
+    addKey("enable_event_secret_base", boolKey(&this->eventSecretBaseEnabled));
+    addKey("enable_hidden_item_quantity", boolKey(&this->hiddenItemQuantityEnabled));
+    addKey("enable_hidden_item_requires_itemfinder", boolKey(&this->hiddenItemRequiresItemfinderEnabled));
+    addKey("enable_heal_location_respawn_data", boolKey(&this->healLocationRespawnDataEnabled));
+    addKey("enable_event_clone_object", boolKey(&this->eventCloneObjectEnabled));
+    // Backwards compatibility, old name of the key above
+    addKey("enable_object_event_in_connection", Key{
+        [this](const QString &key, const QString &value) {
+            this->eventCloneObjectEnabled = getConfigBool(key, value);
+            this->readKeys.insert("enable_event_clone_object");
+        },
+        nullptr
+    });
+    addKey("enable_floor_number", boolKey(&this->floorNumberEnabled));
+    addKey("create_map_text_file", boolKey(&this->createMapTextFileEnabled));
+    addKey("enable_triple_layer_metatiles", boolKey(&this->tripleLayerMetatilesEnabled));
+    addKey("default_metatile", Key{
+        [this](const QString &key, const QString &value) { this->defaultMetatileId = getConfigUint32(key, value, 0, Block::maxValue); },
+        [this] { return Metatile::getMetatileIdString(this->defaultMetatileId); }
+    });
+    addKey("default_elevation", uintKey(&this->defaultElevation, 0, Block::maxValue));
+    addKey("default_collision", uintKey(&this->defaultCollision, 0, Block::maxValue));
+    addKey("new_map_border_metatiles", Key{
+        [this](const QString &key, const QString &value) {
+            this->newMapBorderMetatileIds.clear();
+            QList<QString> metatileIds = value.split(",");
+            for (int i = 0; i < metatileIds.size(); i++) {
+                int metatileId = getConfigUint32(key, metatileIds.at(i), 0, Block::maxValue);
+                this->newMapBorderMetatileIds.append(metatileId);
+            }
+        },
+        [this] { return Metatile::getMetatileIdStrings(this->newMapBorderMetatileIds); }
+    });
+    addKey("default_primary_tileset", stringKey(&this->defaultPrimaryTileset));
+    addKey("default_secondary_tileset", stringKey(&this->defaultSecondaryTileset));
+    addKey("metatile_attributes_size", Key{
+        [this](const QString &key, const QString &value) {
+            int size = getConfigInteger(key, value, 1, 4, 2);
+            if (size & (size - 1)) {
+                logWarn(QString("Invalid config value for %1: must be 1, 2, or 4").arg(key));
+                // Don't set a default now, it will be set later based on the base game version
+                this->readKeys.remove(key);
+                return;
+            }
+            this->metatileAttributesSize = size;
+        },
+        [this] { return QString::number(this->metatileAttributesSize); }
+    });
+    addKey("metatile_behavior_mask", hexKey(&this->metatileBehaviorMask));
+    addKey("metatile_terrain_type_mask", hexKey(&this->metatileTerrainTypeMask));
+    addKey("metatile_encounter_type_mask", hexKey(&this->metatileEncounterTypeMask));
+    addKey("metatile_layer_type_mask", hexKey(&this->metatileLayerTypeMask));
+    addKey("block_metatile_id_mask", hexKey(&this->blockMetatileIdMask, Block::maxValue));
+    addKey("block_collision_mask", hexKey(&this->blockCollisionMask, Block::maxValue));
+    addKey("block_elevation_mask", hexKey(&this->blockElevationMask, Block::maxValue));
+    addKey("enable_map_allow_flags", boolKey(&this->mapAllowFlagsEnabled));
 #ifdef CONFIG_BACKWARDS_COMPATABILITY
-    } else if (key == "recent_map_or_layout") {
-        userConfig.recentMapOrLayout = value;
-    } else if (key == "use_encounter_json") {
-        userConfig.useEncounterJson = getConfigBool(key, value);
-    } else if (key == "custom_scripts") {
-        userConfig.parseCustomScripts(value);
+    // These keys moved to the user config. They're still read from here, but only written there.
+    addKey("recent_map_or_layout", Key{ stringKey(&userConfig.recentMapOrLayout).read, nullptr });
+    addKey("use_encounter_json", Key{ boolKey(&userConfig.useEncounterJson).read, nullptr });
+    addKey("custom_scripts", Key{ [](const QString &, const QString &value) { userConfig.parseCustomScripts(value); }, nullptr });
 #endif
-    } else if (key.startsWith("path/")) {
-        auto k = reverseDefaultPaths(key.mid(5));
-        if (k != static_cast<ProjectFilePath>(-1)) {
-            this->setFilePath(k, value);
-        } else {
-            logWarn(QString("Invalid config key found in config file %1: '%2'").arg(this->getConfigFilepath()).arg(key));
+    addKeyGroup("path/", KeyGroup{
+        [this](const QString &name, const QString &value) {
+            auto k = reverseDefaultPaths(name);
+            if (k != static_cast<ProjectFilePath>(-1)) {
+                this->setFilePath(k, value);
+            } else {
+                logWarn(QString("Invalid config key found in config file %1: 'path/%2'").arg(this->getConfigFilepath()).arg(name));
+            }
+        },
+        [this] {
+            QMap<QString, QString> map;
+            for (auto it = this->filePaths.constKeyValueBegin(); it != this->filePaths.constKeyValueEnd(); ++it) {
+                map.insert(defaultPaths[(*it).first].first, (*it).second);
+            }
+            return map;
         }
-    } else if (key.startsWith("ident/")) {
-        auto identifierId = reverseDefaultIdentifier(key.mid(6));
-        if (identifierId != static_cast<ProjectIdentifier>(-1)) {
-            this->setIdentifier(identifierId, value);
-        } else {
-            logWarn(QString("Invalid config key found in config file %1: '%2'").arg(this->getConfigFilepath()).arg(key));
+    });
+    addKeyGroup("ident/", KeyGroup{
+        [this](const QString &name, const QString &value) {
+            auto identifierId = reverseDefaultIdentifier(name);
+            if (identifierId != static_cast<ProjectIdentifier>(-1)) {
+                this->setIdentifier(identifierId, value);
+            } else {
+                logWarn(QString("Invalid config key found in config file %1: 'ident/%2'").arg(this->getConfigFilepath()).arg(name));
+            }
+        },
+        [this] {
+            QMap<QString, QString> map;
+            for (auto i = this->identifiers.cbegin(), end = this->identifiers.cend(); i != end; i++) {
+                map.insert(defaultIdentifiers.value(i.key()).first, i.value());
+            }
+            return map;
         }
-    } else if (key == "prefabs_filepath") {
-        this->prefabFilepath = value;
-    } else if (key == "prefabs_import_prompted") {
-        this->prefabImportPrompted = getConfigBool(key, value);
-    } else if (key == "tilesets_have_callback") {
-        this->tilesetsHaveCallback = getConfigBool(key, value);
-    } else if (key == "tilesets_have_is_compressed") {
-        this->tilesetsHaveIsCompressed = getConfigBool(key, value);
-    } else if (key == "event_icon_path_object") {
-        this->eventIconPaths[Event::Group::Object] = value;
-    } else if (key == "event_icon_path_warp") {
-        this->eventIconPaths[Event::Group::Warp] = value;
-    } else if (key == "event_icon_path_coord") {
-        this->eventIconPaths[Event::Group::Coord] = value;
-    } else if (key == "event_icon_path_bg") {
-        this->eventIconPaths[Event::Group::Bg] = value;
-    } else if (key == "event_icon_path_heal") {
-        this->eventIconPaths[Event::Group::Heal] = value;
-    } else if (key.startsWith("pokemon_icon_path/")) {
-        this->pokemonIconPaths.insert(key.mid(18).toUpper(), value);
-    } else if (key == "collision_sheet_path") {
-        this->collisionSheetPath = value;
-    } else if (key == "collision_sheet_width") {
-        this->collisionSheetWidth = getConfigUint32(key, value, 1, Block::maxValue);
-    } else if (key == "collision_sheet_height") {
-        this->collisionSheetHeight = getConfigUint32(key, value, 1, Block::maxValue);
-    } else if (key == "warp_behaviors") {
-        this->warpBehaviors.clear();
-        value.remove(" ");
-        QStringList behaviorList = value.split(",", Qt::SkipEmptyParts);
-        for (auto s : behaviorList)
-            this->warpBehaviors.insert(getConfigUint32(key, s));
-    } else {
-        logWarn(QString("Invalid config key found in config file %1: '%2'").arg(this->getConfigFilepath()).arg(key));
+    });
+    addKey("prefabs_filepath", stringKey(&this->prefabFilepath));
+    addKey("prefabs_import_prompted", boolKey(&this->prefabImportPrompted));
+    addKey("tilesets_have_callback", boolKey(&this->tilesetsHaveCallback));
+    addKey("tilesets_have_is_compressed", boolKey(&this->tilesetsHaveIsCompressed));
+    const QMap<QString, Event::Group> eventIconKeys = {
+        {"event_icon_path_object", Event::Group::Object},
+        {"event_icon_path_warp",   Event::Group::Warp},
+        {"event_icon_path_coord",  Event::Group::Coord},
+        {"event_icon_path_bg",     Event::Group::Bg},
+        {"event_icon_path_heal",   Event::Group::Heal},
+    };
+    for (auto it = eventIconKeys.constBegin(); it != eventIconKeys.constEnd(); it++) {
+        const Event::Group group = it.value();
+        addKey(it.key(), Key{
+            [this, group](const QString &, const QString &value) { this->eventIconPaths[group] = value; },
+            [this, group] { return this->eventIconPaths.value(group); }
+        });
     }
-    readKeys.append(key);
+    addKeyGroup("pokemon_icon_path/", KeyGroup{
+        [this](const QString &species, const QString &value) { this->pokemonIconPaths.insert(species.toUpper(), value); },
+        [this] {
+            QMap<QString, QString> map;
+            for (auto i = this->pokemonIconPaths.cbegin(), end = this->pokemonIconPaths.cend(); i != end; i++){
+                const QString path = i.value();
+                if (!path.isEmpty()) map.insert(i.key(), path);
+            }
+            return map;
+        }
+    });
+    addKey("collision_sheet_path", stringKey(&this->collisionSheetPath));
+    addKey("collision_sheet_width", uintKey(&this->collisionSheetWidth, 1, Block::maxValue));
+    addKey("collision_sheet_height", uintKey(&this->collisionSheetHeight, 1, Block::maxValue));
+    addKey("warp_behaviors", Key{
+        [this](const QString &key, QString value) {
+            this->warpBehaviors.clear();
+            value.remove(" ");
+            QStringList behaviorList = value.split(",", Qt::SkipEmptyParts);
+            for (auto s : behaviorList)
+                this->warpBehaviors.insert(getConfigUint32(key, s));
+        },
+        [this] {
+            QStringList warpBehaviorStrs;
+            for (auto value : this->warpBehaviors)
+                warpBehaviorStrs.append("0x" + QString("%1").arg(value, 2, 16, QChar('0')).toUpper());
+            return warpBehaviorStrs.join(",");
+        }
+    });
 }
 
 // Restore config to version-specific defaults
@@ -809,65 +883,6 @@ void ProjectConfig::setUnreadKeys() {
     if (!readKeys.contains("warp_behaviors")) this->warpBehaviors = isPokefirered ? defaultWarpBehaviors_FRLG : defaultWarpBehaviors_RSE;
 }
 
-QMap<QString, QString> ProjectConfig::getKeyValueMap() {
-    QMap<QString, QString> map;
-    map.insert("base_game_version", baseGameVersionMap.value(this->baseGameVersion));
-    map.insert("use_poryscript", QString::number(this->usePoryScript));
-    map.insert("use_custom_border_size", QString::number(this->useCustomBorderSize));
-    map.insert("enable_event_weather_trigger", QString::number(this->eventWeatherTriggerEnabled));
-    map.insert("enable_event_secret_base", QString::number(this->eventSecretBaseEnabled));
-    map.insert("enable_hidden_item_quantity", QString::number(this->hiddenItemQuantityEnabled));
-    map.insert("enable_hidden_item_requires_itemfinder", QString::number(this->hiddenItemRequiresItemfinderEnabled));
-    map.insert("enable_heal_location_respawn_data", QString::number(this->healLocationRespawnDataEnabled));
-    map.insert("enable_event_clone_object", QString::number(this->eventCloneObjectEnabled));
-    map.insert("enable_floor_number", QString::number(this->floorNumberEnabled));
-    map.insert("create_map_text_file", QString::number(this->createMapTextFileEnabled));
-    map.insert("enable_triple_layer_metatiles", QString::number(this->tripleLayerMetatilesEnabled));
-    map.insert("default_metatile", Metatile::getMetatileIdString(this->defaultMetatileId));
-    map.insert("default_elevation", QString::number(this->defaultElevation));
-    map.insert("default_collision", QString::number(this->defaultCollision));
-    map.insert("new_map_border_metatiles", Metatile::getMetatileIdStrings(this->newMapBorderMetatileIds));
-    map.insert("default_primary_tileset", this->defaultPrimaryTileset);
-    map.insert("default_secondary_tileset", this->defaultSecondaryTileset);
-    map.insert("prefabs_filepath", this->prefabFilepath);
-    map.insert("prefabs_import_prompted", QString::number(this->prefabImportPrompted));
-    for (auto it = this->filePaths.constKeyValueBegin(); it != this->filePaths.constKeyValueEnd(); ++it) {
-        map.insert("path/"+defaultPaths[(*it).first].first, (*it).second);
-    }
-    map.insert("tilesets_have_callback", QString::number(this->tilesetsHaveCallback));
-    map.insert("tilesets_have_is_compressed", QString::number(this->tilesetsHaveIsCompressed));
-    map.insert("metatile_attributes_size", QString::number(this->metatileAttributesSize));
-    map.insert("metatile_behavior_mask", "0x" + QString::number(this->metatileBehaviorMask, 16).toUpper());
-    map.insert("metatile_terrain_type_mask", "0x" + QString::number(this->metatileTerrainTypeMask, 16).toUpper());
-    map.insert("metatile_encounter_type_mask", "0x" + QString::number(this->metatileEncounterTypeMask, 16).toUpper());
-    map.insert("metatile_layer_type_mask", "0x" + QString::number(this->metatileLayerTypeMask, 16).toUpper());
-    map.insert("block_metatile_id_mask", "0x" + QString::number(this->blockMetatileIdMask, 16).toUpper());
-    map.insert("block_collision_mask", "0x" + QString::number(this->blockCollisionMask, 16).toUpper());
-    map.insert("block_elevation_mask", "0x" + QString::number(this->blockElevationMask, 16).toUpper());
-    map.insert("enable_map_allow_flags", QString::number(this->mapAllowFlagsEnabled));
-    map.insert("event_icon_path_object", this->eventIconPaths[Event::Group::Object]);
-    map.insert("event_icon_path_warp", this->eventIconPaths[Event::Group::Warp]);
-    map.insert("event_icon_path_coord", this->eventIconPaths[Event::Group::Coord]);
-    map.insert("event_icon_path_bg", this->eventIconPaths[Event::Group::Bg]);
-    map.insert("event_icon_path_heal", this->eventIconPaths[Event::Group::Heal]);
-    for (auto i = this->pokemonIconPaths.cbegin(), end = this->pokemonIconPaths.cend(); i != end; i++){
-        const QString path = i.value();
-        if (!path.isEmpty()) map.insert("pokemon_icon_path/" + i.key(), path);
-    }
-    for (auto i = this->identifiers.cbegin(), end = this->identifiers.cend(); i != end; i++) {
-        map.insert("ident/"+defaultIdentifiers.value(i.key()).first, i.value());
-    }
-    map.insert("collision_sheet_path", this->collisionSheetPath);
-    map.insert("collision_sheet_width", QString::number(this->collisionSheetWidth));
-    map.insert("collision_sheet_height", QString::number(this->collisionSheetHeight));
-    QStringList warpBehaviorStrs;
-    for (auto value : this->warpBehaviors)
-        warpBehaviorStrs.append("0x" + QString("%1").arg(value, 2, 16, QChar('0')).toUpper());
-    map.insert("warp_behaviors", warpBehaviorStrs.join(","));
-
-    return map;
-}
-
 void ProjectConfig::init() {
     QString dirName = QDir(this->projectDir).dirName().toLower();
 
@@ -1014,30 +1029,18 @@ QString UserConfig::getConfigFilepath() {
     return QDir(this->projectDir).filePath("porymap.user.cfg");
 }
 
-void UserConfig::parseConfigKeyValue(QString key, QString value) {
-    if (key == "recent_map_or_layout") {
-        this->recentMapOrLayout = value;
-    } else if (key == "use_encounter_json") {
-        this->useEncounterJson = getConfigBool(key, value);
-    } else if (key == "custom_scripts") {
-        this->parseCustomScripts(value);
-    } else {
-        logWarn(QString("Invalid config key found in config file %1: '%2'").arg(this->getConfigFilepath()).arg(key));
-    }
-    readKeys.append(key);
+void UserConfig::registerKeys() {
+    addKey("recent_map_or_layout", stringKey(&this->recentMapOrLayout));
+    addKey("use_encounter_json", boolKey(&this->useEncounterJson));
+    addKey("custom_scripts", Key{
+        [this](const QString &, const QString &value) { this->parseCustomScripts(value); },
+        [this] { return this->outputCustomScripts(); }
+    });
 }
 
 void UserConfig::setUnreadKeys() {
 }
 
-QMap<QString, QString> UserConfig::getKeyValueMap() {
-    QMap<QString, QString> map;
-    map.insert("recent_map_or_layout", this->recentMapOrLayout);
-    map.insert("use_encounter_json", QString::number(this->useEncounterJson));
-    map.insert("custom_scripts", this->outputCustomScripts());
-    return map;
-}
-
 void UserConfig::init() {
     this->useEncounterJson = true;
     this->customScripts.clear();
@@ -1102,22 +1105,26 @@ QString ShortcutsConfig::getConfigFilepath() {
     return configPath;
 }
 
-void ShortcutsConfig::parseConfigKeyValue(QString key, QString value) {
-    QStringList keySequences = value.split(' ');
-    for (auto keySequence : keySequences)
-        user_shortcuts.insert(key, keySequence);
-}
-
-QMap<QString, QString> ShortcutsConfig::getKeyValueMap() {
-    QMap<QString, QString> map;
-    for (auto cfg_key : user_shortcuts.uniqueKeys()) {
-        auto keySequences = user_shortcuts.values(cfg_key);
-        QStringList keySequenceStrings;
-        for (auto keySequence : keySequences)
-            keySequenceStrings.append(keySequence.toString());
-        map.insert(cfg_key, keySequenceStrings.join(' '));
-    }
-    return map;
+void ShortcutsConfig::registerKeys() {
+    // Each key is the name of a shortcut, so every key in the file belongs to one group without a prefix.
+    addKeyGroup("", KeyGroup{
+        [this](const QString &key, const QString &value) {
+            QStringList keySequences = value.split(' ');
+            for (auto keySequence : keySequences)
+                user_shortcuts.insert(key, keySequence);
+        },
+        [this] {
+            QMap<QString, QString> map;
+            for (auto cfg_key : user_shortcuts.uniqueKeys()) {
+                auto keySequences = user_shortcuts.values(cfg_key);
+                QStringList keySequenceStrings;
+                for (auto keySequence : keySequences)
+                    keySequenceStrings.append(keySequence.toString());
+                map.insert(cfg_key, keySequenceStrings.join(' '));
+            }
+            return map;
+        }
+    });
 }
 
 void ShortcutsConfig::setDefaultShortcuts(const QObjectList &objects) {
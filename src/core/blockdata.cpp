@@ -1,11 +1,49 @@
 #include "blockdata.h"
 
+#include <QFile>
+
 QByteArray Blockdata::serialize() const {
-    QByteArray data;
+    QByteArray data(this->length() * 2, Qt::Uninitialized);
+    char *out = data.data();
     for (const auto &block : *this) {
         uint16_t word = block.rawValue();
-        data.append(static_cast<char>(word & 0xff));
-        data.append(static_cast<char>((word >> 8) & 0xff));
+        *out++ = static_cast<char>(word & 0xff);
+        *out++ = static_cast<char>((word >> 8) & 0xff);
     }
     return data;
 }
+
+BlockdataView::BlockdataView(const QByteArray &data) :
+    bytes(data),
+    data(reinterpret_cast<const uchar *>(this->bytes.constData())),
+    size(this->bytes.size()),
+    valid(true)
+{}
+
+BlockdataView BlockdataView::fromFile(const QString &path) {
+    QSharedPointer<QFile> file(new QFile(path));
+    if (!file->open(QIODevice::ReadOnly))
+        return BlockdataView();
+
+    // Empty files can't be mapped, and some file systems don't support mapping, so fall back to reading the file.
+    const qint64 size = file->size();
+    const uchar *mapped = size > 0 ? file->map(0, size) : nullptr;
+    if (!mapped)
+        return BlockdataView(file->readAll());
+
+    BlockdataView view;
+    view.file = file;
+    view.data = mapped;
+    view.size = size;
+    view.valid = true;
+    return view;
+}
+
+Blockdata BlockdataView::toBlockdata() const {
+    Blockdata blockdata;
+    blockdata.resize(length());
+    Block *out = blockdata.data();
+    for (int i = 0; i < blockdata.length(); i++)
+        out[i] = Block(rawValue(i));
+    return blockdata;
+}
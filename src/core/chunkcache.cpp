@@ -0,0 +1,151 @@
+#include "chunkcache.h"
+
+#include <cstring>
+
+// Division that rounds towards negative infinity, so that negative coordinates (e.g. the map border) map to the correct chunk.
+static int floorDiv(int a, int b) {
+    int q = a / b;
+    if ((a % b != 0) && ((a < 0) != (b < 0)))
+        q--;
+    return q;
+}
+
+ChunkCache::ChunkCache(BlockSource source, BlockPainter painter, int budget)
+    : blockSource(source),
+      blockPainter(painter),
+      budget(qMax(budget, 1))
+{}
+
+void ChunkCache::setBudget(int budget) {
+    this->budget = qMax(budget, 1);
+    evict();
+}
+
+quint64 ChunkCache::chunkKey(int chunkX, int chunkY) {
+    return (static_cast<quint64>(static_cast<quint32>(chunkY)) << 32) | static_cast<quint32>(chunkX);
+}
+
+int ChunkCache::chunkCoord(int metatileCoord) {
+    return floorDiv(metatileCoord, chunkSize);
+}
+
+void ChunkCache::draw(QPainter *painter, const QRect &rect) {
+    if (!painter || !rect.isValid())
+        return;
+
+    this->drawCount++;
+
+    const int chunkPixels = chunkSize * 16;
+    const int firstX = chunkCoord(floorDiv(rect.left(), 16));
+    const int firstY = chunkCoord(floorDiv(rect.top(), 16));
+    const int lastX = chunkCoord(floorDiv(rect.right(), 16));
+    const int lastY = chunkCoord(floorDiv(rect.bottom(), 16));
+
+    for (int chunkY = firstY; chunkY <= lastY; chunkY++)
+    for (int chunkX = firstX; chunkX <= lastX; chunkX++) {
+        const quint64 key = chunkKey(chunkX, chunkY);
+        auto it = this->chunks.find(key);
+        if (it == this->chunks.end()) {
+            it = this->chunks.insert(key, Chunk());
+            render(&it.value(), chunkX, chunkY);
+        } else {
+            refresh(&it.value(), chunkX, chunkY);
+        }
+        it->lastUsed = this->drawCount;
+        if (!it->image.isNull())
+            painter->drawImage(chunkX * chunkPixels, chunkY * chunkPixels, it->image);
+    }
+
+    evict();
+}
+
+void ChunkCache::render(Chunk *chunk, int chunkX, int chunkY) {
+    const int numBlocks = chunkSize * chunkSize;
+    chunk->blocks.fill(Block(), numBlocks);
+    chunk->hasBlock.fill(false, numBlocks);
+
+    bool hasAnyBlocks = false;
+    for (int i = 0; i < numBlocks; i++) {
+        Block block;
+        if (this->blockSource(chunkX * chunkSize + i % chunkSize, chunkY * chunkSize + i / chunkSize, &block)) {
+            chunk->blocks[i] = block;
+            chunk->hasBlock[i] = true;
+            hasAnyBlocks = true;
+        }
+    }
+
+    // Chunks with nothing to draw (e.g. the area of the border that's covered by the map) don't need an image.
+    if (!hasAnyBlocks) {
+        chunk->image = QImage();
+        return;
+    }
+
+    chunk->image = QImage(chunkSize * 16, chunkSize * 16, imageFormat);
+    chunk->image.fill(Qt::transparent);
+    for (int i = 0; i < numBlocks; i++) {
+        if (chunk->hasBlock.at(i))
+            this->blockPainter(&chunk->image, QPoint((i % chunkSize) * 16, (i / chunkSize) * 16), chunk->blocks.at(i));
+    }
+}
+
+// Redraw only the blocks in an already-rendered chunk that differ from what the chunk was rendered with.
+void ChunkCache::refresh(Chunk *chunk, int chunkX, int chunkY) {
+    const int numBlocks = chunkSize * chunkSize;
+    if (chunk->image.isNull()) {
+        // Nothing was drawn in this chunk previously, render it from scratch if that's no longer true.
+        for (int i = 0; i < numBlocks; i++) {
+            Block block;
+            if (this->blockSource(chunkX * chunkSize + i % chunkSize, chunkY * chunkSize + i / chunkSize, &block)) {
+                render(chunk, chunkX, chunkY);
+                return;
+            }
+        }
+        return;
+    }
+
+    for (int i = 0; i < numBlocks; i++) {
+        Block block;
+        bool hasBlock = this->blockSource(chunkX * chunkSize + i % chunkSize, chunkY * chunkSize + i / chunkSize, &block);
+        if (hasBlock == chunk->hasBlock.at(i) && (!hasBlock || block == chunk->blocks.at(i)))
+            continue;
+
+        // Only the 16x16 area of the changed block is cleared and redrawn.
+        const QPoint origin((i % chunkSize) * 16, (i / chunkSize) * 16);
+        for (int y = 0; y < 16; y++)
+            memset(chunk->image.scanLine(origin.y() + y) + origin.x() * 4, 0, 16 * 4);
+        if (hasBlock)
+            this->blockPainter(&chunk->image, origin, block);
+
+        chunk->blocks[i] = block;
+        chunk->hasBlock[i] = hasBlock;
+    }
+}
+
+// Remove the least recently drawn chunks until we're within the budget.
+// Chunks drawn by the most recent call to 'draw' are never evicted, they're still on screen.
+void ChunkCache::evict() {
+    while (this->chunks.size() > this->budget) {
+        auto oldest = this->chunks.end();
+        for (auto it = this->chunks.begin(); it != this->chunks.end(); it++) {
+            if (it->lastUsed < this->drawCount && (oldest == this->chunks.end() || it->lastUsed < oldest->lastUsed))
+                oldest = it;
+        }
+        if (oldest == this->chunks.end())
+            break;
+        this->chunks.erase(oldest);
+    }
+}
+
+void ChunkCache::invalidate() {
+    this->chunks.clear();
+}
+
+void ChunkCache::invalidate(const QRect &metatileRect) {
+    if (!metatileRect.isValid())
+        return;
+
+    for (int chunkY = chunkCoord(metatileRect.top()); chunkY <= chunkCoord(metatileRect.bottom()); chunkY++)
+    for (int chunkX = chunkCoord(metatileRect.left()); chunkX <= chunkCoord(metatileRect.right()); chunkX++) {
+        this->chunks.remove(chunkKey(chunkX, chunkY));
+    }
+}
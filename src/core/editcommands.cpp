@@ -25,8 +25,11 @@ int getEventTypeMask(QList<Event *> events) {
 }
 
 void renderBlocks(Layout *layout, bool ignoreCache = false) {
-    layout->layoutItem->draw(ignoreCache);
-    layout->collisionItem->draw(ignoreCache);
+    // Layouts that aren't open in the editor (e.g. in the benchmark command) have no items to draw.
+    if (layout->layoutItem)
+        layout->layoutItem->draw(ignoreCache);
+    if (layout->collisionItem)
+        layout->collisionItem->draw(ignoreCache);
 }
 
 PaintMetatile::PaintMetatile(Layout *layout,
@@ -21,6 +21,52 @@ Event* Event::create(Event::Type type) {
     }
 }
 
+void EventGraphics::setSpritesheet(const QImage &image) {
+    this->spritesheet = image;
+    this->loaded = true;
+    this->frames.clear();
+}
+
+QPixmap EventGraphics::getFrame(int frame, bool hFlip) {
+    // Inanimate sprites only have one frame, and aren't flipped.
+    if (this->inanimate) {
+        frame = 0;
+        hFlip = false;
+    }
+    const int key = (frame << 1) | (hFlip ? 1 : 0);
+    auto it = this->frames.constFind(key);
+    if (it != this->frames.constEnd())
+        return it.value();
+
+    QImage img;
+    if (this->inanimate) {
+        img = this->spritesheet.copy(0, 0, this->spriteWidth, this->spriteHeight);
+    } else {
+        int x = 0;
+        int y = 0;
+
+        // Get frame's position in spritesheet.
+        // Assume horizontal layout. If position would exceed sheet width, try vertical layout.
+        if ((frame + 1) * this->spriteWidth <= this->spritesheet.width()) {
+            x = frame * this->spriteWidth;
+        } else if ((frame + 1) * this->spriteHeight <= this->spritesheet.height()) {
+            y = frame * this->spriteHeight;
+        }
+
+        img = this->spritesheet.copy(x, y, this->spriteWidth, this->spriteHeight);
+
+        // Right-facing sprite is just the left-facing sprite mirrored
+        if (hFlip) {
+            img = img.mirrored(true, false);
+        }
+    }
+    // Set first palette color fully transparent.
+    img.setColor(0, qRgba(0, 0, 0, 0));
+    QPixmap pixmap = QPixmap::fromImage(img);
+    this->frames.insert(key, pixmap);
+    return pixmap;
+}
+
 Event::~Event() {
     if (this->eventFrame)
         this->eventFrame->deleteLater();
@@ -251,7 +297,7 @@ bool ObjectEvent::loadFromJson(QJsonObject json, Project *) {
 }
 
 void ObjectEvent::setDefaultValues(Project *project) {
-    this->setGfx(project->gfxDefines.keys().value(0, "0"));
+    this->setGfx(project->gfxDefineNames.value(0, "0"));
     this->setMovement(project->movementTypes.value(0, "0"));
     this->setScript("NULL");
     this->setTrainerType(project->trainerTypes.value(0, "0"));
@@ -290,13 +336,13 @@ void ObjectEvent::loadPixmap(Project *project) {
         // Invalid gfx constant.
         // If this is a number, try to use that instead.
         bool ok;
-        int altGfx = ParseUtil::gameStringToInt(this->gfx, &ok);
+        int altGfx = ParseUtil::gameStringToInt(this->gfx.toString(), &ok);
         if (ok && (altGfx < project->gfxDefines.count())) {
             eventGfx = project->eventGraphicsMap.value(project->gfxDefines.key(altGfx, "NULL"), nullptr);
         }
     }
-    if (!eventGfx || eventGfx->spritesheet.isNull()) {
-        // No sprite associated with this gfx constant.
+    if (!eventGfx || !project->requestEventSpritesheet(eventGfx) || eventGfx->spritesheet.isNull()) {
+        // No sprite associated with this gfx constant, or it hasn't been loaded yet.
         // Use default sprite instead.
         Event::loadPixmap(project);
         this->spriteWidth = 16;
@@ -310,31 +356,7 @@ void ObjectEvent::loadPixmap(Project *project) {
 
 void ObjectEvent::setPixmapFromSpritesheet(EventGraphics * gfx)
 {
-    QImage img;
-    if (gfx->inanimate) {
-        img = gfx->spritesheet.copy(0, 0, gfx->spriteWidth, gfx->spriteHeight);
-    } else {
-        int x = 0;
-        int y = 0;
-
-        // Get frame's position in spritesheet.
-        // Assume horizontal layout. If position would exceed sheet width, try vertical layout.
-        if ((this->frame + 1) * gfx->spriteWidth <= gfx->spritesheet.width()) {
-            x = this->frame * gfx->spriteWidth;
-        } else if ((this->frame + 1) * gfx->spriteHeight <= gfx->spritesheet.height()) {
-            y = this->frame * gfx->spriteHeight;
-        }
-
-        img = gfx->spritesheet.copy(x, y, gfx->spriteWidth, gfx->spriteHeight);
-
-        // Right-facing sprite is just the left-facing sprite mirrored
-        if (this->hFlip) {
-            img = img.transformed(QTransform().scale(-1, 1));
-        }
-    }
-    // Set first palette color fully transparent.
-    img.setColor(0, qRgba(0, 0, 0, 0));
-    pixmap = QPixmap::fromImage(img);
+    pixmap = gfx->getFrame(this->frame, this->hFlip);
     this->spriteWidth = gfx->spriteWidth;
     this->spriteHeight = gfx->spriteHeight;
     this->usingSprite = true;
@@ -422,7 +444,7 @@ bool CloneObjectEvent::loadFromJson(QJsonObject json, Project *project) {
 }
 
 void CloneObjectEvent::setDefaultValues(Project *project) {
-    this->setGfx(project->gfxDefines.keys().value(0, "0"));
+    this->setGfx(project->gfxDefineNames.value(0, "0"));
     this->setTargetID(1);
     if (this->getMap()) this->setTargetMap(this->getMap()->name);
 }
@@ -444,7 +466,7 @@ QSet<QString> CloneObjectEvent::getExpectedFields() {
 void CloneObjectEvent::loadPixmap(Project *project) {
     // Try to get the targeted object to clone
     int eventIndex = this->targetID - 1;
-    Map *clonedMap = project->getMap(this->targetMap);
+    Map *clonedMap = project->getMap(this->targetMap.toString());
     Event *clonedEvent = clonedMap ? clonedMap->events[Event::Group::Object].value(eventIndex, nullptr) : nullptr;
 
     if (clonedEvent && clonedEvent->getEventType() == Event::Type::Object) {
@@ -459,8 +481,8 @@ void CloneObjectEvent::loadPixmap(Project *project) {
     }
 
     EventGraphics *eventGfx = project->eventGraphicsMap.value(gfx, nullptr);
-    if (!eventGfx || eventGfx->spritesheet.isNull()) {
-        // No sprite associated with this gfx constant.
+    if (!eventGfx || !project->requestEventSpritesheet(eventGfx) || eventGfx->spritesheet.isNull()) {
+        // No sprite associated with this gfx constant, or it hasn't been loaded yet.
         // Use default sprite instead.
         Event::loadPixmap(project);
         this->spriteWidth = 16;
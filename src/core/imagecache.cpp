@@ -0,0 +1,132 @@
+#include "imagecache.h"
+
+#include <QCache>
+#include <QDateTime>
+#include <QFileInfo>
+#include <climits>
+
+// Costs are in KiB, so the budget can be larger than an int's worth of bytes.
+static QCache<QString, QImage> images(64 * 1024);
+
+static int imageCost(const QImage &image) {
+    return qMax(1, static_cast<int>(image.sizeInBytes() / 1024));
+}
+
+bool ImageCache::Transform::isIdentity() const {
+    return this->crop.isNull() && this->hScale == 1 && this->vScale == 1 && this->palette.isEmpty() && !this->setTransparency;
+}
+
+static QString fileKey(const QString &canonicalPath, const QDateTime &lastModified) {
+    return canonicalPath + "|" + QString::number(lastModified.toMSecsSinceEpoch()) + "|";
+}
+
+static QString transformKey(const ImageCache::Transform &transform) {
+    QString key = QString("%1,%2,%3,%4|%5,%6|%7|")
+                    .arg(transform.crop.x())
+                    .arg(transform.crop.y())
+                    .arg(transform.crop.width())
+                    .arg(transform.crop.height())
+                    .arg(transform.hScale)
+                    .arg(transform.vScale)
+                    .arg(transform.setTransparency);
+    for (QRgb color : transform.palette)
+        key += QString::number(color, 16) + ",";
+    return key;
+}
+
+static QImage applyTransform(QImage image, const ImageCache::Transform &transform) {
+    if (!transform.crop.isNull())
+        image = image.copy(transform.crop);
+
+    if (transform.hScale != 1 || transform.vScale != 1)
+        image = image.transformed(QTransform().scale(transform.hScale, transform.vScale));
+
+    for (int i = 0; i < transform.palette.size(); i++)
+        image.setColor(i, transform.palette.at(i));
+
+    if (transform.setTransparency)
+        image.setColor(0, qRgba(0, 0, 0, 0));
+
+    return image;
+}
+
+QImage ImageCache::get(const QString &filepath, const Transform &transform) {
+    const QFileInfo info(filepath);
+    if (!info.isFile())
+        return QImage();
+
+    const QString baseKey = fileKey(info.canonicalFilePath(), info.lastModified());
+    const QString key = transform.isIdentity() ? baseKey : baseKey + transformKey(transform);
+    const QImage *cached = images.object(key);
+    if (cached)
+        return *cached;
+
+    QImage image;
+    if (transform.isIdentity()) {
+        image = QImage(info.canonicalFilePath());
+        if (image.isNull())
+            return image;
+    } else {
+        const QImage baseImage = get(filepath);
+        if (baseImage.isNull())
+            return baseImage;
+        image = applyTransform(baseImage, transform);
+    }
+
+    // Images larger than the whole budget aren't kept.
+    images.insert(key, new QImage(image), imageCost(image));
+    return image;
+}
+
+QImage ImageCache::find(const QString &filepath) {
+    const QFileInfo info(filepath);
+    if (!info.isFile())
+        return QImage();
+    const QImage *cached = images.object(fileKey(info.canonicalFilePath(), info.lastModified()));
+    return cached ? *cached : QImage();
+}
+
+ImageCache::File ImageCache::read(const QString &filepath) {
+    const QFileInfo info(filepath);
+    File file;
+    if (!info.isFile())
+        return file;
+    // The time is read first, so if the file changes while it's decoded the image is cached under the old time and read again.
+    file.canonicalPath = info.canonicalFilePath();
+    file.lastModified = info.lastModified();
+    file.image = QImage(file.canonicalPath);
+    return file;
+}
+
+void ImageCache::insert(const File &file) {
+    if (file.image.isNull())
+        return;
+    images.insert(fileKey(file.canonicalPath, file.lastModified), new QImage(file.image), imageCost(file.image));
+}
+
+void ImageCache::remove(const QString &filepath) {
+    const QString prefix = QFileInfo(filepath).canonicalFilePath() + "|";
+    if (prefix.length() == 1)
+        return;
+    for (const QString &key : images.keys()) {
+        if (key.startsWith(prefix))
+            images.remove(key);
+    }
+}
+
+void ImageCache::clear() {
+    images.clear();
+}
+
+void ImageCache::setBudget(qint64 bytes) {
+    const qint64 cost = qBound(static_cast<qint64>(1), bytes / 1024, static_cast<qint64>(INT_MAX));
+    images.setMaxCost(static_cast<int>(cost));
+}
+
+qint64 ImageCache::budget() {
+    return static_cast<qint64>(images.maxCost()) * 1024;
+}
+
+qint64 ImageCache::size() {
+    return static_cast<qint64>(images.totalCost()) * 1024;
+}
@@ -0,0 +1,306 @@
+#include "indexedpng.h"
+
+#include <QFile>
+#include <QVector>
+#include <cstring>
+
+static const uchar pngSignature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+
+// Lookup tables for CRC-32 using the "slice-by-8" method. table[0] is the usual byte-at-a-time table,
+// and table[k] gives the CRC contribution of a byte that is followed by k more bytes.
+struct CrcTables {
+    quint32 table[8][256];
+    CrcTables() {
+        for (quint32 n = 0; n < 256; n++) {
+            quint32 c = n;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+            this->table[0][n] = c;
+        }
+        for (int n = 0; n < 256; n++)
+        for (int k = 1; k < 8; k++)
+            this->table[k][n] = (this->table[k - 1][n] >> 8) ^ this->table[0][this->table[k - 1][n] & 0xFF];
+    }
+};
+
+quint32 IndexedPng::crc32(const uchar *data, qsizetype length, quint32 crc) {
+    static const CrcTables tables;
+    const auto &t = tables.table;
+
+    crc = ~crc;
+    // Process 8 bytes per step. The lookups for each byte are independent of one another,
+    // rather than a chain of 8 lookups that each have to wait for the previous one.
+    while (length >= 8) {
+        const quint32 one = crc ^ (quint32(data[0]) | (quint32(data[1]) << 8) | (quint32(data[2]) << 16) | (quint32(data[3]) << 24));
+        const quint32 two = quint32(data[4]) | (quint32(data[5]) << 8) | (quint32(data[6]) << 16) | (quint32(data[7]) << 24);
+        crc = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF] ^ t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24]
+            ^ t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF] ^ t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+        data += 8;
+        length -= 8;
+    }
+    while (length-- > 0)
+        crc = t[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static quint32 readUInt32(const uchar *data) {
+    return (quint32(data[0]) << 24) | (quint32(data[1]) << 16) | (quint32(data[2]) << 8) | quint32(data[3]);
+}
+
+static void appendUInt32(QByteArray *data, quint32 value) {
+    const char bytes[4] = {
+        static_cast<char>((value >> 24) & 0xFF),
+        static_cast<char>((value >> 16) & 0xFF),
+        static_cast<char>((value >>  8) & 0xFF),
+        static_cast<char>((value >>  0) & 0xFF),
+    };
+    data->append(bytes, 4);
+}
+
+static void appendChunk(QByteArray *png, const char *type, const QByteArray &data) {
+    appendUInt32(png, data.size());
+    const qsizetype start = png->size();
+    png->append(type, 4);
+    png->append(data);
+    appendUInt32(png, IndexedPng::crc32(reinterpret_cast<const uchar*>(png->constData()) + start, png->size() - start));
+}
+
+// Reverses the filter applied to a row of image data. Paletted images never have more than one byte per pixel,
+// so the "previous pixel" used by each filter is always the previous byte.
+static bool unfilterRow(uchar *row, const uchar *prevRow, qsizetype length, int filter) {
+    switch (filter) {
+    case 0: // None
+        return true;
+    case 1: // Sub
+        for (qsizetype i = 1; i < length; i++)
+            row[i] += row[i - 1];
+        return true;
+    case 2: // Up
+        if (prevRow) {
+            for (qsizetype i = 0; i < length; i++)
+                row[i] += prevRow[i];
+        }
+        return true;
+    case 3: // Average
+        for (qsizetype i = 0; i < length; i++) {
+            const int left = (i > 0) ? row[i - 1] : 0;
+            const int up = prevRow ? prevRow[i] : 0;
+            row[i] += (left + up) / 2;
+        }
+        return true;
+    case 4: // Paeth
+        for (qsizetype i = 0; i < length; i++) {
+            const int a = (i > 0) ? row[i - 1] : 0;
+            const int b = prevRow ? prevRow[i] : 0;
+            const int c = (i > 0 && prevRow) ? prevRow[i - 1] : 0;
+            const int pa = qAbs(b - c);
+            const int pb = qAbs(a - c);
+            const int pc = qAbs(a + b - 2 * c);
+            row[i] += (pa <= pb && pa <= pc) ? a : ((pb <= pc) ? b : c);
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+QImage IndexedPng::read(const QString &filepath, QString *error) {
+    auto fail = [error](const QString &message) {
+        if (error) *error = message;
+        return QImage();
+    };
+
+    QFile file(filepath);
+    if (!file.open(QIODevice::ReadOnly))
+        return fail(file.errorString());
+    const QByteArray fileData = file.readAll();
+    file.close();
+
+    const uchar *data = reinterpret_cast<const uchar*>(fileData.constData());
+    const qsizetype size = fileData.size();
+    if (size < 8 || memcmp(data, pngSignature, 8) != 0)
+        return fail("Not a PNG file.");
+
+    int width = 0;
+    int height = 0;
+    int bitDepth = 0;
+    bool hasHeader = false;
+    QVector<QRgb> colors;
+    // The image data is preceded by 4 bytes reserved for the size header expected by qUncompress.
+    QByteArray compressed(4, 0);
+
+    qsizetype pos = 8;
+    while (true) {
+        if (size - pos < 12)
+            return fail("Unexpected end of file.");
+        const quint32 length = readUInt32(data + pos);
+        if (length > quint32(size - pos - 12))
+            return fail("Unexpected end of file.");
+        const uchar *type = data + pos + 4;
+        const uchar *chunk = data + pos + 8;
+        if (crc32(type, length + 4) != readUInt32(chunk + length))
+            return fail(QString("The '%1' chunk is corrupted.").arg(QString::fromLatin1(reinterpret_cast<const char*>(type), 4)));
+        pos += 12 + length;
+
+        if (memcmp(type, "IHDR", 4) == 0) {
+            if (length != 13)
+                return fail("Invalid IHDR chunk.");
+            const quint32 w = readUInt32(chunk);
+            const quint32 h = readUInt32(chunk + 4);
+            if (w == 0 || h == 0 || w > 0x7FFF || h > 0x7FFF)
+                return fail(QString("Unsupported image dimensions %1x%2.").arg(w).arg(h));
+            width = static_cast<int>(w);
+            height = static_cast<int>(h);
+            bitDepth = chunk[8];
+            if (chunk[9] != 3)
+                return fail("The image does not use a color palette.");
+            if (bitDepth != 1 && bitDepth != 2 && bitDepth != 4 && bitDepth != 8)
+                return fail(QString("Unsupported bit depth %1.").arg(bitDepth));
+            if (chunk[10] != 0 || chunk[11] != 0)
+                return fail("Unsupported compression or filter method.");
+            if (chunk[12] != 0)
+                return fail("Interlaced images are not supported.");
+            hasHeader = true;
+        } else if (memcmp(type, "PLTE", 4) == 0) {
+            if (length % 3 != 0 || length > 256 * 3)
+                return fail("Invalid PLTE chunk.");
+            colors.resize(length / 3);
+            for (int i = 0; i < colors.size(); i++)
+                colors[i] = qRgb(chunk[i * 3], chunk[i * 3 + 1], chunk[i * 3 + 2]);
+        } else if (memcmp(type, "tRNS", 4) == 0) {
+            for (int i = 0; i < qMin(static_cast<int>(length), colors.size()); i++)
+                colors[i] = qRgba(qRed(colors.at(i)), qGreen(colors.at(i)), qBlue(colors.at(i)), chunk[i]);
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            compressed.append(reinterpret_cast<const char*>(chunk), length);
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        // Any other chunks are ancillary, and don't affect the indexes of the pixels.
+    }
+    if (!hasHeader || colors.isEmpty())
+        return fail("Missing IHDR or PLTE chunk.");
+
+    // Each row of image data is a filter type byte followed by the packed pixels.
+    const qsizetype rowBytes = (static_cast<qsizetype>(width) * bitDepth + 7) / 8;
+    const qsizetype expectedSize = (rowBytes + 1) * height;
+    for (int i = 0; i < 4; i++)
+        compressed[i] = static_cast<char>((expectedSize >> (24 - i * 8)) & 0xFF);
+    QByteArray pixelData = qUncompress(compressed);
+    if (pixelData.size() < expectedSize)
+        return fail("Failed to decompress the image data.");
+
+    QImage image(width, height, QImage::Format_Indexed8);
+    if (image.isNull())
+        return fail("Not enough memory to load the image.");
+
+    const int mask = (1 << bitDepth) - 1;
+    int maxIndex = 0;
+    const uchar *prevRow = nullptr;
+    for (int y = 0; y < height; y++) {
+        uchar *row = reinterpret_cast<uchar*>(pixelData.data()) + y * (rowBytes + 1);
+        const int filter = *row++;
+        if (!unfilterRow(row, prevRow, rowBytes, filter))
+            return fail(QString("Invalid filter type %1.").arg(filter));
+
+        uchar *dest = image.scanLine(y);
+        if (bitDepth == 8) {
+            memcpy(dest, row, width);
+        } else {
+            for (int x = 0; x < width; x++) {
+                const int bit = x * bitDepth;
+                dest[x] = (row[bit / 8] >> (8 - bitDepth - bit % 8)) & mask;
+            }
+        }
+        for (int x = 0; x < width; x++) {
+            if (dest[x] > maxIndex)
+                maxIndex = dest[x];
+        }
+        prevRow = row;
+    }
+
+    // Make sure every pixel refers to a color in the color table.
+    while (colors.size() <= maxIndex)
+        colors.append(qRgb(0, 0, 0));
+    image.setColorTable(colors);
+    return image;
+}
+
+bool IndexedPng::write(const QImage &source, const QString &filepath, int bitDepth, QString *error) {
+    auto fail = [error](const QString &message) {
+        if (error) *error = message;
+        return false;
+    };
+
+    if (source.isNull())
+        return fail("The image is null.");
+    if (bitDepth != 1 && bitDepth != 2 && bitDepth != 4 && bitDepth != 8)
+        return fail(QString("Unsupported bit depth %1.").arg(bitDepth));
+
+    const QImage image = (source.format() == QImage::Format_Indexed8) ? source : source.convertToFormat(QImage::Format_Indexed8);
+    const int width = image.width();
+    const int height = image.height();
+
+    QByteArray ihdr;
+    appendUInt32(&ihdr, width);
+    appendUInt32(&ihdr, height);
+    ihdr.append(static_cast<char>(bitDepth));
+    ihdr.append(static_cast<char>(3)); // indexed color type
+    ihdr.append(static_cast<char>(0)); // compression method
+    ihdr.append(static_cast<char>(0)); // filter method
+    ihdr.append(static_cast<char>(0)); // interlace method
+
+    // The palette may not have more colors than the bit depth can index, and must have at least one.
+    const QVector<QRgb> colorTable = image.colorTable();
+    const int numColors = qBound(1, static_cast<int>(colorTable.size()), 1 << bitDepth);
+    QByteArray plte(numColors * 3, 0);
+    QByteArray trns(numColors, static_cast<char>(0xFF));
+    bool hasAlpha = false;
+    for (int i = 0; i < qMin(numColors, static_cast<int>(colorTable.size())); i++) {
+        const QRgb color = colorTable.at(i);
+        plte[i * 3] = static_cast<char>(qRed(color));
+        plte[i * 3 + 1] = static_cast<char>(qGreen(color));
+        plte[i * 3 + 2] = static_cast<char>(qBlue(color));
+        trns[i] = static_cast<char>(qAlpha(color));
+        if (qAlpha(color) != 0xFF)
+            hasAlpha = true;
+    }
+
+    // Every row uses filter type 0 (None), followed by the pixel indexes packed into whole bytes.
+    const qsizetype rowBytes = (static_cast<qsizetype>(width) * bitDepth + 7) / 8;
+    QByteArray pixelData((rowBytes + 1) * height, 0);
+    const int mask = (1 << bitDepth) - 1;
+    for (int y = 0; y < height; y++) {
+        uchar *row = reinterpret_cast<uchar*>(pixelData.data()) + y * (rowBytes + 1) + 1;
+        const uchar *pixels = image.constScanLine(y);
+        if (bitDepth == 8) {
+            memcpy(row, pixels, width);
+        } else {
+            for (int x = 0; x < width; x++) {
+                const int bit = x * bitDepth;
+                row[bit / 8] |= (pixels[x] & mask) << (8 - bitDepth - bit % 8);
+            }
+        }
+    }
+    QByteArray compressedPixelData = qCompress(pixelData);
+    // Qt's qCompress/qDecompress use a pointless 4-byte header, even though
+    // they are using DEFLATE under the hood. If we strip the 4-byte header,
+    // it's perfectly compatible with the PNG compression spec.
+    compressedPixelData.remove(0, 4);
+
+    QByteArray png;
+    png.reserve(8 + 12 * 5 + ihdr.size() + plte.size() + trns.size() + compressedPixelData.size());
+    png.append(reinterpret_cast<const char*>(pngSignature), 8);
+    appendChunk(&png, "IHDR", ihdr);
+    appendChunk(&png, "PLTE", plte);
+    if (hasAlpha)
+        appendChunk(&png, "tRNS", trns);
+    appendChunk(&png, "IDAT", compressedPixelData);
+    appendChunk(&png, "IEND", QByteArray());
+
+    QFile file(filepath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return fail(file.errorString());
+    if (file.write(png) != png.size())
+        return fail(file.errorString());
+    return true;
+}
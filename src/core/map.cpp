@@ -96,20 +96,6 @@ QRect Map::getConnectionRect(const QString &direction, Layout * fromLayout) {
     return QRect(x, y, w, h);
 }
 
-QPixmap Map::renderConnection(const QString &direction, Layout * fromLayout) {
-    QRect bounds = getConnectionRect(direction, fromLayout);
-    if (!bounds.isValid())
-        return QPixmap();
-
-    // 'fromLayout' will be used in 'render' to get the palettes from the parent map.
-    // Dive/Emerge connections render normally with their own palettes, so we ignore this.
-    if (MapConnection::isDiving(direction))
-        fromLayout = nullptr;
-
-    QPixmap connectionPixmap = this->layout->render(true, fromLayout, bounds);
-    return connectionPixmap.copy(bounds.x() * 16, bounds.y() * 16, bounds.width() * 16, bounds.height() * 16);
-}
-
 void Map::openScript(QString label) {
     emit openScriptRequested(label);
 }
@@ -60,12 +60,66 @@ Map* MapConnection::targetMap() const {
     return getMap(m_targetMapName);
 }
 
-QPixmap MapConnection::getPixmap() {
+static size_t getPaletteKey(Tileset *primaryTileset, Tileset *secondaryTileset) {
+    size_t key = 0;
+    if (primaryTileset)
+        key = qHash(primaryTileset->palettePreviews, key);
+    if (secondaryTileset)
+        key = qHash(secondaryTileset->palettePreviews, key);
+    return key;
+}
+
+// Render the part of the connected map that's visible from the parent map.
+// This works from a copy of only the visible blocks, and never touches the connected layout's own image.
+// The result is reused until the visible blocks, the tilesets/palettes used to draw them (or their contents), or the direction change.
+QPixmap MapConnection::getPixmap(bool forceRender) {
     auto map = targetMap();
-    if (!map)
+    if (!map || !map->layout)
+        return QPixmap();
+
+    Layout *parentLayout = m_parentMap ? m_parentMap->layout : nullptr;
+    const QRect bounds = map->getConnectionRect(m_direction, parentLayout);
+    if (!bounds.isValid())
         return QPixmap();
 
-    return map->renderConnection(m_direction, m_parentMap ? m_parentMap->layout : nullptr);
+    // Cardinal connections are drawn with the parent map's tilesets.
+    // Dive/Emerge connections render normally with their own tilesets.
+    Layout *tilesetLayout = (parentLayout && !isDiving(m_direction)) ? parentLayout : map->layout;
+    Tileset *primaryTileset = tilesetLayout->tileset_primary;
+    Tileset *secondaryTileset = tilesetLayout->tileset_secondary;
+
+    const Blockdata blocks = map->layout->getBlocks(bounds);
+    const size_t paletteKey = getPaletteKey(primaryTileset, secondaryTileset);
+    // Tilesets are reloaded in place (e.g. after the Tileset Editor saves), so the pointers alone don't show that they changed.
+    const quint64 primaryRevision = primaryTileset ? primaryTileset->revision() : 0;
+    const quint64 secondaryRevision = secondaryTileset ? secondaryTileset->revision() : 0;
+
+    auto &cache = m_pixmapCache;
+    if (!forceRender
+     && !cache.pixmap.isNull()
+     && cache.layout == map->layout
+     && cache.direction == m_direction
+     && cache.bounds == bounds
+     && cache.primaryTileset == primaryTileset
+     && cache.secondaryTileset == secondaryTileset
+     && cache.primaryRevision == primaryRevision
+     && cache.secondaryRevision == secondaryRevision
+     && cache.paletteKey == paletteKey
+     && cache.blocks == blocks) {
+        return cache.pixmap;
+    }
+
+    cache.pixmap = QPixmap::fromImage(map->layout->renderBlocks(blocks, bounds.width(), primaryTileset, secondaryTileset));
+    cache.blocks = blocks;
+    cache.bounds = bounds;
+    cache.direction = m_direction;
+    cache.layout = map->layout;
+    cache.primaryTileset = primaryTileset;
+    cache.secondaryTileset = secondaryTileset;
+    cache.primaryRevision = primaryRevision;
+    cache.secondaryRevision = secondaryRevision;
+    cache.paletteKey = paletteKey;
+    return cache.pixmap;
 }
 
 void MapConnection::setParentMap(Map* map, bool mirror) {
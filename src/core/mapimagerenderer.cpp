@@ -0,0 +1,259 @@
+#include "mapimagerenderer.h"
+#include "project.h"
+#include "map.h"
+#include "mapconnection.h"
+#include "events.h"
+#include "tracer.h"
+
+#include <QPainter>
+#include <QSet>
+#include <climits>
+
+MapImageRenderer::MapImageRenderer(Project *project, const ImageExporterSettings &settings, int borderDistance) :
+    project(project),
+    settings(settings),
+    borderDistance(borderDistance)
+{ }
+
+// The position of a connection's image relative to its parent map, in pixels. This is where the editor shows it.
+static QPoint getConnectionPos(MapConnection *connection) {
+    Map *parentMap = connection->parentMap();
+    Map *targetMap = connection->targetMap();
+    const QString direction = connection->direction();
+    int x = 0, y = 0;
+
+    if (direction == "right") {
+        if (parentMap) x = parentMap->getWidth();
+        y = connection->offset();
+    } else if (direction == "down") {
+        if (parentMap) y = parentMap->getHeight();
+        x = connection->offset();
+    } else if (direction == "left") {
+        if (targetMap) x = -targetMap->getConnectionRect(direction).width();
+        y = connection->offset();
+    } else if (direction == "up") {
+        if (targetMap) y = -targetMap->getConnectionRect(direction).height();
+        x = connection->offset();
+    }
+    return QPoint(x * 16, y * 16);
+}
+
+QPixmap MapImageRenderer::render(Map *map, Layout *layout, bool ignoreBorder) const {
+    TRACE_SCOPE("MapImageRenderer::render");
+    if (map)
+        layout = map->layout;
+    if (!layout)
+        return QPixmap();
+
+    // draw background layer / base image
+    QPixmap pixmap = layout->render(true);
+
+    if (this->settings.showCollision) {
+        QPainter collisionPainter(&pixmap);
+        collisionPainter.setOpacity(this->settings.collisionOpacity);
+        collisionPainter.drawPixmap(0, 0, layout->renderCollision());
+        collisionPainter.end();
+    }
+
+    // draw map border
+    int borderHeight = 0, borderWidth = 0;
+    if (!ignoreBorder && this->settings.showBorder) {
+        const QPixmap borderPixmap = layout->renderBorder();
+        int borderHorzDist = Layout::getBorderDrawDistance(layout->getBorderWidth());
+        int borderVertDist = Layout::getBorderDrawDistance(layout->getBorderHeight());
+        borderWidth = this->borderDistance * 16;
+        borderHeight = this->borderDistance * 16;
+        QPixmap newPixmap = QPixmap(pixmap.width() + borderWidth * 2, pixmap.height() + borderHeight * 2);
+        QPainter borderPainter(&newPixmap);
+        if (layout->getBorderWidth() > 0 && layout->getBorderHeight() > 0) {
+            for (int y = this->borderDistance - borderVertDist; y < layout->getHeight() + borderVertDist * 2; y += layout->getBorderHeight()) {
+                for (int x = this->borderDistance - borderHorzDist; x < layout->getWidth() + borderHorzDist * 2; x += layout->getBorderWidth()) {
+                    borderPainter.drawPixmap(x * 16, y * 16, borderPixmap);
+                }
+            }
+        }
+        borderPainter.drawPixmap(borderWidth, borderHeight, pixmap);
+        borderPainter.end();
+        pixmap = newPixmap;
+    }
+
+    if (map && !ignoreBorder && this->settings.showConnections()) {
+        // if showing connections, draw on outside of image
+        QPainter connectionPainter(&pixmap);
+        for (MapConnection *connection : map->getConnections()) {
+            const QString direction = connection->direction();
+            if ((this->settings.showUpConnections && direction == "up")
+             || (this->settings.showDownConnections && direction == "down")
+             || (this->settings.showLeftConnections && direction == "left")
+             || (this->settings.showRightConnections && direction == "right"))
+                connectionPainter.drawPixmap(getConnectionPos(connection) + QPoint(borderWidth, borderHeight), connection->getPixmap());
+        }
+        connectionPainter.end();
+    }
+
+    // draw events
+    if (map && this->project && this->settings.showEvents()) {
+        QList<Event *> events;
+        for (const auto &event : map->getAllEvents()) {
+            Event::Group group = event->getEventGroup();
+            if ((this->settings.showObjects && group == Event::Group::Object)
+             || (this->settings.showWarps && group == Event::Group::Warp)
+             || (this->settings.showBGs && group == Event::Group::Bg)
+             || (this->settings.showTriggers && group == Event::Group::Coord)
+             || (this->settings.showHealLocations && group == Event::Group::Heal)) {
+                this->project->setEventPixmap(event);
+                events.append(event);
+            }
+        }
+        // Sprites that haven't been loaded yet are decoded in the background, but the image needs them now.
+        this->project->waitForEventSpritesheets();
+
+        QPainter eventPainter(&pixmap);
+        for (const auto &event : events) {
+            if (!event->getUsingSprite())
+                this->project->setEventPixmap(event, true);
+            eventPainter.drawPixmap(event->getPixelX() + borderWidth, event->getPixelY() + borderHeight, event->getPixmap());
+        }
+        eventPainter.end();
+    }
+
+    // draw grid directly onto the pixmap
+    // since the last grid lines are outside of the pixmap, add a pixel to the bottom and right
+    if (this->settings.showGrid) {
+        int addX = 1, addY = 1;
+        if (borderHeight) addY = 0;
+        if (borderWidth) addX = 0;
+
+        QPixmap newPixmap = QPixmap(pixmap.width() + addX, pixmap.height() + addY);
+        QPainter gridPainter(&newPixmap);
+        gridPainter.drawPixmap(0, 0, pixmap);
+        for (int x = 0; x < newPixmap.width(); x += 16) {
+            gridPainter.drawLine(x, 0, x, newPixmap.height());
+        }
+        for (int y = 0; y < newPixmap.height(); y += 16) {
+            gridPainter.drawLine(0, y, newPixmap.width(), y);
+        }
+        gridPainter.end();
+        pixmap = newPixmap;
+    }
+
+    return pixmap;
+}
+
+struct StitchedMap {
+    int x;
+    int y;
+    Map* map;
+};
+
+QPixmap MapImageRenderer::renderStitched(Map *startMap, const Progress &progress) const {
+    TRACE_SCOPE("MapImageRenderer::renderStitched");
+    if (!startMap)
+        return QPixmap();
+
+    auto report = [&progress](const QString &label, int value, int maximum) {
+        return !progress || progress(label, value, maximum);
+    };
+
+    // Do a breadth-first search to gather a collection of
+    // all reachable maps with their relative offsets.
+    QSet<QString> visited;
+    QList<StitchedMap> stitchedMaps;
+    QList<StitchedMap> unvisited;
+    unvisited.append(StitchedMap{0, 0, startMap});
+
+    while (!unvisited.isEmpty()) {
+        if (!report("Gathering stitched maps...", visited.size(), visited.size() + unvisited.size()))
+            return QPixmap();
+
+        StitchedMap cur = unvisited.takeFirst();
+        if (visited.contains(cur.map->name))
+            continue;
+        visited.insert(cur.map->name);
+        stitchedMaps.append(cur);
+
+        for (MapConnection *connection : cur.map->getConnections()) {
+            const QString direction = connection->direction();
+            int x = cur.x;
+            int y = cur.y;
+            int offset = connection->offset();
+            Map *connectionMap = connection->targetMap();
+            if (!connectionMap)
+                continue;
+            if (direction == "up") {
+                x += offset;
+                y -= connectionMap->getHeight();
+            } else if (direction == "down") {
+                x += offset;
+                y += cur.map->getHeight();
+            } else if (direction == "left") {
+                x -= connectionMap->getWidth();
+                y += offset;
+            } else if (direction == "right") {
+                x += cur.map->getWidth();
+                y += offset;
+            } else {
+                // Ignore Dive/Emerge connections and unrecognized directions
+                continue;
+            }
+            unvisited.append(StitchedMap{x, y, connectionMap});
+        }
+    }
+
+    // Determine the overall dimensions of the stitched maps.
+    int maxX = INT_MIN;
+    int minX = INT_MAX;
+    int maxY = INT_MIN;
+    int minY = INT_MAX;
+    for (const StitchedMap &map : stitchedMaps) {
+        minX = qMin(minX, map.x);
+        minY = qMin(minY, map.y);
+        maxX = qMax(maxX, map.x + map.map->getWidth());
+        maxY = qMax(maxY, map.y + map.map->getHeight());
+    }
+
+    const bool includeBorder = this->settings.showBorder;
+    if (includeBorder) {
+        minX -= this->borderDistance;
+        maxX += this->borderDistance;
+        minY -= this->borderDistance;
+        maxY += this->borderDistance;
+    }
+
+    // Draw the maps on the full canvas, while taking
+    // their respective offsets into account.
+    QPixmap stitchedPixmap((maxX - minX) * 16, (maxY - minY) * 16);
+    stitchedPixmap.fill(Qt::black);
+    QPainter painter(&stitchedPixmap);
+    int numDrawn = 0;
+    for (const StitchedMap &map : stitchedMaps) {
+        if (!report("Drawing stitched maps...", numDrawn++, stitchedMaps.size()))
+            return QPixmap();
+
+        int pixelX = (map.x - minX) * 16;
+        int pixelY = (map.y - minY) * 16;
+        if (includeBorder) {
+            pixelX -= this->borderDistance * 16;
+            pixelY -= this->borderDistance * 16;
+        }
+        painter.drawPixmap(pixelX, pixelY, render(map.map, nullptr));
+    }
+
+    // When including the borders, we simply draw all the maps again
+    // without their borders, since the first pass results in maps
+    // being occluded by other map borders.
+    if (includeBorder) {
+        numDrawn = 0;
+        for (const StitchedMap &map : stitchedMaps) {
+            if (!report("Drawing stitched maps without borders...", numDrawn++, stitchedMaps.size()))
+                return QPixmap();
+
+            int pixelX = (map.x - minX) * 16;
+            int pixelY = (map.y - minY) * 16;
+            painter.drawPixmap(pixelX, pixelY, render(map.map, nullptr, true));
+        }
+    }
+    painter.end();
+
+    return stitchedPixmap;
+}
@@ -1,12 +1,26 @@
 #include "maplayout.h"
+#include "map.h"
 
 #include <QRegularExpression>
 
 #include "scripting.h"
 #include "imageproviders.h"
+#include "chunkcache.h"
+#include "tracer.h"
 
 
 
+int Layout::getBorderDrawDistance(int dimension) {
+    // Draw sufficient border blocks to fill the player's view (BORDER_DISTANCE)
+    if (dimension >= BORDER_DISTANCE) {
+        return dimension;
+    } else if (dimension) {
+        return dimension * (BORDER_DISTANCE / dimension + (BORDER_DISTANCE % dimension ? 1 : 0));
+    } else {
+        return BORDER_DISTANCE;
+    }
+}
+
 Layout *Layout::copy() {
     Layout *layout = new Layout;
     layout->copyFrom(this);
@@ -120,12 +134,6 @@ void Layout::cacheBlockdata() {
         this->cached_blockdata.append(block);
 }
 
-void Layout::cacheCollision() {
-    this->cached_collision.clear();
-    for (const auto &block : this->blockdata)
-        this->cached_collision.append(block);
-}
-
 bool Layout::layoutBlockChanged(int i, const Blockdata &cache) {
     if (cache.length() <= i)
         return true;
@@ -299,7 +307,8 @@ void Layout::magicFillCollisionElevation(int initialX, int initialY, uint16_t co
     }
 }
 
-QPixmap Layout::render(bool ignoreCache, Layout *fromLayout, QRect bounds) {
+QPixmap Layout::render(bool ignoreCache) {
+    TRACE_SCOPE("Layout::render");
     bool changed_any = false;
     int width_ = getWidth();
     int height_ = getHeight();
@@ -307,6 +316,16 @@ QPixmap Layout::render(bool ignoreCache, Layout *fromLayout, QRect bounds) {
         image = QImage(width_ * 16, height_ * 16, QImage::Format_RGBA8888);
         changed_any = true;
     }
+    const quint64 primaryRevision = this->tileset_primary ? this->tileset_primary->revision() : 0;
+    const quint64 secondaryRevision = this->tileset_secondary ? this->tileset_secondary->revision() : 0;
+    if (cached_tilesets.primary != this->tileset_primary || cached_tilesets.primaryRevision != primaryRevision
+     || cached_tilesets.secondary != this->tileset_secondary || cached_tilesets.secondaryRevision != secondaryRevision) {
+        cached_tilesets.primary = this->tileset_primary;
+        cached_tilesets.secondary = this->tileset_secondary;
+        cached_tilesets.primaryRevision = primaryRevision;
+        cached_tilesets.secondaryRevision = secondaryRevision;
+        ignoreCache = true;
+    }
     if (this->blockdata.isEmpty() || !width_ || !height_) {
         pixmap = pixmap.fromImage(image);
         return pixmap;
@@ -320,15 +339,12 @@ QPixmap Layout::render(bool ignoreCache, Layout *fromLayout, QRect bounds) {
         changed_any = true;
         int map_y = width_ ? i / width_ : 0;
         int map_x = width_ ? i % width_ : 0;
-        if (bounds.isValid() && !bounds.contains(map_x, map_y)) {
-            continue;
-        }
         QPoint metatile_origin = QPoint(map_x * 16, map_y * 16);
         Block block = this->blockdata.at(i);
         QImage metatile_image = getMetatileImage(
             block.metatileId(),
-            fromLayout ? fromLayout->tileset_primary   : this->tileset_primary,
-            fromLayout ? fromLayout->tileset_secondary : this->tileset_secondary,
+            this->tileset_primary,
+            this->tileset_secondary,
             metatileLayerOrder,
             metatileLayerOpacity
         );
@@ -343,36 +359,60 @@ QPixmap Layout::render(bool ignoreCache, Layout *fromLayout, QRect bounds) {
     return pixmap;
 }
 
-QPixmap Layout::renderCollision(bool ignoreCache) {
-    bool changed_any = false;
-    int width_ = getWidth();
-    int height_ = getHeight();
-    if (collision_image.isNull() || collision_image.width() != width_ * 16 || collision_image.height() != height_ * 16) {
-        collision_image = QImage(width_ * 16, height_ * 16, QImage::Format_RGBA8888);
-        changed_any = true;
-    }
-    if (this->blockdata.isEmpty() || !width_ || !height_) {
-        collision_pixmap = collision_pixmap.fromImage(collision_image);
-        return collision_pixmap;
+// Copy the blocks within the given area (in metatiles). Positions outside the layout are left as empty blocks.
+Blockdata Layout::getBlocks(const QRect &area) {
+    Blockdata blocks;
+    if (!area.isValid())
+        return blocks;
+
+    blocks.reserve(area.width() * area.height());
+    for (int y = area.top(); y <= area.bottom(); y++)
+    for (int x = area.left(); x <= area.right(); x++) {
+        Block block;
+        getBlock(x, y, &block);
+        blocks.append(block);
     }
-    QPainter painter(&collision_image);
-    for (int i = 0; i < this->blockdata.length(); i++) {
-        if (!ignoreCache && !layoutBlockChanged(i, this->cached_collision)) {
-            continue;
+    return blocks;
+}
+
+// Render a set of blocks (e.g. from getBlocks) into a new image, without touching the layout's own image.
+// The tilesets are specified separately because map connections are drawn using the parent map's tilesets.
+QImage Layout::renderBlocks(const Blockdata &blocks, int blocksWidth, Tileset *primaryTileset, Tileset *secondaryTileset) const {
+    if (blocksWidth <= 0 || blocks.isEmpty())
+        return QImage();
+
+    const int blocksHeight = (blocks.length() + blocksWidth - 1) / blocksWidth;
+    QImage image(blocksWidth * 16, blocksHeight * 16, QImage::Format_RGBA8888);
+    image.fill(Qt::transparent);
+
+    QHash<uint16_t, QImage> metatileImages;
+    QPainter painter(&image);
+    for (int i = 0; i < blocks.length(); i++) {
+        const uint16_t metatileId = blocks.at(i).metatileId();
+        auto it = metatileImages.find(metatileId);
+        if (it == metatileImages.end()) {
+            it = metatileImages.insert(metatileId, getMetatileImage(metatileId, primaryTileset, secondaryTileset,
+                                                                    this->metatileLayerOrder, this->metatileLayerOpacity));
         }
-        changed_any = true;
-        Block block = this->blockdata.at(i);
-        QImage collision_metatile_image = getCollisionMetatileImage(block);
-        int map_y = width_ ? i / width_ : 0;
-        int map_x = width_ ? i % width_ : 0;
-        QPoint metatile_origin = QPoint(map_x * 16, map_y * 16);
-        painter.drawImage(metatile_origin, collision_metatile_image);
+        painter.drawImage((i % blocksWidth) * 16, (i / blocksWidth) * 16, it.value());
     }
     painter.end();
-    cacheCollision();
-    if (changed_any) {
-        collision_pixmap = collision_pixmap.fromImage(collision_image);
+    return image;
+}
+
+// Collision icons are copied straight out of the collision atlas, so the image shares its format.
+QPixmap Layout::renderCollision() {
+    int width_ = getWidth();
+    int height_ = getHeight();
+    if (collision_image.isNull() || collision_image.width() != width_ * 16 || collision_image.height() != height_ * 16) {
+        collision_image = QImage(width_ * 16, height_ * 16, ChunkCache::imageFormat);
+    }
+    collision_image.fill(Qt::transparent);
+    for (int i = 0; width_ && i < this->blockdata.length(); i++) {
+        const Block &block = this->blockdata.at(i);
+        drawCollisionMetatile(&collision_image, QPoint((i % width_) * 16, (i / width_) * 16), block.collision(), block.elevation());
     }
+    collision_pixmap = collision_pixmap.fromImage(collision_image);
     return collision_pixmap;
 }
 
@@ -414,10 +454,6 @@ QPixmap Layout::renderBorder(bool ignoreCache) {
     return this->border_pixmap;
 }
 
-QPixmap Layout::getLayoutItemPixmap() {
-    return this->layoutItem ? this->layoutItem->pixmap() : QPixmap();
-}
-
 bool Layout::hasUnsavedChanges() const {
     return !this->editHistory.isClean();
 }
@@ -3,94 +3,108 @@
 #include "log.h"
 #include "project.h"
 
+#include <QtConcurrent>
+
 MapParser::MapParser()
 {
 }
 
 Layout *MapParser::parse(QString filepath, bool *error, Project *project)
 {
+    const MapData data = read(filepath);
+    if (data.error) {
+        *error = true;
+        return nullptr;
+    }
+    return createLayout(data, project);
+}
+
+QList<Layout *> MapParser::parseAll(const QStringList &filepaths, Project *project)
+{
+    const QList<MapData> results = QtConcurrent::blockingMapped<QList<MapData>>(filepaths, &MapParser::read);
+
+    // Layouts are QObjects, so they're created here rather than on the threads that read the files.
+    QList<Layout *> layouts;
+    for (const MapData &data : results)
+        layouts.append(data.error ? nullptr : createLayout(data, project));
+    return layouts;
+}
+
+MapParser::MapData MapParser::read(const QString &filepath)
+{
+    MapData data;
     QFile file(filepath);
     if (!file.open(QIODevice::ReadOnly)) {
-        *error = true;
+        data.error = true;
         logError(QString("Could not open Advance Map 1.92 Map .map file '%1': ").arg(filepath) + file.errorString());
-        return nullptr;
+        return data;
     }
 
     QByteArray in = file.readAll();
     file.close();
 
     if (in.length() < 20 || in.length() % 2 != 0) {
-        *error = true;
+        data.error = true;
         logError(QString("Advance Map 1.92 Map .map file '%1' is an unexpected size.").arg(filepath));
-        return nullptr;
+        return data;
     }
 
-    int borderWidth = static_cast<unsigned char>(in.at(16)); // 0 in RSE .map files
-    int borderHeight = static_cast<unsigned char>(in.at(17)); // 0 in RSE .map files
-    int numBorderTiles = borderWidth * borderHeight; // 0 if RSE
+    auto readInt = [&in](int offset) {
+        return static_cast<unsigned char>(in.at(offset)) |
+              (static_cast<unsigned char>(in.at(offset + 1)) << 8) |
+              (static_cast<unsigned char>(in.at(offset + 2)) << 16) |
+              (static_cast<unsigned char>(in.at(offset + 3)) << 24);
+    };
+
+    data.borderWidth = static_cast<unsigned char>(in.at(16)); // 0 in RSE .map files
+    data.borderHeight = static_cast<unsigned char>(in.at(17)); // 0 in RSE .map files
+    int numBorderTiles = data.borderWidth * data.borderHeight; // 0 if RSE
 
     int mapDataOffset = 20 + (numBorderTiles * 2); // FRLG .map files store border metatile data after the header
-    int mapWidth = static_cast<unsigned char>(in.at(0)) |
-                   (static_cast<unsigned char>(in.at(1)) << 8) |
-                   (static_cast<unsigned char>(in.at(2)) << 16) |
-                   (static_cast<unsigned char>(in.at(3)) << 24);
-    int mapHeight = static_cast<unsigned char>(in.at(4)) |
-                    (static_cast<unsigned char>(in.at(5)) << 8) |
-                    (static_cast<unsigned char>(in.at(6)) << 16) |
-                    (static_cast<unsigned char>(in.at(7)) << 24);
-    int mapPrimaryTilesetNum = static_cast<unsigned char>(in.at(8)) |
-                               (static_cast<unsigned char>(in.at(9)) << 8) |
-                               (static_cast<unsigned char>(in.at(10)) << 16) |
-                               (static_cast<unsigned char>(in.at(11)) << 24);
-    int mapSecondaryTilesetNum = static_cast<unsigned char>(in.at(12)) |
-                                 (static_cast<unsigned char>(in.at(13)) << 8) |
-                                 (static_cast<unsigned char>(in.at(14)) << 16) |
-                                 (static_cast<unsigned char>(in.at(15)) << 24);
-
-    int numMetatiles = mapWidth * mapHeight;
-    int expectedFileSize = 20 + (numBorderTiles * 2) + (numMetatiles * 2);
-    if (in.length() != expectedFileSize) {
-        *error = true;
-        logError(QString(".map file is an unexpected size. Expected %1 bytes, but it has %2 bytes.").arg(expectedFileSize).arg(in.length()));
-        return nullptr;
-    }
+    data.width = readInt(0);
+    data.height = readInt(4);
+    data.primaryTilesetNum = readInt(8);
+    data.secondaryTilesetNum = readInt(12);
 
-    Blockdata blockdata;
-    for (int i = mapDataOffset; (i + 1) < in.length(); i += 2) {
-        uint16_t word = static_cast<uint16_t>((in[i] & 0xff) + ((in[i + 1] & 0xff) << 8));
-        blockdata.append(word);
+    qint64 numMetatiles = static_cast<qint64>(data.width) * data.height;
+    qint64 expectedFileSize = 20 + (numBorderTiles * 2) + (numMetatiles * 2);
+    if (in.length() != expectedFileSize) {
+        data.error = true;
+        logError(QString(".map file '%1' is an unexpected size. Expected %2 bytes, but it has %3 bytes.").arg(filepath).arg(expectedFileSize).arg(in.length()));
+        return data;
     }
 
-    Blockdata border;
-    if (numBorderTiles != 0) {
-        for (int i = 20; (i + 1) < mapDataOffset; i += 2) {
-            uint16_t word = static_cast<uint16_t>((in[i] & 0xff) + ((in[i + 1] & 0xff) << 8));
-            border.append(word);
-        }
-    }
+    // The blocks are decoded in bulk from the file's little-endian words.
+    data.blockdata = BlockdataView(in.mid(mapDataOffset)).toBlockdata();
+    if (numBorderTiles != 0)
+        data.border = BlockdataView(in.mid(20, numBorderTiles * 2)).toBlockdata();
+    return data;
+}
 
+Layout *MapParser::createLayout(const MapData &data, Project *project)
+{
     Layout *mapLayout = new Layout();
-    mapLayout->width = mapWidth;
-    mapLayout->height = mapHeight;
-    mapLayout->border_width = (borderWidth == 0) ?  DEFAULT_BORDER_WIDTH : borderWidth;
-    mapLayout->border_height = (borderHeight == 0) ?  DEFAULT_BORDER_HEIGHT : borderHeight;
+    mapLayout->width = data.width;
+    mapLayout->height = data.height;
+    mapLayout->border_width = (data.borderWidth == 0) ?  DEFAULT_BORDER_WIDTH : data.borderWidth;
+    mapLayout->border_height = (data.borderHeight == 0) ?  DEFAULT_BORDER_HEIGHT : data.borderHeight;
 
     QList<QString> tilesets = project->tilesetLabelsOrdered;
 
-    if (mapPrimaryTilesetNum > tilesets.size())
+    if (data.primaryTilesetNum < 0 || data.primaryTilesetNum >= tilesets.size())
         mapLayout->tileset_primary_label = tilesets.at(0);
     else
-        mapLayout->tileset_primary_label = tilesets.at(mapPrimaryTilesetNum);
+        mapLayout->tileset_primary_label = tilesets.at(data.primaryTilesetNum);
 
-    if (mapSecondaryTilesetNum > tilesets.size())
+    if (data.secondaryTilesetNum < 0 || data.secondaryTilesetNum >= tilesets.size())
         mapLayout->tileset_secondary_label = tilesets.at(1);
     else
-        mapLayout->tileset_secondary_label = tilesets.at(mapSecondaryTilesetNum);
+        mapLayout->tileset_secondary_label = tilesets.at(data.secondaryTilesetNum);
 
-    mapLayout->blockdata = blockdata;
+    mapLayout->blockdata = data.blockdata;
 
-    if (!border.isEmpty()) {
-        mapLayout->border = border;
+    if (!data.border.isEmpty()) {
+        mapLayout->border = data.border;
     }
 
     return mapLayout;
@@ -66,32 +66,24 @@ QList<Metatile*> MetatileParser::parse(QString filepath, bool *error, bool prima
         return { };
     }
 
+    // AdvanceMap .bvd files only contain 8 tiles of data per metatile.
+    // If the user has triple-layer metatiles enabled we need to fill the remaining 4 tiles ourselves.
+    const int numTiles = projectConfig.tripleLayerMetatilesEnabled ? 12 : 8;
+    const uchar *data = reinterpret_cast<const uchar *>(in.constData());
+
     QList<Metatile*> metatiles;
+    metatiles.reserve(numMetatiles);
     for (int i = 0; i < numMetatiles; i++) {
-        Metatile *metatile = new Metatile();
-        QList<Tile> tiles;
-        for (int j = 0; j < 8; j++) {
-            int metatileOffset = 4 + i * metatileSize + j * 2;
-            Tile tile(static_cast<uint16_t>(
-                        static_cast<unsigned char>(in.at(metatileOffset)) |
-                       (static_cast<unsigned char>(in.at(metatileOffset + 1)) << 8)));
-            tiles.append(tile);
-        }
-
-        // AdvanceMap .bvd files only contain 8 tiles of data per metatile.
-        // If the user has triple-layer metatiles enabled we need to fill the remaining 4 tiles ourselves.
-        if (projectConfig.tripleLayerMetatilesEnabled) {
-            Tile tile = Tile();
-            for (int j = 0; j < 4; j++)
-                tiles.append(tile);
-        }
+        Metatile *metatile = new Metatile(numTiles);
+        const uchar *tileData = data + 4 + i * metatileSize;
+        for (int j = 0; j < 8; j++)
+            metatile->tiles[j] = Tile(static_cast<uint16_t>(tileData[j * 2] | (tileData[j * 2 + 1] << 8)));
 
-        int attrOffset = 4 + (numMetatiles * metatileSize) + (i * attrSize);
+        const uchar *attrData = data + 4 + (numMetatiles * metatileSize) + (i * attrSize);
         uint32_t attributes = 0;
         for (int j = 0; j < attrSize; j++)
-            attributes |= static_cast<unsigned char>(in.at(attrOffset + j)) << (8 * j);
+            attributes |= static_cast<uint32_t>(attrData[j]) << (8 * j);
         metatile->setAttributes(attributes, version);
-        metatile->tiles = tiles;
         metatiles.append(metatile);
     }
 
@@ -0,0 +1,109 @@
+#include "palettetable.h"
+#include "tileset.h"
+#include "project.h"
+
+// Each palette has its colors as-is, followed by a copy for each layer with and without a transparent first color.
+static const int variantsPerPalette = 1 + PaletteTable::numLayers * 2;
+
+// Tables for the tileset pairs that were rendered most recently. Rendering only happens on the GUI thread.
+static const int maxCachedTables = 8;
+static QList<QSharedPointer<PaletteTable>> cachedTables;
+
+QSharedPointer<const PaletteTable> PaletteTable::get(Tileset *primaryTileset, Tileset *secondaryTileset, const QList<float> &layerOpacity, bool useTruePalettes) {
+    float opacity[numLayers];
+    for (int i = 0; i < numLayers; i++)
+        opacity[i] = (layerOpacity.size() >= numLayers) ? layerOpacity.at(i) : 1.0;
+
+    for (int i = 0; i < cachedTables.size(); i++) {
+        const QSharedPointer<PaletteTable> table = cachedTables.at(i);
+        if (table->isCurrent(primaryTileset, secondaryTileset, opacity, useTruePalettes)) {
+            if (i != 0)
+                cachedTables.move(i, 0);
+            return table;
+        }
+        if (table->primaryTileset == primaryTileset && table->secondaryTileset == secondaryTileset && table->useTruePalettes == useTruePalettes) {
+            // The palettes or opacity for this pair have changed, the old table won't be used again.
+            cachedTables.removeAt(i--);
+        }
+    }
+
+    QSharedPointer<PaletteTable> table(new PaletteTable);
+    table->primaryTileset = primaryTileset;
+    table->secondaryTileset = secondaryTileset;
+    table->useTruePalettes = useTruePalettes;
+    for (int i = 0; i < numLayers; i++)
+        table->opacity[i] = opacity[i];
+    table->build();
+
+    cachedTables.prepend(table);
+    while (cachedTables.size() > maxCachedTables)
+        cachedTables.removeLast();
+    return table;
+}
+
+bool PaletteTable::isCurrent(Tileset *primaryTileset, Tileset *secondaryTileset, const float *opacity, bool useTruePalettes) const {
+    if (this->primaryTileset != primaryTileset || this->secondaryTileset != secondaryTileset || this->useTruePalettes != useTruePalettes)
+        return false;
+    for (int i = 0; i < numLayers; i++) {
+        if (this->opacity[i] != opacity[i])
+            return false;
+    }
+    if (this->numPalettesPrimary != Project::getNumPalettesPrimary() || this->m_numPalettes != Project::getNumPalettesTotal())
+        return false;
+    if (primaryTileset && this->primaryPalettes != (useTruePalettes ? primaryTileset->palettes : primaryTileset->palettePreviews))
+        return false;
+    if (secondaryTileset && this->secondaryPalettes != (useTruePalettes ? secondaryTileset->palettes : secondaryTileset->palettePreviews))
+        return false;
+    return true;
+}
+
+void PaletteTable::build() {
+    if (this->primaryTileset)
+        this->primaryPalettes = this->useTruePalettes ? this->primaryTileset->palettes : this->primaryTileset->palettePreviews;
+    if (this->secondaryTileset)
+        this->secondaryPalettes = this->useTruePalettes ? this->secondaryTileset->palettes : this->secondaryTileset->palettePreviews;
+    this->numPalettesPrimary = Project::getNumPalettesPrimary();
+    this->m_numPalettes = Project::getNumPalettesTotal();
+
+    this->table.resize(this->m_numPalettes * variantsPerPalette * numColors);
+    for (int paletteId = 0; paletteId < this->m_numPalettes; paletteId++) {
+        // Palettes below the primary count come from the primary tileset, and the rest from the secondary tileset.
+        const QList<QRgb> palette = (paletteId < this->numPalettesPrimary)
+                                  ? this->primaryPalettes.value(paletteId)
+                                  : this->secondaryPalettes.value(paletteId);
+        QRgb *out = this->table.data() + paletteId * variantsPerPalette * numColors;
+        for (int i = 0; i < numColors; i++)
+            out[i] = qPremultiply(palette.value(i, qRgb(0, 0, 0)));
+        for (int layer = 0; layer < numLayers; layer++) {
+            makeLayerColors(palette, this->opacity[layer], false, out + layerVariant(layer, false) * numColors);
+            makeLayerColors(palette, this->opacity[layer], true, out + layerVariant(layer, true) * numColors);
+        }
+    }
+}
+
+void PaletteTable::makeLayerColors(const QList<QRgb> &palette, float opacity, bool transparentFirstColor, QRgb *out) {
+    for (int i = 0; i < numColors; i++) {
+        QRgb color = palette.value(i, qRgb(0, 0, 0));
+        if (opacity < 1.0)
+            color = qRgba(qRed(color), qGreen(color), qBlue(color), static_cast<int>(qAlpha(color) * opacity));
+        out[i] = qPremultiply(color);
+    }
+    if (transparentFirstColor)
+        out[0] = 0;
+}
+
+int PaletteTable::layerVariant(int layer, bool transparentFirstColor) {
+    return 1 + layer * 2 + (transparentFirstColor ? 1 : 0);
+}
+
+const QRgb *PaletteTable::colors(int paletteId) const {
+    if (paletteId < 0 || paletteId >= this->m_numPalettes)
+        return nullptr;
+    return this->table.constData() + paletteId * variantsPerPalette * numColors;
+}
+
+const QRgb *PaletteTable::colors(int paletteId, int layer, bool transparentFirstColor) const {
+    if (paletteId < 0 || paletteId >= this->m_numPalettes || layer < 0 || layer >= numLayers)
+        return nullptr;
+    return this->table.constData() + (paletteId * variantsPerPalette + layerVariant(layer, transparentFirstColor)) * numColors;
+}
@@ -682,9 +682,13 @@ bool ParseUtil::tryParseJsonFile(QJsonDocument *out, const QString &filepath) {
 }
 
 bool ParseUtil::tryParseOrderedJsonFile(poryjson::Json::object *out, const QString &filepath) {
+    QFile file(filepath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        logError(QString("Error: Could not open %1 for reading").arg(filepath));
+        return false;
+    }
     QString err;
-    QString jsonTxt = readTextFile(filepath);
-    *out = OrderedJson::parse(jsonTxt, err).object_items();
+    *out = OrderedJson::parse(file.readAll(), err).object_items();
     if (!err.isEmpty()) {
         logError(QString("Error: Failed to parse json file %1: %2").arg(filepath).arg(err));
         return false;
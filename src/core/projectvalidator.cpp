@@ -0,0 +1,396 @@
+#include "projectvalidator.h"
+#include "project.h"
+#include "config.h"
+#include "map.h"
+#include "maplayout.h"
+#include "mapconnection.h"
+#include "events.h"
+#include "tileset.h"
+#include "metatile.h"
+#include "parseutil.h"
+#include "tracer.h"
+
+#include <QFileInfo>
+#include <QtConcurrent>
+
+QString ValidationIssue::location() const {
+    QString location;
+    if (!this->mapName.isEmpty())
+        location = this->mapName;
+    else if (!this->layoutId.isEmpty())
+        location = this->layoutId;
+    else
+        location = this->tilesetLabel;
+
+    if (this->position.x() >= 0 && this->position.y() >= 0)
+        location += QString(" (%1, %2)").arg(this->position.x()).arg(this->position.y());
+    return location;
+}
+
+void ValidationContext::report(ValidationIssue::Severity severity, const QString &message, QPoint position) {
+    ValidationIssue issue;
+    issue.severity = severity;
+    issue.rule = this->rule;
+    if (this->map)
+        issue.mapName = this->map->name;
+    else if (this->layout)
+        issue.layoutId = this->layout->id;
+    else if (this->tileset)
+        issue.tilesetLabel = this->tileset->name;
+    issue.position = position;
+    issue.message = message;
+    this->issues.append(issue);
+}
+
+// Values like "0" or "FLAG_TEMP_1 + 2" aren't names, so they aren't checked.
+static bool isCheckableName(const QString &name) {
+    if (name.isEmpty() || name == "0" || name == "NULL" || name == "0x0")
+        return false;
+    static const QRegularExpression re_identifier("^[A-Za-z_][A-Za-z0-9_]*$");
+    return re_identifier.match(name).hasMatch();
+}
+
+static QPoint eventPosition(const Event *event) {
+    return QPoint(event->getX(), event->getY());
+}
+
+static void checkWarpDestinations(ValidationContext &context) {
+    for (Event *event : context.map->events.value(Event::Group::Warp)) {
+        if (event->getEventType() != Event::Type::Warp)
+            continue;
+        auto warp = static_cast<WarpEvent *>(event);
+        const QString destination = warp->getDestinationMap();
+        if (destination == DYNAMIC_MAP_NAME)
+            continue;
+        if (!context.mapNames->contains(destination)) {
+            context.error(QString("Warp %1 leads to map '%2', which doesn't exist.").arg(warp->getEventIndex()).arg(destination), eventPosition(warp));
+            continue;
+        }
+        bool ok;
+        const int warpId = ParseUtil::gameStringToInt(warp->getDestinationWarpID(), &ok);
+        if (ok && warpId >= context.warpCounts->value(destination))
+            context.warning(QString("Warp %1 leads to warp %2 on map '%3', which only has %4 warps.")
+                                .arg(warp->getEventIndex()).arg(warpId).arg(destination).arg(context.warpCounts->value(destination)),
+                            eventPosition(warp));
+    }
+}
+
+static void checkWarpBehaviors(ValidationContext &context) {
+    if (porymapConfig.warpBehaviorWarningDisabled || !context.map->layout)
+        return;
+    Layout *layout = context.map->layout;
+    for (Event *event : context.map->events.value(Event::Group::Warp)) {
+        if (event->getEventType() != Event::Type::Warp)
+            continue;
+        Block block;
+        Metatile *metatile = nullptr;
+        if (layout->getBlock(event->getX(), event->getY(), &block))
+            metatile = Tileset::getMetatile(block.metatileId(), layout->tileset_primary, layout->tileset_secondary);
+        if (metatile && !projectConfig.warpBehaviors.contains(metatile->behavior()))
+            context.warning(QString("Warp %1 isn't on a metatile with a warp behavior, so it can't be used in-game.").arg(event->getEventIndex()),
+                            eventPosition(event));
+    }
+}
+
+static void checkConnections(ValidationContext &context) {
+    for (MapConnection *connection : context.map->getConnections()) {
+        if (!context.mapNames->contains(connection->targetMapName()))
+            context.error(QString("The %1 connection leads to map '%2', which doesn't exist.").arg(connection->direction()).arg(connection->targetMapName()));
+    }
+}
+
+static void checkEventFlags(ValidationContext &context) {
+    if (context.flagNames->isEmpty())
+        return;
+    for (Event *event : context.map->getAllEvents()) {
+        QString flag;
+        if (event->getEventType() == Event::Type::Object)
+            flag = static_cast<ObjectEvent *>(event)->getFlag();
+        else if (event->getEventType() == Event::Type::HiddenItem)
+            flag = static_cast<HiddenItemEvent *>(event)->getFlag();
+        if (isCheckableName(flag) && !context.flagNames->contains(flag))
+            context.warning(QString("%1 %2 uses flag '%3', which isn't defined.")
+                                .arg(Event::eventTypeToString(event->getEventType())).arg(event->getEventIndex()).arg(flag),
+                            eventPosition(event));
+    }
+}
+
+static void checkEventVars(ValidationContext &context) {
+    if (context.varNames->isEmpty())
+        return;
+    for (Event *event : context.map->events.value(Event::Group::Coord)) {
+        if (event->getEventType() != Event::Type::Trigger)
+            continue;
+        const QString var = static_cast<TriggerEvent *>(event)->getScriptVar();
+        if (isCheckableName(var) && !context.varNames->contains(var))
+            context.warning(QString("Trigger %1 uses var '%2', which isn't defined.").arg(event->getEventIndex()).arg(var), eventPosition(event));
+    }
+}
+
+static void checkEventScripts(ValidationContext &context) {
+    for (Event *event : context.map->getAllEvents()) {
+        ScriptTracker tracker;
+        event->accept(&tracker);
+        for (const QString &script : tracker.getScripts()) {
+            if (isCheckableName(script) && !context.scriptLabels.contains(script))
+                context.warning(QString("%1 %2 uses script '%3', which wasn't found in the project's scripts.")
+                                    .arg(Event::eventTypeToString(event->getEventType())).arg(event->getEventIndex()).arg(script),
+                                eventPosition(event));
+        }
+    }
+}
+
+static void checkObjectEventCount(ValidationContext &context) {
+    const int count = context.map->events.value(Event::Group::Object).length();
+    if (count > Project::getMaxObjectEvents())
+        context.warning(QString("The map has %1 object events, but only %2 can be loaded in-game.").arg(count).arg(Project::getMaxObjectEvents()));
+}
+
+static void checkEncounters(ValidationContext &context) {
+    for (const auto &group : context.encounters) {
+        for (const auto &field : group.second.wildMons) {
+            if (!field.second.active)
+                continue;
+            for (int i = 0; i < field.second.wildPokemon.length(); i++) {
+                const WildPokemon &mon = field.second.wildPokemon.at(i);
+                const QString species = mon.species.toString();
+                if (!context.speciesNames->isEmpty() && isCheckableName(species) && !context.speciesNames->contains(species))
+                    context.warning(QString("Encounter %1 of '%2' in '%3' uses species '%4', which isn't defined.").arg(i).arg(field.first).arg(group.first).arg(species));
+                if (mon.minLevel > mon.maxLevel)
+                    context.error(QString("Encounter %1 of '%2' in '%3' has a minimum level (%4) above its maximum level (%5).")
+                                      .arg(i).arg(field.first).arg(group.first).arg(mon.minLevel).arg(mon.maxLevel));
+            }
+        }
+    }
+}
+
+static void checkLayoutSize(ValidationContext &context) {
+    Layout *layout = context.layout;
+    if (!Project::mapDimensionsValid(layout->getWidth(), layout->getHeight()))
+        context.error(QString("The layout's dimensions (%1x%2) are larger than the maximum map size.").arg(layout->getWidth()).arg(layout->getHeight()));
+    const int numBlocks = layout->getWidth() * layout->getHeight();
+    if (layout->blockdata.length() != numBlocks)
+        context.error(QString("The layout has %1 metatiles, but its dimensions need %2.").arg(layout->blockdata.length()).arg(numBlocks));
+    const int numBorderBlocks = layout->getBorderWidth() * layout->getBorderHeight();
+    if (layout->border.length() != numBorderBlocks)
+        context.error(QString("The layout's border has %1 metatiles, but its dimensions need %2.").arg(layout->border.length()).arg(numBorderBlocks));
+}
+
+static void checkMetatileIds(ValidationContext &context) {
+    Layout *layout = context.layout;
+    const int numPrimary = layout->tileset_primary ? layout->tileset_primary->numMetatiles() : 0;
+    const int numSecondary = layout->tileset_secondary ? layout->tileset_secondary->numMetatiles() : 0;
+    auto isValid = [numPrimary, numSecondary](int metatileId) {
+        if (metatileId < Project::getNumMetatilesPrimary())
+            return metatileId < numPrimary;
+        return metatileId - Project::getNumMetatilesPrimary() < numSecondary;
+    };
+
+    // Only the first few bad metatiles of each layout are reported, a layout using the wrong tileset could have thousands.
+    const int maxReported = 10;
+    int numInvalid = 0;
+    const int width = layout->getWidth();
+    for (int i = 0; i < layout->blockdata.length(); i++) {
+        const int metatileId = layout->blockdata.at(i).metatileId();
+        if (isValid(metatileId))
+            continue;
+        if (numInvalid++ < maxReported)
+            context.error(QString("Metatile %1 isn't in the layout's tilesets.").arg(Metatile::getMetatileIdString(metatileId)),
+                          QPoint(i % width, i / width));
+    }
+    if (numInvalid > maxReported)
+        context.error(QString("%1 more metatiles aren't in the layout's tilesets.").arg(numInvalid - maxReported));
+    for (int i = 0; i < layout->border.length(); i++) {
+        const int metatileId = layout->border.at(i).metatileId();
+        if (!isValid(metatileId))
+            context.error(QString("Border metatile %1 isn't in the layout's tilesets.").arg(Metatile::getMetatileIdString(metatileId)));
+    }
+}
+
+static void checkMetatileAttributeCount(ValidationContext &context) {
+    Tileset *tileset = context.tileset;
+    const QFileInfo metatilesFile(tileset->metatiles_path);
+    const QFileInfo attributesFile(tileset->metatile_attrs_path);
+    if (!metatilesFile.exists() || !attributesFile.exists())
+        return;
+    const qint64 numMetatiles = metatilesFile.size() / (2 * projectConfig.getNumTilesInMetatile());
+    const qint64 numAttributes = attributesFile.size() / projectConfig.metatileAttributesSize;
+    if (numMetatiles != numAttributes)
+        context.warning(QString("The tileset has %1 metatiles, but attributes for %2.").arg(numMetatiles).arg(numAttributes));
+}
+
+static void checkTilesetSize(ValidationContext &context) {
+    Tileset *tileset = context.tileset;
+    const int max = tileset->is_secondary ? Project::getNumMetatilesTotal() - Project::getNumMetatilesPrimary() : Project::getNumMetatilesPrimary();
+    if (tileset->numMetatiles() > max)
+        context.error(QString("The tileset has %1 metatiles, but only %2 can be used.").arg(tileset->numMetatiles()).arg(max));
+}
+
+const QList<ValidationRule> &ProjectValidator::rules() {
+    static const QList<ValidationRule> rules = {
+        {"warp-destination", "Warps lead to maps and warps that exist.", ValidationRule::Target::Map, checkWarpDestinations},
+        {"warp-behavior", "Warps are on metatiles with a warp behavior.", ValidationRule::Target::Map, checkWarpBehaviors},
+        {"connection-map", "Connections lead to maps that exist.", ValidationRule::Target::Map, checkConnections},
+        {"event-flag", "Events only use defined flags.", ValidationRule::Target::Map, checkEventFlags},
+        {"event-var", "Triggers only use defined vars.", ValidationRule::Target::Map, checkEventVars},
+        {"event-script", "Events only use scripts that exist.", ValidationRule::Target::Map, checkEventScripts},
+        {"object-event-count", "Maps don't have more object events than can be loaded.", ValidationRule::Target::Map, checkObjectEventCount},
+        {"encounters", "Wild encounters use defined species and valid levels.", ValidationRule::Target::Map, checkEncounters},
+        {"layout-size", "Layouts fit the maximum map size, and their blockdata matches their dimensions.", ValidationRule::Target::Layout, checkLayoutSize},
+        {"metatile-id", "Layouts only use metatiles from their tilesets.", ValidationRule::Target::Layout, checkMetatileIds},
+        {"metatile-attributes", "Tilesets have attributes for each metatile.", ValidationRule::Target::Tileset, checkMetatileAttributeCount},
+        {"tileset-size", "Tilesets don't have more metatiles than can be used.", ValidationRule::Target::Tileset, checkTilesetSize},
+    };
+    return rules;
+}
+
+ProjectValidator::ProjectValidator(Project *project) :
+    project(project)
+{}
+
+// The data each rule is run over, and its results.
+struct ValidationJob {
+    ValidationRule::Target target;
+    QString key;
+    ValidationContext context;
+};
+
+void ProjectValidator::gatherNames() {
+    auto toSet = [](const QStringList &list) {
+        QSet<QString> set;
+        set.reserve(list.size());
+        for (const QString &item : list)
+            set.insert(item);
+        return set;
+    };
+    this->mapNames = toSet(this->project->mapNames);
+    this->flagNames = toSet(this->project->flagNames);
+    this->varNames = toSet(this->project->varNames);
+    this->speciesNames = toSet(this->project->speciesToIconPath.keys());
+    this->globalScriptLabels = toSet(this->project->globalScriptLabels);
+}
+
+void ProjectValidator::run(const QList<Map *> &maps, const QList<Layout *> &layouts, const QList<Tileset *> &tilesets) {
+    TRACE_SCOPE("ProjectValidator::run");
+    QList<ValidationJob> jobs;
+    auto addJob = [this, &jobs](ValidationRule::Target target, const QString &key) {
+        ValidationJob job;
+        job.target = target;
+        job.key = key;
+        job.context.project = this->project;
+        job.context.mapNames = &this->mapNames;
+        job.context.flagNames = &this->flagNames;
+        job.context.varNames = &this->varNames;
+        job.context.speciesNames = &this->speciesNames;
+        job.context.warpCounts = &this->warpCounts;
+        jobs.append(job);
+        return &jobs.last().context;
+    };
+    for (Map *map : maps) {
+        ValidationContext *context = addJob(ValidationRule::Target::Map, "map:" + map->name);
+        context->map = map;
+        context->scriptLabels = this->globalScriptLabels;
+        // Reading encounters creates symbols, which isn't thread-safe, so it's done here rather than in the rule.
+        context->encounters = this->project->readWildMonData(map->constantName);
+    }
+    for (Layout *layout : layouts)
+        addJob(ValidationRule::Target::Layout, "layout:" + layout->id)->layout = layout;
+    for (Tileset *tileset : tilesets)
+        addJob(ValidationRule::Target::Tileset, "tileset:" + tileset->name)->tileset = tileset;
+
+    auto runJob = [](ValidationJob job) {
+        if (job.target == ValidationRule::Target::Map) {
+            // Maps can use the labels in their own scripts file, which are read here so the files are read in parallel.
+            for (const QString &label : ParseUtil::getGlobalScriptLabels(job.context.map->getScriptsFilePath()))
+                job.context.scriptLabels.insert(label);
+        }
+        for (const ValidationRule &rule : ProjectValidator::rules()) {
+            if (rule.target != job.target)
+                continue;
+            job.context.rule = rule.name;
+            rule.check(job.context);
+        }
+        return job;
+    };
+    const QList<ValidationJob> results = QtConcurrent::blockingMapped<QList<ValidationJob>>(jobs, runJob);
+    for (const ValidationJob &result : results)
+        this->issuesByTarget.insert(result.key, result.context.issues);
+}
+
+bool ProjectValidator::validateAll() {
+    TRACE_SCOPE("ProjectValidator::validateAll");
+    this->issuesByTarget.clear();
+    this->loadIssues.clear();
+
+    auto loadError = [this](const QString &message, const QString &mapName, const QString &layoutId) {
+        ValidationIssue issue;
+        issue.severity = ValidationIssue::Severity::Error;
+        issue.rule = "load";
+        issue.mapName = mapName;
+        issue.layoutId = layoutId;
+        issue.message = message;
+        this->loadIssues.append(issue);
+    };
+
+    // Loading uses the project's caches, so it's done here, before the rules run in parallel.
+    QList<Layout *> layouts;
+    QSet<Tileset *> tilesets;
+    for (const QString &layoutId : this->project->mapLayoutsTable) {
+        Layout *layout = this->project->loadLayout(layoutId);
+        if (!layout) {
+            loadError("The layout failed to load.", QString(), layoutId);
+            continue;
+        }
+        layouts.append(layout);
+        if (layout->tileset_primary) tilesets.insert(layout->tileset_primary);
+        if (layout->tileset_secondary) tilesets.insert(layout->tileset_secondary);
+    }
+    QList<Map *> maps;
+    this->warpCounts.clear();
+    for (const QString &mapName : this->project->mapNames) {
+        Map *map = this->project->getMap(mapName);
+        if (!map) {
+            loadError("The map failed to load.", mapName, QString());
+            continue;
+        }
+        maps.append(map);
+        this->warpCounts.insert(mapName, map->events.value(Event::Group::Warp).length());
+    }
+    gatherNames();
+
+    run(maps, layouts, tilesets.values());
+    return this->loadIssues.isEmpty();
+}
+
+void ProjectValidator::revalidateMap(const QString &mapName) {
+    Map *map = this->project->getMap(mapName);
+    if (!map)
+        return;
+    gatherNames();
+    this->warpCounts.insert(mapName, map->events.value(Event::Group::Warp).length());
+
+    QList<Layout *> layouts;
+    QList<Tileset *> tilesets;
+    if (map->layout) {
+        layouts.append(map->layout);
+        if (map->layout->tileset_primary) tilesets.append(map->layout->tileset_primary);
+        if (map->layout->tileset_secondary) tilesets.append(map->layout->tileset_secondary);
+    }
+    run({map}, layouts, tilesets);
+}
+
+QList<ValidationIssue> ProjectValidator::getIssues() const {
+    QList<ValidationIssue> issues = this->loadIssues;
+    for (auto it = this->issuesByTarget.constBegin(); it != this->issuesByTarget.constEnd(); it++)
+        issues.append(it.value());
+    return issues;
+}
+
+int ProjectValidator::errorCount() const {
+    int count = 0;
+    for (const ValidationIssue &issue : getIssues()) {
+        if (issue.severity == ValidationIssue::Severity::Error)
+            count++;
+    }
+    return count;
+}
@@ -5,6 +5,7 @@
 #include "log.h"
 #include "config.h"
 #include "regionmapeditcommands.h"
+#include "imagecache.h"
 
 #include <QByteArray>
 #include <QFile>
@@ -78,7 +79,7 @@ bool RegionMap::loadTilemap(poryjson::Json tilemapJson) {
         this->palette_path = tilemapObject["palette"].string_value();
     }
 
-    QImage tilesetFile(fullPath(this->tileset_path));
+    QImage tilesetFile = ImageCache::get(fullPath(this->tileset_path));
     if (tilesetFile.isNull()) {
         logError(QString("Failed to open region map tileset file '%1'.").arg(tileset_path));
         return false;
@@ -0,0 +1,43 @@
+#include "symboltable.h"
+
+#include <QVector>
+
+// Names by ID, and IDs by name. Both share the same string data.
+static QVector<QString> symbolNames = { QString() };
+static QHash<QString, quint32> symbolIds = { { QString(), 0 } };
+
+quint32 SymbolTable::intern(const QString &name) {
+    if (name.isEmpty())
+        return 0;
+
+    auto it = symbolIds.constFind(name);
+    if (it != symbolIds.constEnd())
+        return it.value();
+
+    const quint32 id = symbolNames.size();
+    symbolNames.append(name);
+    symbolIds.insert(symbolNames.last(), id);
+    return id;
+}
+
+quint32 SymbolTable::find(const QString &name) {
+    return symbolIds.value(name, 0);
+}
+
+QString SymbolTable::name(quint32 id) {
+    return symbolNames.value(id);
+}
+
+void SymbolTable::intern(QStringList *names) {
+    for (QString &name : *names)
+        name = symbolNames.at(intern(name));
+}
+
+int SymbolTable::size() {
+    return symbolNames.size();
+}
+
+void SymbolTable::clear() {
+    symbolNames = { QString() };
+    symbolIds = { { QString(), 0 } };
+}
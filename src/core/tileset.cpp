@@ -23,7 +23,8 @@ Tileset::Tileset(const Tileset &other)
       metatileLabels(other.metatileLabels),
       palettes(other.palettes),
       palettePreviews(other.palettePreviews),
-      hasUnsavedTilesImage(false)
+      hasUnsavedTilesImage(false),
+      m_revision(other.m_revision)
 {
     for (auto tile : other.tiles) {
         tiles.append(tile.copy());
@@ -60,6 +61,8 @@ Tileset &Tileset::operator=(const Tileset &other) {
         m_metatiles.append(new Metatile(*metatile));
     }
 
+    // The contents were replaced, so this must be newer than both what it had before and what it was given.
+    m_revision = qMax(m_revision, other.m_revision) + 1;
     return *this;
 }
 
@@ -215,19 +218,6 @@ bool Tileset::metatileIsValid(uint16_t metatileId, Tileset *primaryTileset, Tile
     return true;
 }
 
-QList<QList<QRgb>> Tileset::getBlockPalettes(Tileset *primaryTileset, Tileset *secondaryTileset, bool useTruePalettes) {
-    QList<QList<QRgb>> palettes;
-    auto primaryPalettes = useTruePalettes ? primaryTileset->palettes : primaryTileset->palettePreviews;
-    for (int i = 0; i < Project::getNumPalettesPrimary(); i++) {
-        palettes.append(primaryPalettes.at(i));
-    }
-    auto secondaryPalettes = useTruePalettes ? secondaryTileset->palettes : secondaryTileset->palettePreviews;
-    for (int i = Project::getNumPalettesPrimary(); i < Project::getNumPalettesTotal(); i++) {
-        palettes.append(secondaryPalettes.at(i));
-    }
-    return palettes;
-}
-
 QList<QRgb> Tileset::getPalette(int paletteId, Tileset *primaryTileset, Tileset *secondaryTileset, bool useTruePalettes) {
     QList<QRgb> paletteTable;
     Tileset *tileset = paletteId < Project::getNumPalettesPrimary()
@@ -0,0 +1,162 @@
+#include "tracer.h"
+#include "log.h"
+
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QStandardPaths>
+#include <QThread>
+#include <QVector>
+#include <algorithm>
+
+struct TraceEvent {
+    const char *name;
+    qint64 startUs;
+    qint64 durationUs;
+    quintptr threadId;
+};
+
+static QAtomicInt enabled(0);
+static QMutex mutex;
+static QVector<TraceEvent> events;
+static QElapsedTimer traceClock;
+// Set by the PORYMAP_TRACE environment variable, which overrides the preference.
+static bool forced = false;
+static QString forcedPath;
+
+// Recording stops after this many scopes, so a forgotten trace can't use up the memory.
+#define MAX_TRACE_EVENTS 2000000
+
+void Tracer::init(bool enable) {
+    const QString env = qEnvironmentVariable("PORYMAP_TRACE");
+    if (!env.isEmpty() && env != "0") {
+        forced = true;
+        if (env != "1")
+            forcedPath = env;
+    }
+    setEnabled(enable);
+}
+
+void Tracer::setEnabled(bool enable) {
+    enable = enable || forced;
+    if (enable == isEnabled())
+        return;
+    if (enable) {
+        QMutexLocker locker(&mutex);
+        if (!traceClock.isValid())
+            traceClock.start();
+        enabled.storeRelease(1);
+        logInfo(QString("Recording performance trace to '%1'").arg(getTracePath()));
+    } else {
+        enabled.storeRelease(0);
+        finish();
+    }
+}
+
+bool Tracer::isEnabled() {
+    return enabled.loadAcquire();
+}
+
+qint64 Tracer::now() {
+    return traceClock.nsecsElapsed() / 1000;
+}
+
+QString Tracer::getTracePath() {
+    if (!forcedPath.isEmpty())
+        return forcedPath;
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).absoluteFilePath("porymap_trace.json");
+}
+
+void Tracer::record(const char *name, qint64 startUs, qint64 durationUs) {
+    const auto threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+    QMutexLocker locker(&mutex);
+    if (events.size() >= MAX_TRACE_EVENTS)
+        return;
+    events.append({name, startUs, durationUs, threadId});
+}
+
+static QByteArray escapeJson(const char *string) {
+    QByteArray escaped;
+    for (const char *c = string; *c; c++) {
+        if (*c == '"' || *c == '\\')
+            escaped += '\\';
+        escaped += *c;
+    }
+    return escaped;
+}
+
+void Tracer::finish() {
+    QVector<TraceEvent> recorded;
+    {
+        QMutexLocker locker(&mutex);
+        recorded.swap(events);
+    }
+    if (recorded.isEmpty())
+        return;
+
+    // Threads are numbered in the order they first appear. This is called from the GUI thread, which is always thread 1.
+    QHash<quintptr, int> threadNumbers;
+    threadNumbers.insert(reinterpret_cast<quintptr>(QThread::currentThreadId()), 1);
+
+    // The trace is written by hand rather than with QJsonDocument, which would need a copy of every event.
+    const QString path = getTracePath();
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        logError(QString("Could not write performance trace to '%1': %2").arg(path).arg(file.errorString()));
+        return;
+    }
+    const qint64 pid = QCoreApplication::applicationPid();
+    file.write("{\"traceEvents\":[\n");
+    bool first = true;
+    for (const TraceEvent &event : recorded) {
+        if (!threadNumbers.contains(event.threadId))
+            threadNumbers.insert(event.threadId, threadNumbers.size() + 1);
+        QByteArray line = QString("%1{\"name\":\"%2\",\"cat\":\"porymap\",\"ph\":\"X\",\"ts\":%3,\"dur\":%4,\"pid\":%5,\"tid\":%6}")
+                            .arg(first ? "" : ",\n")
+                            .arg(QString::fromUtf8(escapeJson(event.name)))
+                            .arg(event.startUs)
+                            .arg(event.durationUs)
+                            .arg(pid)
+                            .arg(threadNumbers.value(event.threadId))
+                            .toUtf8();
+        file.write(line);
+        first = false;
+    }
+    file.write("\n],\"displayTimeUnit\":\"ms\"}\n");
+    file.close();
+
+    // Summarize the time spent in each scope, slowest first.
+    struct Summary {
+        const char *name;
+        int calls = 0;
+        qint64 totalUs = 0;
+        qint64 maxUs = 0;
+    };
+    QHash<QByteArray, Summary> summaries;
+    for (const TraceEvent &event : recorded) {
+        Summary &summary = summaries[QByteArray(event.name)];
+        summary.name = event.name;
+        summary.calls++;
+        summary.totalUs += event.durationUs;
+        summary.maxUs = qMax(summary.maxUs, event.durationUs);
+    }
+    QVector<Summary> sorted;
+    for (const Summary &summary : summaries)
+        sorted.append(summary);
+    std::sort(sorted.begin(), sorted.end(), [](const Summary &a, const Summary &b) { return a.totalUs > b.totalUs; });
+
+    QString table = QString("Wrote performance trace to '%1'\n").arg(path);
+    table += QString("%1 %2 %3 %4 %5\n").arg("Scope", -40).arg("Calls", 8).arg("Total ms", 12).arg("Avg ms", 10).arg("Max ms", 10);
+    for (const Summary &summary : sorted) {
+        table += QString("%1 %2 %3 %4 %5\n")
+                    .arg(QString::fromUtf8(summary.name), -40)
+                    .arg(summary.calls, 8)
+                    .arg(summary.totalUs / 1000.0, 12, 'f', 2)
+                    .arg(summary.totalUs / 1000.0 / summary.calls, 10, 'f', 3)
+                    .arg(summary.maxUs / 1000.0, 10, 'f', 2);
+    }
+    logInfo(table.trimmed());
+}
@@ -11,6 +11,7 @@
 #include "config.h"
 #include "scripting.h"
 #include "customattributestable.h"
+#include "tracer.h"
 #include <QCheckBox>
 #include <QPainter>
 #include <QMouseEvent>
@@ -21,7 +22,7 @@
 static bool selectNewEvents = false;
 
 // 2D array mapping collision+elevation combos to an icon.
-QList<QList<const QImage*>> Editor::collisionIcons;
+QImage Editor::collisionAtlas;
 
 Editor::Editor(Ui::MainWindow* ui)
 {
@@ -60,8 +61,6 @@ Editor::~Editor()
     delete this->playerViewRect;
     delete this->cursorMapTileRect;
     delete this->map_ruler;
-    for (auto sublist : collisionIcons)
-        qDeleteAll(sublist);
 
     closeProject();
 }
@@ -240,23 +239,22 @@ void Editor::displayWildMonTables() {
     clearWildMonTables();
 
     // Don't try to read encounter data if it doesn't exist on disk for this map.
-    if (!project->wildMonData.contains(map->constantName)) {
+    if (!project->hasWildMonData(map->constantName)) {
         return;
     }
 
+    const tsl::ordered_map<QString, WildPokemonHeader> &encounterMap = project->getWildMonData(map->constantName);
     QComboBox *labelCombo = ui->comboBox_EncounterGroupLabel;
-    for (auto groupPair : project->wildMonData[map->constantName])
+    for (auto groupPair : encounterMap)
         labelCombo->addItem(groupPair.first);
 
     labelCombo->setCurrentText(labelCombo->itemText(0));
 
     QStackedWidget *stack = ui->stackedWidget_WildMons;
     int labelIndex = 0;
-    for (auto labelPair : project->wildMonData[map->constantName]) {
+    for (auto labelPair : encounterMap) {
 
-        QString label = labelPair.first;
-
-        WildPokemonHeader header = project->wildMonData[map->constantName][label];
+        WildPokemonHeader header = labelPair.second;
 
         MonTabWidget *tabWidget = new MonTabWidget(this);
         stack->insertWidget(labelIndex++, tabWidget);
@@ -267,7 +265,7 @@ void Editor::displayWildMonTables() {
 
             tabWidget->clearTableAt(tabIndex);
 
-            if (project->wildMonData.contains(map->constantName) && header.wildMons[fieldName].active) {
+            if (header.wildMons[fieldName].active) {
                 tabWidget->populateTab(tabIndex, header.wildMons[fieldName]);
             } else {
                 tabWidget->setTabActive(tabIndex, false);
@@ -415,8 +413,7 @@ void Editor::deleteWildMonGroup() {
     msgBox.exec();
 
     if (msgBox.clickedButton() == deleteButton) {
-        auto it = project->wildMonData.find(map->constantName);
-        if (it == project->wildMonData.end()) {
+        if (!project->hasWildMonData(map->constantName)) {
           logError(QString("Failed to find data for map %1. Unable to delete").arg(map->constantName));
           return;
         }
@@ -428,7 +425,7 @@ void Editor::deleteWildMonGroup() {
           return;
         }
 
-        it.value().erase(labelCombo->currentText());
+        project->getWildMonData(map->constantName).erase(labelCombo->currentText());
         project->encounterGroupLabels.remove(i);
 
         displayWildMonTables();
@@ -698,7 +695,7 @@ void Editor::saveEncounterTabData() {
 
     if (!stack->count()) return;
 
-    tsl::ordered_map<QString, WildPokemonHeader> &encounterMap = project->wildMonData[map->constantName];
+    tsl::ordered_map<QString, WildPokemonHeader> &encounterMap = project->getWildMonData(map->constantName);
 
     for (int groupIndex = 0; groupIndex < stack->count(); groupIndex++) {
         MonTabWidget *tabWidget = static_cast<MonTabWidget *>(stack->widget(groupIndex));
@@ -732,6 +729,9 @@ EncounterTableModel* Editor::getCurrentWildMonTable() {
 }
 
 void Editor::updateEncounterFields(EncounterFields newFields) {
+    // Every map's encounters are changed below, so they need to be read before the fields change.
+    project->loadAllWildMonData();
+
     EncounterFields oldFields = project->wildMonFields;
     // Go through fields and determine whether we need to update a field.
     // If the field is new, do nothing.
@@ -1040,7 +1040,7 @@ void Editor::updateConnectionPixmap(ConnectionPixmapItem *pixmapItem) {
         return;
 
     pixmapItem->setOrigin(getConnectionOrigin(pixmapItem->connection));
-    pixmapItem->render(true); // Full render to reflect map changes
+    pixmapItem->render(true); // Fetch the connection's pixmap again to reflect map changes
 
     maskNonVisibleConnectionTiles();
 }
@@ -1255,6 +1255,7 @@ void Editor::unsetMap() {
 }
 
 bool Editor::setMap(QString map_name) {
+    TRACE_SCOPE("Editor::setMap");
     if (!project || map_name.isEmpty()) {
         return false;
     }
@@ -1288,6 +1289,7 @@ bool Editor::setMap(QString map_name) {
 }
 
 bool Editor::setLayout(QString layoutId) {
+    TRACE_SCOPE("Editor::setLayout");
     if (!project || layoutId.isEmpty()) {
         return false;
     }
@@ -1550,6 +1552,7 @@ void Editor::clearMap() {
 }
 
 bool Editor::displayMap() {
+    TRACE_SCOPE("Editor::displayMap");
     if (!this->map)
         return false;
 
@@ -1564,6 +1567,7 @@ bool Editor::displayMap() {
 }
 
 bool Editor::displayLayout() {
+    TRACE_SCOPE("Editor::displayLayout");
     if (!this->layout)
         return false;
 
@@ -1641,6 +1645,7 @@ void Editor::clearMapMetatiles() {
 }
 
 void Editor::displayMapMetatiles() {
+    TRACE_SCOPE("Editor::displayMapMetatiles");
     clearMapMetatiles();
 
     map_item = new LayoutPixmapItem(this->layout, this->metatile_selector_item, this->settings);
@@ -1658,8 +1663,8 @@ void Editor::displayMapMetatiles() {
     scene->setSceneRect(
         -BORDER_DISTANCE * tw,
         -BORDER_DISTANCE * th,
-        map_item->pixmap().width() + BORDER_DISTANCE * 2 * tw,
-        map_item->pixmap().height() + BORDER_DISTANCE * 2 * th
+        map_item->boundingRect().width() + BORDER_DISTANCE * 2 * tw,
+        map_item->boundingRect().height() + BORDER_DISTANCE * 2 * th
     );
 }
 
@@ -1779,6 +1784,7 @@ void Editor::clearMapEvents() {
 }
 
 void Editor::displayMapEvents() {
+    TRACE_SCOPE("Editor::displayMapEvents");
     clearMapEvents();
 
     events_group = new QGraphicsItemGroup;
@@ -1827,6 +1833,7 @@ void Editor::clearMapConnections() {
 }
 
 void Editor::displayMapConnections() {
+    TRACE_SCOPE("Editor::displayMapConnections");
     clearMapConnections();
 
     for (auto connection : map->getConnections())
@@ -1867,54 +1874,37 @@ void Editor::maskNonVisibleConnectionTiles() {
 }
 
 void Editor::clearMapBorder() {
-    for (QGraphicsPixmapItem* item : borderItems) {
-        if (item->scene()) {
-            item->scene()->removeItem(item);
+    if (border_item) {
+        if (border_item->scene()) {
+            border_item->scene()->removeItem(border_item);
         }
-        delete item;
+        delete border_item;
+        border_item = nullptr;
     }
-    borderItems.clear();
 }
 
 void Editor::displayMapBorder() {
+    TRACE_SCOPE("Editor::displayMapBorder");
     clearMapBorder();
 
-    int borderWidth = this->layout->getBorderWidth();
-    int borderHeight = this->layout->getBorderHeight();
-    int borderHorzDist = getBorderDrawDistance(borderWidth);
-    int borderVertDist = getBorderDrawDistance(borderHeight);
-    QPixmap pixmap = this->layout->renderBorder();
-    for (int y = -borderVertDist; y < this->layout->getHeight() + borderVertDist; y += borderHeight)
-    for (int x = -borderHorzDist; x < this->layout->getWidth() + borderHorzDist; x += borderWidth) {
-        QGraphicsPixmapItem *item = new QGraphicsPixmapItem(pixmap);
-        item->setX(x * 16);
-        item->setY(y * 16);
-        item->setZValue(-3);
-        scene->addItem(item);
-        borderItems.append(item);
-    }
+    border_item = new MapBorderItem(this->layout);
+    border_item->setZValue(-3);
+    border_item->draw();
+    scene->addItem(border_item);
 }
 
 void Editor::updateMapBorder() {
-    QPixmap pixmap = this->layout->renderBorder(true);
-    for (auto item : this->borderItems) {
-        item->setPixmap(pixmap);
-    }
+    if (border_item)
+        border_item->draw(true);
 }
 
-void Editor::updateMapConnections() {
-    for (auto item : connection_items)
+// Connection pixmaps are only re-rendered if the part of the connected map they show, or the tilesets and palettes used to draw it, changed.
+// 'forceRender' re-renders them regardless.
+void Editor::updateMapConnections(bool forceRender) {
+    for (auto item : connection_items) {
+        if (forceRender && item->connection)
+            item->connection->getPixmap(true);
         item->render(true);
-}
-
-int Editor::getBorderDrawDistance(int dimension) {
-    // Draw sufficient border blocks to fill the player's view (BORDER_DISTANCE)
-    if (dimension >= BORDER_DISTANCE) {
-        return dimension;
-    } else if (dimension) {
-        return dimension * (BORDER_DISTANCE / dimension + (BORDER_DISTANCE % dimension ? 1 : 0));
-    } else {
-        return BORDER_DISTANCE;
     }
 }
 
@@ -2018,9 +2008,9 @@ void Editor::updateBorderVisibility() {
 
     // Update border
     const qreal borderOpacity = editingConnections ? 0.4 : 1;
-    for (QGraphicsPixmapItem* item : borderItems) {
-        item->setVisible(visible);
-        item->setOpacity(borderOpacity);
+    if (border_item) {
+        border_item->setVisible(visible);
+        border_item->setOpacity(borderOpacity);
     }
 
     // Update map connections
@@ -2029,11 +2019,11 @@ void Editor::updateBorderVisibility() {
         item->setEditable(editingConnections);
         item->setEnabled(visible);
 
-        // When connecting a map to itself we don't bother to re-render the map connections in real-time,
+        // When connecting a map to itself we don't bother to update the map connections in real-time,
         // i.e. if the user paints a new metatile on the map this isn't immediately reflected in the connection.
-        // We're rendering them now, so we take the opportunity to do a full re-render for self-connections.
-        bool fullRender = (this->map && item->connection && this->map->name == item->connection->targetMapName());
-        item->render(fullRender);
+        // We're rendering them now, so we take the opportunity to pick up any changes. Connections that haven't
+        // changed reuse their previous render.
+        item->render(true);
     }
 }
 
@@ -2405,32 +2395,32 @@ void Editor::setCollisionGraphics() {
     if (this->movement_permissions_selector_item)
         this->movement_permissions_selector_item->setBasePixmap(this->collisionSheetPixmap);
 
-    for (auto sublist : collisionIcons)
-        qDeleteAll(sublist);
-    collisionIcons.clear();
-
-    // Use the image sheet to create an icon for each collision/elevation combination.
+    // Use the image sheet to create an atlas with an icon for each collision/elevation combination.
     // Any icons for combinations that aren't provided by the image sheet are also created now using default graphics.
+    // The map's collision view copies icons directly out of this atlas, so it uses the same format as the map's chunks.
     const int w = 16, h = 16;
     imgSheet = imgSheet.scaled(w * imgColumns, h * imgRows);
+    collisionAtlas = QImage(w * (Block::getMaxCollision() + 1), h * (Block::getMaxElevation() + 1), ChunkCache::imageFormat);
+    collisionAtlas.fill(Qt::transparent);
+    QPainter painter(&collisionAtlas);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
     for (int collision = 0; collision <= Block::getMaxCollision(); collision++) {
         // If (collision >= imgColumns) here, it's a valid collision value, but it is not represented with an icon on the image sheet.
         // In this case we just use the rightmost collision icon. This is mostly to support the vanilla case, where technically 0-3
         // are valid collision values, but 1-3 have the same meaning, so the vanilla collision selector image only has 2 columns.
         int x = ((collision < imgColumns) ? collision : (imgColumns - 1)) * w;
 
-        QList<const QImage*> sublist;
         for (int elevation = 0; elevation <= Block::getMaxElevation(); elevation++) {
+            const QPoint origin(collision * w, elevation * h);
             if (elevation < imgRows) {
-                // This elevation has an icon on the image sheet, add it to the list
-                int y = elevation * h;
-                sublist.append(new QImage(imgSheet.copy(x, y, w, h)));
+                // This elevation has an icon on the image sheet
+                painter.drawImage(origin, imgSheet, QRect(x, elevation * h, w, h));
             } else {
                 // This is a valid elevation value, but it has no icon on the image sheet.
                 // Give it a placeholder "?" icon (red if impassable, white otherwise)
-                sublist.append(new QImage(this->collisionPlaceholder.copy(x != 0 ? w : 0, 0, w, h)));
+                painter.drawImage(origin, this->collisionPlaceholder, QRect(x != 0 ? w : 0, 0, w, h));
             }
         }
-        collisionIcons.append(sublist);
     }
+    painter.end();
 }
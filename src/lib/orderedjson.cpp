@@ -24,6 +24,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 #include <limits>
 
 namespace poryjson {
@@ -43,43 +44,71 @@ struct NullStruct {
     bool operator<(NullStruct) const { return false; }
 };
 
+/* encode_utf8(pt, out)
+ *
+ * Encode pt as UTF-8 and add it to out.
+ */
+static void encode_utf8(long pt, QByteArray & out) {
+    if (pt < 0)
+        return;
+
+    if (pt < 0x80) {
+        out += static_cast<char>(pt);
+    } else if (pt < 0x800) {
+        out += static_cast<char>((pt >> 6) | 0xC0);
+        out += static_cast<char>((pt & 0x3F) | 0x80);
+    } else if (pt < 0x10000) {
+        out += static_cast<char>((pt >> 12) | 0xE0);
+        out += static_cast<char>(((pt >> 6) & 0x3F) | 0x80);
+        out += static_cast<char>((pt & 0x3F) | 0x80);
+    } else {
+        out += static_cast<char>((pt >> 18) | 0xF0);
+        out += static_cast<char>(((pt >> 12) & 0x3F) | 0x80);
+        out += static_cast<char>(((pt >> 6) & 0x3F) | 0x80);
+        out += static_cast<char>((pt & 0x3F) | 0x80);
+    }
+}
+
 /* * * * * * * * * * * * * * * * * * * *
  * Serialization
+ *
+ * Values are written as UTF-8 directly into one byte buffer. 'indent' is the nesting level of the value,
+ * and 'afterKey' is set when the value follows an object key on the same line, so it isn't indented.
  */
 
-static void dump(NullStruct, QString &out, int *indent) {
-    if (!out.endsWith(": ")) out += QString(*indent * 2, ' ');
+static inline void dump_indent(QByteArray &out, int indent) {
+    out.append(indent * 2, ' ');
+}
+
+static void dump(NullStruct, QByteArray &out, int indent, bool afterKey) {
+    if (!afterKey) dump_indent(out, indent);
     out += "null";
 }
 
-static void dump(double value, QString &out, int *indent) {
-    if (!out.endsWith(": ")) out += QString(*indent * 2, ' ');
+static void dump(double value, QByteArray &out, int indent, bool afterKey) {
+    if (!afterKey) dump_indent(out, indent);
     if (std::isfinite(value)) {
-        char buf[32];
-        snprintf(buf, sizeof buf, "%.17g", value);
-        out += buf;
+        out += QByteArray::number(value, 'g', 17);
     } else {
         out += "null";
     }
 }
 
-static void dump(int value, QString &out, int *indent) {
-    if (!out.endsWith(": ")) out += QString(*indent * 2, ' ');
-    char buf[32];
-    snprintf(buf, sizeof buf, "%d", value);
-    out += buf;
+static void dump(int value, QByteArray &out, int indent, bool afterKey) {
+    if (!afterKey) dump_indent(out, indent);
+    out += QByteArray::number(value);
 }
 
-static void dump(bool value, QString &out, int *indent) {
-    if (!out.endsWith(": ")) out += QString(*indent * 2, ' ');
+static void dump(bool value, QByteArray &out, int indent, bool afterKey) {
+    if (!afterKey) dump_indent(out, indent);
     out += value ? "true" : "false";
 }
 
-static void dump(const QString &value, QString &out, int *indent, bool isKey = false) {
-    if (!isKey && !out.endsWith(": ")) out += QString(*indent * 2, ' ');
+static void dump_string(const QString &value, QByteArray &out) {
     out += '"';
-    for (int i = 0; i < value.length(); i++) {
-        const char ch = value[i].unicode();
+    const int length = value.length();
+    for (int i = 0; i < length; i++) {
+        const ushort ch = value.at(i).unicode();
         if (ch == '\\') {
             out += "\\\\";
         } else if (ch == '"') {
@@ -94,63 +123,76 @@ static void dump(const QString &value, QString &out, int *indent, bool isKey = f
             out += "\\r";
         } else if (ch == '\t') {
             out += "\\t";
-        } else if (static_cast<uint8_t>(ch) <= 0x1f) {
+        } else if (ch <= 0x1f) {
             char buf[8];
             snprintf(buf, sizeof buf, "\\u%04x", ch);
             out += buf;
-        } else if (static_cast<uint8_t>(ch) == 0xe2 && static_cast<uint8_t>(value[i+1].unicode()) == 0x80
-                   && static_cast<uint8_t>(value[i+2].unicode()) == 0xa8) {
+        } else if (ch == 0x2028) {
             out += "\\u2028";
-            i += 2;
-        } else if (static_cast<uint8_t>(ch) == 0xe2 && static_cast<uint8_t>(value[i+1].unicode()) == 0x80
-                   && static_cast<uint8_t>(value[i+2].unicode()) == 0xa9) {
+        } else if (ch == 0x2029) {
             out += "\\u2029";
-            i += 2;
+        } else if (ch < 0x80) {
+            out += static_cast<char>(ch);
+        } else if (QChar::isHighSurrogate(ch) && i + 1 < length && QChar::isLowSurrogate(value.at(i + 1).unicode())) {
+            encode_utf8(QChar::surrogateToUcs4(ch, value.at(i + 1).unicode()), out);
+            i++;
+        } else if (QChar::isSurrogate(ch)) {
+            encode_utf8(0xFFFD, out); // Unpaired surrogate
         } else {
-            out += ch;
+            encode_utf8(ch, out);
         }
     }
     out += '"';
 }
 
-static void dump(const Json::array &values, QString &out, int *indent) {
+static void dump(const QString &value, QByteArray &out, int indent, bool afterKey) {
+    if (!afterKey) dump_indent(out, indent);
+    dump_string(value, out);
+}
+
+static void dump(const Json::array &values, QByteArray &out, int indent, bool afterKey) {
     bool first = true;
-    if (!out.endsWith(": ")) out += QString(*indent * 2, ' ');
+    if (!afterKey) dump_indent(out, indent);
     out += "[\n";
-    *indent += 1;
     for (const auto &value : values) {
         if (!first) {
             out += ",\n";
         }
-        value.dump(out, indent);
+        value.dump(out, indent + 1);
         first = false;
     }
-    *indent -= 1;
-    out += "\n" + QString(*indent * 2, ' ') + "]";
+    out += '\n';
+    dump_indent(out, indent);
+    out += ']';
 }
 
-static void dump(const Json::object &values, QString &out, int *indent) {
+static void dump(const Json::object &values, QByteArray &out, int indent, bool afterKey) {
     bool first = true;
-    if (!out.endsWith(": ")) out += QString(*indent * 2, ' ');
+    if (!afterKey) dump_indent(out, indent);
     out += "{\n";
-    *indent += 1;
-    for (auto kv : values) {
+    for (const auto &kv : values) {
         if (!first) {
             out += ",\n";
         }
-        out += QString(*indent * 2, ' ');
-        dump(kv.first, out, indent, true);
+        dump_indent(out, indent + 1);
+        dump_string(kv.first, out);
         out += ": ";
-        kv.second.dump(out, indent);
+        kv.second.dump(out, indent + 1, true);
         first = false;
     }
-    *indent -= 1;
-    out += "\n" + QString(*indent * 2, ' ') + "}";
+    out += '\n';
+    dump_indent(out, indent);
+    out += '}';
 }
 
+void Json::dump(QByteArray &out, int indent, bool afterKey) const {
+    m_ptr->dump(out, indent, afterKey);
+}
 
 void Json::dump(QString &out, int *indent) const {
-    m_ptr->dump(out, indent);
+    QByteArray bytes;
+    m_ptr->dump(bytes, *indent, out.endsWith(": "));
+    out += QString::fromUtf8(bytes);
 }
 
 /* * * * * * * * * * * * * * * * * * * *
@@ -179,7 +221,7 @@ protected:
     }
 
     const T m_value;
-    void dump(QString &out, int *indent) const override { poryjson::dump(m_value, out, indent); }
+    void dump(QByteArray &out, int indent, bool afterKey) const override { poryjson::dump(m_value, out, indent, afterKey); }
 };
 
 class JsonDouble final : public Value<Json::NUMBER, double> {
@@ -299,7 +341,7 @@ const Json &              JsonValue::operator[] (int)         const { return sta
 const Json &              JsonValue::operator[] (const QString &) const { return static_null(); }
 
 const Json & JsonObject::operator[] (const QString &key) const {
-    static auto iter = m_value.find(key);
+    auto iter = m_value.find(key);
     return (iter == m_value.end()) ? static_null() : (*iter).second;
 }
 const Json & JsonArray::operator[] (int i) const {
@@ -381,18 +423,28 @@ static inline bool in_range(long x, long lower, long upper) {
 namespace {
 /* JsonParser
  *
- * Object that tracks all state of an in-progress parse.
+ * Object that tracks all state of an in-progress parse. The input is read as UTF-8 bytes,
+ * and strings are only decoded once their extent is known.
  */
 struct JsonParser final {
 
     /* State
      */
-    const QString &str;
+    const char *str;
+    const int length;
     int i;
     QString &err;
     bool failed;
     const JsonParse strategy;
 
+    /* peek(offset)
+     *
+     * Return the character at the given offset from the current position, or 0 past the end of the input.
+     */
+    char peek(int offset = 0) const {
+        return (i + offset < length) ? str[i + offset] : static_cast<char>(0);
+    }
+
     /* fail(msg, err_ret = Json())
      *
      * Mark this parse as failed.
@@ -414,7 +466,7 @@ struct JsonParser final {
      * Advance until the current character is non-whitespace.
      */
     void consume_whitespace() {
-        while (i < str.length() && (str[i] == ' ' || str[i] == '\r' || str[i] == '\n' || str[i] == '\t'))
+        while (i < length && (str[i] == ' ' || str[i] == '\r' || str[i] == '\n' || str[i] == '\t'))
             i++;
     }
 
@@ -424,26 +476,26 @@ struct JsonParser final {
      */
     bool consume_comment() {
       bool comment_found = false;
-      if (str[i] == '/') {
+      if (peek() == '/') {
         i++;
-        if (i == str.size())
+        if (i == length)
           return fail("unexpected end of input after start of comment", false);
         if (str[i] == '/') { // inline comment
           i++;
           // advance until next line, or end of input
-          while (i < str.size() && str[i] != '\n') {
+          while (i < length && str[i] != '\n') {
             i++;
           }
           comment_found = true;
         }
         else if (str[i] == '*') { // multiline comment
           i++;
-          if (i > str.size()-2)
+          if (i > length-2)
             return fail("unexpected end of input inside multi-line comment", false);
           // advance until closing tokens
           while (!(str[i] == '*' && str[i+1] == '/')) {
             i++;
-            if (i > str.size()-2)
+            if (i > length-2)
               return fail(
                 "unexpected end of input inside multi-line comment", false);
           }
@@ -481,59 +533,47 @@ struct JsonParser final {
     char get_next_token() {
         consume_garbage();
         if (failed) return static_cast<char>(0);
-        if (i == str.size())
+        if (i == length)
             return fail("unexpected end of input", static_cast<char>(0));
 
-        return str[i++].unicode();
-    }
-
-    /* encode_utf8(pt, out)
-     *
-     * Encode pt as UTF-8 and add it to out.
-     */
-    void encode_utf8(long pt, QString & out) {
-        if (pt < 0)
-            return;
-
-        if (pt < 0x80) {
-            out += static_cast<char>(pt);
-        } else if (pt < 0x800) {
-            out += static_cast<char>((pt >> 6) | 0xC0);
-            out += static_cast<char>((pt & 0x3F) | 0x80);
-        } else if (pt < 0x10000) {
-            out += static_cast<char>((pt >> 12) | 0xE0);
-            out += static_cast<char>(((pt >> 6) & 0x3F) | 0x80);
-            out += static_cast<char>((pt & 0x3F) | 0x80);
-        } else {
-            out += static_cast<char>((pt >> 18) | 0xF0);
-            out += static_cast<char>(((pt >> 12) & 0x3F) | 0x80);
-            out += static_cast<char>(((pt >> 6) & 0x3F) | 0x80);
-            out += static_cast<char>((pt & 0x3F) | 0x80);
-        }
+        return str[i++];
     }
 
     /* parse_string()
      *
-     * Parse a QString, starting at the current position.
+     * Parse a string, starting at the current position.
      */
     QString parse_string() {
-        QString out;
+        // The usual case: no escapes, so the string can be decoded directly from the input.
+        const int start = i;
+        while (i < length && str[i] != '"' && str[i] != '\\') {
+            if (in_range(static_cast<uint8_t>(str[i]), 0, 0x1f))
+                return fail(QString("unescaped " + esc(str[i]) + " in string"), QString());
+            i++;
+        }
+        if (i == length)
+            return fail("unexpected end of input in string", QString());
+        if (str[i] == '"')
+            return QString::fromUtf8(str + start, (i++) - start);
+
+        // The string has escapes, collect its UTF-8 and decode it at the end.
+        QByteArray out(str + start, i - start);
         long last_escaped_codepoint = -1;
         while (true) {
-            if (i == str.size())
-                return fail("unexpected end of input in QString", "");
+            if (i == length)
+                return fail("unexpected end of input in string", QString());
 
-            char ch = str[i++].unicode();
+            char ch = str[i++];
 
             if (ch == '"') {
                 encode_utf8(last_escaped_codepoint, out);
-                return out;
+                return QString::fromUtf8(out);
             }
 
-            if (in_range(ch, 0, 0x1f))
-                return fail(QString("unescaped " + esc(ch) + " in QString"), QString());
+            if (in_range(static_cast<uint8_t>(ch), 0, 0x1f))
+                return fail(QString("unescaped " + esc(ch) + " in string"), QString());
 
-            // The usual case: non-escaped characters
+            // Non-escaped characters
             if (ch != '\\') {
                 encode_utf8(last_escaped_codepoint, out);
                 last_escaped_codepoint = -1;
@@ -542,27 +582,30 @@ struct JsonParser final {
             }
 
             // Handle escapes
-            if (i == str.size())
-                return fail("unexpected end of input in QString", "");
+            if (i == length)
+                return fail("unexpected end of input in string", QString());
 
-            ch = str[i++].unicode();
+            ch = str[i++];
 
             if (ch == 'u') {
                 // Extract 4-byte escape sequence
-                QString esc = str.right(i).left(4);
-                // Explicitly check length of the substring. The following loop
-                // relies on std::QString returning the terminating NUL when
-                // accessing str[length]. Checking here reduces brittleness.
-                if (esc.length() < 4) {
-                    return fail(QString("bad \\u escape: " + esc), "");
+                const QString escape = QString::fromUtf8(str + i, qMin(4, length - i));
+                if (length - i < 4)
+                    return fail(QString("bad \\u escape: " + escape), QString());
+
+                long codepoint = 0;
+                for (int j = 0; j < 4; j++) {
+                    const char digit = str[i + j];
+                    codepoint <<= 4;
+                    if (in_range(digit, '0', '9'))
+                        codepoint |= digit - '0';
+                    else if (in_range(digit, 'a', 'f'))
+                        codepoint |= digit - 'a' + 10;
+                    else if (in_range(digit, 'A', 'F'))
+                        codepoint |= digit - 'A' + 10;
+                    else
+                        return fail(QString("bad \\u escape: " + escape), QString());
                 }
-                for (unsigned j = 0; j < 4; j++) {
-                    if (!in_range(esc[j].unicode(), 'a', 'f') && !in_range(esc[j].unicode(), 'A', 'F')
-                            && !in_range(esc[j].unicode(), '0', '9'))
-                        return fail(QString("bad \\u escape: " + esc), "");
-                }
-
-                long codepoint = esc.toLong(nullptr, 16);
 
                 // JSON specifies that characters outside the BMP shall be encoded as a pair
                 // of 4-hex-digit \u escapes encoding their surrogate pair components. Check
@@ -600,7 +643,7 @@ struct JsonParser final {
             } else if (ch == '"' || ch == '\\' || ch == '/') {
                 out += ch;
             } else {
-                return fail(QString("invalid escape character " + esc(ch)), "");
+                return fail(QString("invalid escape character " + esc(ch)), QString());
             }
         }
     }
@@ -610,56 +653,59 @@ struct JsonParser final {
      * Parse a double.
      */
     Json parse_number() {
-        unsigned start_pos = i;
+        const int start_pos = i;
 
-        if (str[i] == '-')
+        if (peek() == '-')
             i++;
 
         // Integer part
-        if (str[i] == '0') {
+        if (peek() == '0') {
             i++;
-            if (in_range(str[i].unicode(), '0', '9'))
+            if (in_range(peek(), '0', '9'))
                 return fail("leading 0s not permitted in numbers");
-        } else if (in_range(str[i].unicode(), '1', '9')) {
+        } else if (in_range(peek(), '1', '9')) {
             i++;
-            while (in_range(str[i].unicode(), '0', '9'))
+            while (in_range(peek(), '0', '9'))
                 i++;
         } else {
-            return fail(QString("invalid " + esc(str[i].unicode()) + " in number"));
+            return fail(QString("invalid " + esc(peek()) + " in number"));
         }
 
-        if (str[i] != '.' && str[i] != 'e' && str[i] != 'E'
-                && (i - start_pos) <= static_cast<unsigned>(std::numeric_limits<int>::digits10)) {
-            bool ok;
-            return str.mid(start_pos, i - start_pos).toInt(&ok);
+        if (peek() != '.' && peek() != 'e' && peek() != 'E'
+                && (i - start_pos) <= std::numeric_limits<int>::digits10) {
+            // Short enough that it can't overflow, accumulate it directly.
+            const bool negative = (str[start_pos] == '-');
+            int value = 0;
+            for (int j = start_pos + (negative ? 1 : 0); j < i; j++)
+                value = value * 10 + (str[j] - '0');
+            return negative ? -value : value;
         }
 
         // Decimal part
-        if (str[i] == '.') {
+        if (peek() == '.') {
             i++;
-            if (!in_range(str[i].unicode(), '0', '9'))
+            if (!in_range(peek(), '0', '9'))
                 return fail("at least one digit required in fractional part");
 
-            while (in_range(str[i].unicode(), '0', '9'))
+            while (in_range(peek(), '0', '9'))
                 i++;
         }
 
         // Exponent part
-        if (str[i] == 'e' || str[i] == 'E') {
+        if (peek() == 'e' || peek() == 'E') {
             i++;
 
-            if (str[i] == '+' || str[i] == '-')
+            if (peek() == '+' || peek() == '-')
                 i++;
 
-            if (!in_range(str[i].unicode(), '0', '9'))
+            if (!in_range(peek(), '0', '9'))
                 return fail("at least one digit required in exponent");
 
-            while (in_range(str[i].unicode(), '0', '9'))
+            while (in_range(peek(), '0', '9'))
                 i++;
         }
 
-        bool ok;
-        return str.mid(start_pos, i - start_pos).toDouble(&ok);
+        return QByteArray::fromRawData(str + start_pos, i - start_pos).toDouble();
     }
 
     /* expect(str, res)
@@ -667,15 +713,16 @@ struct JsonParser final {
      * Expect that 'str' starts at the character that was just read. If it does, advance
      * the input and return res. If not, flag an error.
      */
-    Json expect(const QString &expected, Json res) {
+    Json expect(const char *expected, Json res) {
         assert(i != 0);
         i--;
-        QString result = str.right(str.size() - i).left(expected.length());
-        if (result == expected) {
-            i += expected.length();
+        const int expected_length = static_cast<int>(strlen(expected));
+        if (length - i >= expected_length && memcmp(str + i, expected, expected_length) == 0) {
+            i += expected_length;
             return res;
         } else {
-            return fail(QString("parse error: expected " + expected + ", got " + str.right(i).left(expected.length())));
+            return fail(QString("parse error: expected %1, got %2").arg(expected)
+                                                                   .arg(QString::fromUtf8(str + i, qMin(expected_length, length - i))));
         }
     }
 
@@ -739,7 +786,7 @@ struct JsonParser final {
 
                 ch = get_next_token();
             }
-            return data;
+            return std::move(data);
         }
 
         if (ch == '[') {
@@ -763,7 +810,7 @@ struct JsonParser final {
                 ch = get_next_token();
                 (void)ch;
             }
-            return data;
+            return std::move(data);
         }
 
         return fail(QString("expected value, got " + esc(ch)));
@@ -771,18 +818,24 @@ struct JsonParser final {
 };
 }//namespace {
 
-Json Json::parse(const QString &in, QString &err, JsonParse strategy) {
-    JsonParser parser { in, 0, err, false, strategy };
+Json Json::parse(const QByteArray &in, QString &err, JsonParse strategy) {
+    // Skip the UTF-8 byte order mark, if there is one.
+    const int start = in.startsWith("\xEF\xBB\xBF") ? 3 : 0;
+    JsonParser parser { in.constData(), static_cast<int>(in.size()), start, err, false, strategy };
     Json result = parser.parse_json(0);
 
     // Check for any trailing garbage
     parser.consume_garbage();
     if (parser.failed)
         return Json();
-    if (parser.i != in.size())
-        return parser.fail(QString("unexpected trailing " + esc(in[parser.i].unicode())));
+    if (parser.i != parser.length)
+        return parser.fail(QString("unexpected trailing " + esc(parser.str[parser.i])));
 
     return result;
 }
 
+Json Json::parse(const QString &in, QString &err, JsonParse strategy) {
+    return parse(in.toUtf8(), err, strategy);
+}
+
 } // namespace poryjson
@@ -1,8 +1,15 @@
 #include "log.h"
 #include <QDateTime>
 #include <QDir>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
 #include <QStandardPaths>
 #include <QSysInfo>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
 
 // Enabling this does not seem to be simple to color console output
 // on Windows for all CLIs without external libraries or extreme bloat.
@@ -18,19 +25,136 @@
     #define CLEAR_COLOR   "\033[0m"
 #endif
 
-void logInfo(QString message) {
-    log(message, LogType::LOG_INFO);
+// Callers wait for the writer if this many messages are waiting to be written.
+#define MAX_QUEUED_MESSAGES 10000
+
+// A repeated warning is only logged once in this many milliseconds. The number of repeats is logged with the next one.
+#define REPEAT_WINDOW_MS 5000
+
+struct LogRecord {
+    qint64 time;
+    LogType type;
+    QString message;
+    qint64 durationMs = -1;
+};
+
+// Messages are formatted and written to the console and the log file by a background thread,
+// which keeps the file open and writes everything that's waiting at once.
+class LogWriter : public QThread
+{
+public:
+    void push(const LogRecord &record, bool wait);
+    void flush();
+    bool removeFile();
+    void setStructured(bool structured);
+
+protected:
+    void run() override;
+
+private:
+    QMutex mutex;
+    QWaitCondition notEmpty;
+    QWaitCondition notFull;
+    QWaitCondition written;
+    QVector<LogRecord> queue;
+    quint64 numQueued = 0;
+    quint64 numWritten = 0;
+    bool structured = false;
+
+    // Only used by the writer thread, except while removing the file.
+    QMutex fileMutex;
+    QFile file;
+
+    void write(const QVector<LogRecord> &records, bool structured);
+};
+
+static LogWriter *logWriter() {
+    // This is never deleted, so it can still be used while static objects are being destroyed.
+    static LogWriter *writer = [] {
+        auto writer = new LogWriter;
+        writer->start(QThread::LowPriority);
+        return writer;
+    }();
+    return writer;
 }
 
-void logWarn(QString message) {
-    log(message, LogType::LOG_WARN);
+void LogWriter::push(const LogRecord &record, bool wait) {
+    QMutexLocker locker(&this->mutex);
+    while (this->queue.size() >= MAX_QUEUED_MESSAGES)
+        this->notFull.wait(&this->mutex);
+    this->queue.append(record);
+    const quint64 id = ++this->numQueued;
+    this->notEmpty.wakeOne();
+
+    while (wait && this->numWritten < id)
+        this->written.wait(&this->mutex);
 }
 
-static QString mostRecentError;
+void LogWriter::flush() {
+    QMutexLocker locker(&this->mutex);
+    const quint64 id = this->numQueued;
+    while (this->numWritten < id)
+        this->written.wait(&this->mutex);
+}
 
-void logError(QString message) {
-    mostRecentError = message;
-    log(message, LogType::LOG_ERROR);
+void LogWriter::setStructured(bool structured) {
+    QMutexLocker locker(&this->mutex);
+    this->structured = structured;
+}
+
+bool LogWriter::removeFile() {
+    flush();
+    QMutexLocker locker(&this->fileMutex);
+    this->file.close();
+    return QFile::remove(getLogPath());
+}
+
+void LogWriter::run() {
+    QVector<LogRecord> records;
+    forever {
+        bool structured;
+        {
+            QMutexLocker locker(&this->mutex);
+            while (this->queue.isEmpty())
+                this->notEmpty.wait(&this->mutex);
+            records.swap(this->queue);
+            structured = this->structured;
+            this->notFull.wakeAll();
+        }
+
+        write(records, structured);
+
+        QMutexLocker locker(&this->mutex);
+        this->numWritten += records.size();
+        this->written.wakeAll();
+        records.clear();
+    }
+}
+
+static QString typeString(LogType type) {
+    switch (type)
+    {
+    case LogType::LOG_INFO:
+        return " [INFO]";
+    case LogType::LOG_WARN:
+        return " [WARN]";
+    case LogType::LOG_ERROR:
+        return "[ERROR]";
+    }
+    return "";
+}
+
+static QString typeName(LogType type) {
+    switch (type)
+    {
+    case LogType::LOG_INFO:
+        return "info";
+    case LogType::LOG_WARN:
+        return "warn";
+    case LogType::LOG_ERROR:
+        return "error";
+    }
+    return "";
 }
 
 QString colorizeMessage(QString message, LogType type) {
@@ -50,29 +174,137 @@ QString colorizeMessage(QString message, LogType type) {
     return colorized;
 }
 
+void LogWriter::write(const QVector<LogRecord> &records, bool structured) {
+    QString fileText;
+    for (const LogRecord &record : records) {
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(record.time);
+        const QString message = QString("%1 %2 %3").arg(time.toString("yyyy-MM-dd HH:mm:ss")).arg(typeString(record.type)).arg(record.message);
+        qDebug().noquote() << colorizeMessage(message, record.type);
+
+        if (structured) {
+            QJsonObject object;
+            object["time"] = time.toString(Qt::ISODateWithMs);
+            object["level"] = typeName(record.type);
+            object["message"] = record.message;
+            if (record.durationMs >= 0)
+                object["duration_ms"] = record.durationMs;
+            fileText += QString::fromUtf8(QJsonDocument(object).toJson(QJsonDocument::Compact));
+        } else {
+            fileText += message;
+        }
+        fileText += "\n";
+    }
+
+    QMutexLocker locker(&this->fileMutex);
+    if (!this->file.isOpen()) {
+        this->file.setFileName(getLogPath());
+        if (!this->file.open(QIODevice::WriteOnly | QIODevice::Append))
+            return;
+    }
+    this->file.write(fileText.toUtf8());
+    this->file.flush();
+}
+
+static QString mostRecentError;
+
+// Project assets may be loaded and saved on worker threads, which log their errors as well.
+static QMutex logMutex;
+
+struct RepeatedMessage {
+    qint64 windowStart;
+    int suppressed;
+};
+static QHash<QString, RepeatedMessage> recentWarnings;
+
+void logInfo(QString message) {
+    log(message, LogType::LOG_INFO);
+}
+
+void logWarn(QString message) {
+    log(message, LogType::LOG_WARN);
+}
+
+void logError(QString message) {
+    logMutex.lock();
+    mostRecentError = message;
+    logMutex.unlock();
+    log(message, LogType::LOG_ERROR);
+}
+
+// Returns false if the warning was logged too recently, otherwise adds how many times it was left out since.
+static bool shouldLogWarning(QString *message, qint64 time) {
+    QMutexLocker locker(&logMutex);
+    auto it = recentWarnings.find(*message);
+    if (it == recentWarnings.end()) {
+        // The warnings are only remembered for a short time, so there's no need to keep old ones.
+        if (recentWarnings.size() >= 1000)
+            recentWarnings.clear();
+        recentWarnings.insert(*message, {time, 0});
+        return true;
+    }
+    if (time - it->windowStart < REPEAT_WINDOW_MS) {
+        it->suppressed++;
+        return false;
+    }
+    if (it->suppressed > 0)
+        message->append(QString(" (repeated %1 more times)").arg(it->suppressed));
+    it->windowStart = time;
+    it->suppressed = 0;
+    return true;
+}
+
+static void logRecord(LogRecord record) {
+    if (record.type == LogType::LOG_WARN && !shouldLogWarning(&record.message, record.time))
+        return;
+    // Errors are usually followed by a message pointing the user to the log, so they're written right away.
+    logWriter()->push(record, record.type == LogType::LOG_ERROR);
+}
+
 void log(QString message, LogType type) {
-    QString now = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss");
-    QString typeString = "";
-    switch (type)
-    {
-    case LogType::LOG_INFO:
-        typeString = " [INFO]";
-        break;
-    case LogType::LOG_WARN:
-        typeString = " [WARN]";
-        break;
-    case LogType::LOG_ERROR:
-        typeString = "[ERROR]";
-        break;
+    LogRecord record;
+    record.time = QDateTime::currentMSecsSinceEpoch();
+    record.type = type;
+    record.message = message;
+    logRecord(record);
+}
+
+// Waits until everything that's been logged so far has been written to the log file.
+void flushLog() {
+    // Note how many times any warnings were left out, since they may not be logged again.
+    QVector<LogRecord> repeats;
+    logMutex.lock();
+    for (auto it = recentWarnings.begin(); it != recentWarnings.end(); it++) {
+        if (it->suppressed == 0)
+            continue;
+        LogRecord record;
+        record.time = QDateTime::currentMSecsSinceEpoch();
+        record.type = LogType::LOG_WARN;
+        record.message = QString("%1 (repeated %2 more times)").arg(it.key()).arg(it->suppressed);
+        repeats.append(record);
+        it->suppressed = 0;
     }
+    logMutex.unlock();
+    for (const LogRecord &record : repeats)
+        logWriter()->push(record, false);
 
-    message = QString("%1 %2 %3").arg(now).arg(typeString).arg(message);
+    logWriter()->flush();
+}
+
+void setLogStructured(bool structured) {
+    logWriter()->setStructured(structured);
+}
+
+LogTimer::LogTimer(const QString &name) : name(name) {
+    this->timer.start();
+}
 
-    qDebug().noquote() << colorizeMessage(message, type);
-    QFile outFile(getLogPath());
-    outFile.open(QIODevice::WriteOnly | QIODevice::Append);
-    QTextStream ts(&outFile);
-    ts << message << Qt::endl;
+LogTimer::~LogTimer() {
+    LogRecord record;
+    record.time = QDateTime::currentMSecsSinceEpoch();
+    record.type = LogType::LOG_INFO;
+    record.durationMs = this->timer.elapsed();
+    record.message = QString("%1 took %2 ms").arg(this->name).arg(record.durationMs);
+    logRecord(record);
 }
 
 QString getLogPath() {
@@ -84,6 +316,7 @@ QString getLogPath() {
 }
 
 QString getMostRecentError() {
+    QMutexLocker locker(&logMutex);
     return mostRecentError;
 }
 
@@ -92,7 +325,7 @@ bool cleanupLargeLog() {
     if (logFile.size() < 20000000)
         return false;
 
-    bool removed = logFile.remove();
+    bool removed = logWriter()->removeFile();
     if (removed)
         logWarn(QString("Previous log file %1 was cleared due to being over 20MB in size.").arg(getLogPath()));
     return removed;
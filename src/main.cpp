@@ -1,13 +1,31 @@
 #include "mainwindow.h"
+#include "commandline.h"
+#include "config.h"
+#include "log.h"
+#include "tracer.h"
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
+    if (CommandLine::isCommand(argc, argv)) {
+        CommandLine::prepare();
+        QApplication a(argc, argv);
+        int result = CommandLine::run(a.arguments());
+        savePendingConfigs();
+        Tracer::finish();
+        flushLog();
+        return result;
+    }
+
     QGuiApplication::setHighDpiScaleFactorRoundingPolicy(Qt::HighDpiScaleFactorRoundingPolicy::Round);
     QApplication a(argc, argv);
     a.setStyle("fusion");
     MainWindow w(nullptr);
     w.show();
 
-    return a.exec();
+    int result = a.exec();
+    savePendingConfigs();
+    Tracer::finish();
+    flushLog();
+    return result;
 }
@@ -18,6 +18,8 @@
 #include "prefab.h"
 #include "montabwidget.h"
 #include "imageexport.h"
+#include "imagecache.h"
+#include "tracer.h"
 #include "maplistmodels.h"
 #include "eventfilters.h"
 #include "newmapconnectiondialog.h"
@@ -34,6 +36,7 @@
 #include <QScrollBar>
 #include <QPushButton>
 #include <QMessageBox>
+#include <QInputDialog>
 #include <QDialogButtonBox>
 #include <QScroller>
 #include <math.h>
@@ -115,6 +118,9 @@ void MainWindow::setWindowDisabled(bool disabled) {
 
 void MainWindow::initWindow() {
     porymapConfig.load();
+    ImageCache::setBudget(static_cast<qint64>(porymapConfig.imageCacheSize) * 1024 * 1024);
+    setLogStructured(porymapConfig.structuredLog);
+    Tracer::init(porymapConfig.performanceTracing);
     this->initCustomUI();
     this->initExtraSignals();
     this->initEditor();
@@ -452,13 +458,18 @@ void MainWindow::updateWindowTitle() {
             .arg(projectName)
         );
     }
+}
 
+// The Map tab's icon is a thumbnail of the open layout. It's only remade when a layout is opened or saved, not on every edit.
+void MainWindow::updateMapTabIcon() {
     // For some reason (perhaps on Qt < 6?) we had to clear the icon first here or mainTabBar wouldn't display correctly.
     ui->mainTabBar->setTabIcon(MainTab::Map, QIcon());
 
-    QPixmap pixmap = editor->layout->pixmap;
-    if (!pixmap.isNull()) {
-        ui->mainTabBar->setTabIcon(MainTab::Map, QIcon(pixmap));
+    QImage thumbnail;
+    if (editor && editor->layout && editor->layout->layoutItem)
+        thumbnail = editor->layout->layoutItem->thumbnail(64);
+    if (!thumbnail.isNull()) {
+        ui->mainTabBar->setTabIcon(MainTab::Map, QIcon(QPixmap::fromImage(thumbnail)));
     } else {
         ui->mainTabBar->setTabIcon(MainTab::Map, QIcon(QStringLiteral(":/icons/map.ico")));
     }
@@ -598,6 +609,13 @@ bool MainWindow::openProject(QString dir, bool initial) {
     connect(project, &Project::fileChanged, this, &MainWindow::showFileWatcherWarning);
     connect(project, &Project::mapLoaded, this, &MainWindow::onMapLoaded);
     connect(project, &Project::mapSectionIdNamesChanged, this, &MainWindow::refreshLocationsComboBox);
+    connect(project, &Project::eventGraphicsChanged, this, [this] {
+        // Event spritesheets were loaded or edited, redraw the open map's events with the new sprites.
+        if (!this->editor->events_group)
+            return;
+        for (DraggablePixmapItem *item : this->editor->getObjects())
+            item->updatePixmap();
+    });
     this->editor->setProject(project);
 
     // Make sure project looks reasonable before attempting to load it
@@ -868,6 +886,7 @@ bool MainWindow::setMap(QString map_name) {
     refreshMapScene();
     displayMapProperties();
     updateWindowTitle();
+    updateMapTabIcon();
     updateMapList();
     resetMapListFilters();
 
@@ -929,6 +948,7 @@ bool MainWindow::setLayout(QString layoutId) {
 
     refreshMapScene();
     updateWindowTitle();
+    updateMapTabIcon();
     updateMapList();
     resetMapListFilters();
 
@@ -1605,7 +1625,23 @@ void MainWindow::onNewMapCreated() {
     editor->project->saveMap(newMap);
     editor->project->saveAllDataStructures();
 
-    // Add new Map / Layout to the mapList models
+    insertNewMapItems(newMap, newMapGroup, existingLayout);
+
+    setMap(newMapName);
+
+    if (newMap->needsHealLocation) {
+        addNewEvent(Event::Type::HealLocation);
+        editor->project->saveHealLocations(newMap);
+        editor->save();
+    }
+
+    disconnect(this->newMapPrompt, &NewMapPopup::applied, this, &MainWindow::onNewMapCreated);
+    delete newMap;
+}
+
+// Add a new Map / Layout to the map list models and combo boxes.
+void MainWindow::insertNewMapItems(Map *newMap, int newMapGroup, bool existingLayout) {
+    const QString newMapName = newMap->name;
     this->mapGroupModel->insertMapItem(newMapName, editor->project->groupNames[newMapGroup]);
     this->mapAreaModel->insertMapItem(newMapName, newMap->location, newMapGroup);
     this->layoutTreeModel->insertMapItem(newMapName, newMap->layout->id);
@@ -1628,17 +1664,6 @@ void MainWindow::onNewMapCreated() {
             ui->comboBox_LayoutSelector->insertItem(layoutIndex, newMap->layout->id);
         }
     }
-
-    setMap(newMapName);
-
-    if (newMap->needsHealLocation) {
-        addNewEvent(Event::Type::HealLocation);
-        editor->project->saveHealLocations(newMap);
-        editor->save();
-    }
-
-    disconnect(this->newMapPrompt, &NewMapPopup::applied, this, &MainWindow::onNewMapCreated);
-    delete newMap;
 }
 
 void MainWindow::openNewMapPopupWindow() {
@@ -1861,40 +1886,52 @@ void MainWindow::openMapListItem(const QModelIndex &index) {
 }
 
 void MainWindow::updateMapList() {
+    // Only maps and layouts that have been loaded can have their icons change (opened, edited or saved),
+    // so those are the only rows that are updated.
+    const QStringList loadedMaps = this->editor->project->mapCache.keys();
+    QStringList loadedLayouts;
+    for (auto it = this->editor->project->mapLayouts.cbegin(); it != this->editor->project->mapLayouts.cend(); it++) {
+        if (it.value() && it.value()->loaded)
+            loadedLayouts.append(it.key());
+    }
+
     if (this->editor->map) {
         this->mapGroupModel->setMap(this->editor->map->name);
-        this->groupListProxyModel->layoutChanged();
         this->mapAreaModel->setMap(this->editor->map->name);
-        this->areaListProxyModel->layoutChanged();
     } else {
         this->mapGroupModel->setMap(QString());
-        this->groupListProxyModel->layoutChanged();
         this->ui->mapList->clearSelection();
         this->mapAreaModel->setMap(QString());
-        this->areaListProxyModel->layoutChanged();
         this->ui->areaList->clearSelection();
     }
+    this->mapGroupModel->updateItemIcons(loadedMaps);
+    this->mapAreaModel->updateItemIcons(loadedMaps);
 
     if (this->editor->layout) {
         this->layoutTreeModel->setLayout(this->editor->layout->id);
-        this->layoutListProxyModel->layoutChanged();
     } else {
         this->layoutTreeModel->setLayout(QString());
-        this->layoutListProxyModel->layoutChanged();
         this->ui->layoutList->clearSelection();
     }
+    this->layoutTreeModel->updateItemIcons(loadedLayouts);
 }
 
 void MainWindow::on_action_Save_Project_triggered() {
     editor->saveProject();
     updateWindowTitle();
+    updateMapTabIcon();
     updateMapList();
+    if (this->validationReport)
+        this->validationReport->validateAll();
 }
 
 void MainWindow::on_action_Save_triggered() {
     editor->save();
     updateWindowTitle();
+    updateMapTabIcon();
     updateMapList();
+    if (this->validationReport && editor->map)
+        this->validationReport->revalidateMap(editor->map->name);
 }
 
 void MainWindow::duplicate() {
@@ -2606,7 +2643,9 @@ void MainWindow::on_slider_EmergeMapOpacity_valueChanged(int value) {
 void MainWindow::on_horizontalSlider_CollisionTransparency_valueChanged(int value) {
     this->editor->collisionOpacity = static_cast<qreal>(value) / 100;
     porymapConfig.collisionOpacity = value;
-    this->editor->collision_item->draw(true);
+    // Opacity is applied when the collision view is composited onto the map, the collision chunks don't need to be redrawn.
+    if (this->editor->collision_item)
+        this->editor->collision_item->setOpacity(this->editor->collisionOpacity);
 }
 
 void MainWindow::on_toolButton_Paint_clicked()
@@ -2867,6 +2906,111 @@ void MainWindow::importMapFromAdvanceMap1_92()
     this->newMapPrompt->init(mapLayout);
 }
 
+void MainWindow::on_actionImport_Maps_from_Advance_Map_1_92_Folder_triggered(){
+    importMapsFromAdvanceMap1_92Folder();
+}
+
+// Imports every .map file in a folder as a new map. The files are parsed in parallel, and nothing is added
+// to the project until they've all been read. The new maps share the project's existing tilesets.
+void MainWindow::importMapsFromAdvanceMap1_92Folder()
+{
+    Project *project = editor->project;
+    QString dirPath = FileDialog::getExistingDirectory(this, "Import Maps from Advance Map 1.92 Folder");
+    if (dirPath.isEmpty()) {
+        return;
+    }
+
+    QDir dir(dirPath);
+    QStringList filepaths;
+    for (const QString &filename : dir.entryList({"*.map"}, QDir::Files, QDir::Name))
+        filepaths.append(dir.absoluteFilePath(filename));
+    if (filepaths.isEmpty()) {
+        QMessageBox::warning(this, "Import Maps", "The selected folder doesn't contain any Advance Map 1.92 .map files.");
+        return;
+    }
+
+    bool ok = false;
+    QString groupName = QInputDialog::getItem(this, "Import Maps",
+                                              QString("Add the %1 imported maps to map group:").arg(filepaths.length()),
+                                              project->groupNames, 0, false, &ok);
+    if (!ok) {
+        return;
+    }
+    int group = project->groupNames.indexOf(groupName);
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    MapParser parser;
+    QList<Layout *> layouts = parser.parseAll(filepaths, project);
+    QApplication::restoreOverrideCursor();
+
+    int numFailed = layouts.count(nullptr);
+    if (numFailed > 0) {
+        QMessageBox msgBox(this);
+        msgBox.setText(QString("Failed to import %1 of %2 Advance Map 1.92 .map files.").arg(numFailed).arg(filepaths.length()));
+        msgBox.setInformativeText("Some .map files could not be processed. View porymap.log for specific errors.");
+        msgBox.setIcon(QMessageBox::Icon::Critical);
+        if (numFailed == layouts.length()) {
+            msgBox.setStandardButtons(QMessageBox::Ok);
+            msgBox.exec();
+            return;
+        }
+        QPushButton *importButton = msgBox.addButton(QString("Import the other %1").arg(layouts.length() - numFailed), QMessageBox::AcceptRole);
+        msgBox.addButton(QMessageBox::Cancel);
+        msgBox.setDefaultButton(QMessageBox::Cancel);
+        msgBox.exec();
+        if (msgBox.clickedButton() != importButton) {
+            qDeleteAll(layouts);
+            return;
+        }
+    }
+
+    // Add all of the maps first, then write the shared data files once at the end.
+    static const QRegularExpression re_invalidChars("[^a-zA-Z0-9_]+");
+    static const QRegularExpression re_NaN("^[0-9]*");
+    QString basePath = projectConfig.getFilePath(ProjectFilePath::data_layouts_folders);
+    QList<Map *> newMaps;
+    for (int i = 0; i < layouts.length(); i++) {
+        Layout *layout = layouts.at(i);
+        if (!layout)
+            continue;
+
+        QString mapName = QFileInfo(filepaths.at(i)).completeBaseName().remove(re_invalidChars).remove(re_NaN);
+        if (mapName.isEmpty() || project->mapNames.contains(mapName) || project->mapLayouts.contains(Layout::layoutConstantFromName(mapName))) {
+            mapName = project->getNewMapName();
+        }
+
+        layout->id = Layout::layoutConstantFromName(mapName);
+        layout->name = QString("%1_Layout").arg(mapName);
+        layout->border_path = QString("%1%2/border.bin").arg(basePath, mapName);
+        layout->blockdata_path = QString("%1%2/map.bin").arg(basePath, mapName);
+
+        Map *newMap = new Map;
+        newMap->name = mapName;
+        newMap->type = project->mapTypes.value(0, "0");
+        newMap->location = project->mapSectionIdNames.value(0, "0");
+        newMap->song = project->defaultSong;
+        newMap->requiresFlash = false;
+        newMap->weather = project->weatherNames.value(0, "0");
+        newMap->show_location = true;
+        newMap->allowRunning = true;
+        newMap->allowBiking = true;
+        newMap->allowEscaping = true;
+        newMap->battle_scene = project->mapBattleScenes.value(0, "0");
+        newMap->layout = layout;
+        newMap->layoutId = layout->id;
+
+        newMap = project->addNewMapToGroup(mapName, group, newMap, false, true);
+        project->saveMap(newMap);
+        insertNewMapItems(newMap, group, false);
+        newMaps.append(newMap);
+    }
+    project->saveAllDataStructures();
+    logInfo(QString("Imported %1 maps from Advance Map 1.92 .map files in '%2'.").arg(newMaps.length()).arg(dirPath));
+
+    // Like with a single new map, the map is reloaded from its files when it's opened.
+    qDeleteAll(newMaps);
+}
+
 void MainWindow::showExportMapImageWindow(ImageExporterMode mode) {
     if (!editor->project) return;
 
@@ -3130,6 +3274,7 @@ void MainWindow::on_actionAbout_Porymap_triggered()
 }
 
 void MainWindow::on_actionOpen_Log_File_triggered() {
+    flushLog();
     const QString logPath = getLogPath();
     const int lineCount = ParseUtil::textFileLineCount(logPath);
     this->editor->openInTextEditor(logPath, lineCount);
@@ -3161,6 +3306,8 @@ void MainWindow::togglePreferenceSpecificUi() {
 
     if (this->updatePromoter)
         this->updatePromoter->updatePreferences();
+
+    Tracer::setEnabled(porymapConfig.performanceTracing);
 }
 
 void MainWindow::openProjectSettingsEditor(int tab) {
@@ -3210,6 +3357,35 @@ void MainWindow::on_actionCustom_Scripts_triggered() {
     openSubWindow(this->customScriptsEditor);
 }
 
+void MainWindow::on_actionScript_Callback_Stats_triggered() {
+    if (!this->scriptStatsDialog)
+        this->scriptStatsDialog = new ScriptStatsDialog(this);
+
+    openSubWindow(this->scriptStatsDialog);
+}
+
+void MainWindow::on_actionValidate_Project_triggered() {
+    if (!this->validationReport) {
+        this->validationReport = new ValidationReport(this->editor->project, this);
+        connect(this->validationReport, &ValidationReport::jumpTo, [this](const ValidationIssue &issue) {
+            if (!issue.mapName.isEmpty()) {
+                if (!userSetMap(issue.mapName))
+                    return;
+            } else if (!issue.layoutId.isEmpty()) {
+                if (!userSetLayout(issue.layoutId))
+                    return;
+            } else {
+                return;
+            }
+            if (issue.position.x() >= 0 && issue.position.y() >= 0)
+                ui->graphicsView_Map->centerOn(issue.position.x() * 16 + 8, issue.position.y() * 16 + 8);
+        });
+        this->validationReport->validateAll();
+    }
+
+    openSubWindow(this->validationReport);
+}
+
 void MainWindow::initCustomScriptsEditor() {
     this->customScriptsEditor = new CustomScriptsEditor(this);
     connect(this->customScriptsEditor, &CustomScriptsEditor::reloadScriptEngine,
@@ -3394,6 +3570,14 @@ bool MainWindow::closeSupplementaryWindows() {
         return false;
     this->customScriptsEditor = nullptr;
 
+    if (this->scriptStatsDialog && !this->scriptStatsDialog->close())
+        return false;
+    this->scriptStatsDialog = nullptr;
+
+    if (this->validationReport && !this->validationReport->close())
+        return false;
+    this->validationReport = nullptr;
+
     if (this->wildMonChart && !this->wildMonChart->close())
         return false;
     this->wildMonChart = nullptr;
@@ -3425,9 +3609,11 @@ bool MainWindow::closeProject() {
         }
     }
     editor->closeProject();
+    ImageCache::clear();
     clearProjectUI();
     setWindowDisabled(true);
     updateWindowTitle();
+    updateMapTabIcon();
 
     return true;
 }
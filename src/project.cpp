@@ -10,6 +10,10 @@
 #include "filedialog.h"
 
 #include "orderedjson.h"
+#include "indexedpng.h"
+#include "imagecache.h"
+#include "identifierlistmodel.h"
+#include "tracer.h"
 
 #include <QDir>
 #include <QJsonArray>
@@ -21,6 +25,8 @@
 #include <QStandardItem>
 #include <QMessageBox>
 #include <QRegularExpression>
+#include <QImageReader>
+#include <QtConcurrent>
 #include <algorithm>
 
 using OrderedJson = poryjson::Json;
@@ -35,10 +41,15 @@ int Project::max_map_data_size = 10240; // 0x2800
 int Project::default_map_size = 20;
 int Project::max_object_events = 64;
 
+// The number of projects that exist. The symbol table is shared by all of them, so it's cleared once the last one is deleted.
+static int numProjects = 0;
+
 Project::Project(QObject *parent) :
     QObject(parent)
 {
+    numProjects++;
     QObject::connect(&this->fileWatcher, &QFileSystemWatcher::fileChanged, this, &Project::fileChanged);
+    QObject::connect(&this->spritesheetWatcher, &QFileSystemWatcher::fileChanged, this, &Project::reloadSpritesheet);
 }
 
 Project::~Project()
@@ -47,6 +58,10 @@ Project::~Project()
     clearTilesetCache();
     clearMapLayouts();
     clearEventGraphics();
+
+    // The symbols used by this project's events and encounters were deleted above.
+    if (--numProjects == 0)
+        SymbolTable::clear();
 }
 
 void Project::set_root(QString dir) {
@@ -77,6 +92,8 @@ bool Project::sanityCheck() {
 }
 
 bool Project::load() {
+    LogTimer timer("Loading project data");
+    TRACE_SCOPE("Project::load");
     this->disabledSettingsNames.clear();
     bool success = readMapLayouts()
                 && readRegionMapSections()
@@ -107,9 +124,39 @@ bool Project::load() {
                 && readSongNames()
                 && readMapGroups();
     applyParsedLimits();
+    internIdentifiers();
     return success;
 }
 
+// The identifier lists are mostly used as the options for the event and encounter fields, which store their values
+// in the symbol table. Sharing the table's copy of each name means each name is only stored once.
+void Project::internIdentifiers() {
+    SymbolTable::intern(&this->itemNames);
+    SymbolTable::intern(&this->flagNames);
+    SymbolTable::intern(&this->varNames);
+    SymbolTable::intern(&this->movementTypes);
+    SymbolTable::intern(&this->weatherNames);
+    SymbolTable::intern(&this->coordEventWeatherNames);
+    SymbolTable::intern(&this->secretBaseIds);
+    SymbolTable::intern(&this->bgEventFacingDirections);
+    SymbolTable::intern(&this->trainerTypes);
+    SymbolTable::intern(&this->globalScriptLabels);
+    SymbolTable::intern(&this->songNames);
+    SymbolTable::intern(&this->mapNames);
+    SymbolTable::intern(&this->gfxDefineNames);
+}
+
+IdentifierListModel *Project::getIdentifierModel(const QStringList &list) {
+    IdentifierListModel *model = this->identifierModels.value(&list);
+    if (!model) {
+        model = new IdentifierListModel(this);
+        this->identifierModels.insert(&list, model);
+    }
+    // If the list has been re-read or edited since it was last requested the model is reset, otherwise this does nothing.
+    model->setStrings(list);
+    return model;
+}
+
 QString Project::getProjectTitle() {
     if (!root.isNull()) {
         return root.section('/', -1);
@@ -195,6 +242,7 @@ QSet<QString> Project::getTopLevelMapFields() {
 }
 
 bool Project::loadMapData(Map* map) {
+    TRACE_SCOPE("Project::loadMapData");
     if (!map->isPersistedToFile) {
         return true;
     }
@@ -444,6 +492,7 @@ Layout *Project::createNewLayout(Layout::SimpleSettings &layoutSettings) {
 }
 
 bool Project::loadLayout(Layout *layout) {
+    TRACE_SCOPE("Project::loadLayout");
     if (!layout->loaded) {
         // Force these to run even if one fails
         bool loadedTilesets = loadLayoutTilesets(layout);
@@ -501,6 +550,7 @@ void Project::clearMapLayouts() {
 }
 
 bool Project::readMapLayouts() {
+    TRACE_SCOPE("Project::readMapLayouts");
     clearMapLayouts();
 
     QString layoutsFilepath = projectConfig.getFilePath(ProjectFilePath::json_layouts);
@@ -794,34 +844,24 @@ void Project::saveWildMonData() {
     }
     monHeadersObject["fields"] = fieldsInfoArray;
 
+    // Maps whose encounters were never opened are written back exactly as they were read.
+    // Maps that were loaded have all of their groups written in place of their first original entry.
     OrderedJson::array encountersArray;
-    for (auto keyPair : wildMonData) {
-        QString key = keyPair.first;
-        for (auto grouplLabelPair : wildMonData[key]) {
-            QString groupLabel = grouplLabelPair.first;
-            OrderedJson::object encounterObject;
-            encounterObject["map"] = key;
-            encounterObject["base_label"] = groupLabel;
-
-            WildPokemonHeader encounterHeader = wildMonData[key][groupLabel];
-            for (auto fieldNamePair : encounterHeader.wildMons) {
-                QString fieldName = fieldNamePair.first;
-                OrderedJson::object fieldObject;
-                WildMonInfo monInfo = encounterHeader.wildMons[fieldName];
-                fieldObject["encounter_rate"] = monInfo.encounterRate;
-                OrderedJson::array monArray;
-                for (WildPokemon wildMon : monInfo.wildPokemon) {
-                    OrderedJson::object monEntry;
-                    monEntry["min_level"] = wildMon.minLevel;
-                    monEntry["max_level"] = wildMon.maxLevel;
-                    monEntry["species"] = wildMon.species;
-                    monArray.push_back(monEntry);
-                }
-                fieldObject["mons"] = monArray;
-                encounterObject[fieldName] = fieldObject;
-            }
-            encountersArray.push_back(encounterObject);
-        }
+    QSet<QString> writtenMaps;
+    for (const OrderedJson &encounterObj : this->wildMonEntries) {
+        const QString mapConstant = encounterObj["map"].string_value();
+        auto it = this->wildMonData.find(mapConstant);
+        if (it == this->wildMonData.end()) {
+            encountersArray.push_back(encounterObj);
+        } else if (!writtenMaps.contains(mapConstant)) {
+            appendWildMonEntries(&encountersArray, mapConstant, it->second);
+            writtenMaps.insert(mapConstant);
+        }
+    }
+    // Add any groups that were created for maps that had none.
+    for (const auto &keyPair : this->wildMonData) {
+        if (!writtenMaps.contains(keyPair.first))
+            appendWildMonEntries(&encountersArray, keyPair.first, keyPair.second);
     }
     monHeadersObject["encounters"] = encountersArray;
     wildEncounterGroups.push_back(monHeadersObject);
@@ -840,6 +880,32 @@ void Project::saveWildMonData() {
     wildEncountersFile.close();
 }
 
+void Project::appendWildMonEntries(OrderedJson::array *encounters, const QString &mapConstant, const tsl::ordered_map<QString, WildPokemonHeader> &groups) const {
+    for (const auto &groupLabelPair : groups) {
+        OrderedJson::object encounterObject;
+        encounterObject["map"] = mapConstant;
+        encounterObject["base_label"] = groupLabelPair.first;
+
+        const WildPokemonHeader &encounterHeader = groupLabelPair.second;
+        for (const auto &fieldNamePair : encounterHeader.wildMons) {
+            OrderedJson::object fieldObject;
+            const WildMonInfo &monInfo = fieldNamePair.second;
+            fieldObject["encounter_rate"] = monInfo.encounterRate;
+            OrderedJson::array monArray;
+            for (const WildPokemon &wildMon : monInfo.wildPokemon) {
+                OrderedJson::object monEntry;
+                monEntry["min_level"] = wildMon.minLevel;
+                monEntry["max_level"] = wildMon.maxLevel;
+                monEntry["species"] = wildMon.species.toString();
+                monArray.push_back(monEntry);
+            }
+            fieldObject["mons"] = monArray;
+            encounterObject[fieldNamePair.first] = fieldObject;
+        }
+        encounters->push_back(encounterObject);
+    }
+}
+
 void Project::saveMapConstantsHeader() {
     QString text = QString("#ifndef GUARD_CONSTANTS_MAP_GROUPS_H\n");
     text += QString("#define GUARD_CONSTANTS_MAP_GROUPS_H\n");
@@ -1005,15 +1071,23 @@ void Project::saveHealLocationsConstants() {
 }
 
 void Project::saveTilesets(Tileset *primaryTileset, Tileset *secondaryTileset) {
+    TRACE_SCOPE("Project::saveTilesets");
+    // Encoding the tiles images and writing the palettes only read from the tilesets,
+    // so they're done on worker threads while the rest of the tileset data is written here.
+    QList<QFuture<void>> assetWrites;
+    for (Tileset *tileset : {primaryTileset, secondaryTileset}) {
+        assetWrites.append(QtConcurrent::run([this, tileset] { saveTilesetTilesImage(tileset); }));
+        assetWrites.append(QtConcurrent::run([this, tileset] { saveTilesetPalettes(tileset); }));
+    }
+
     saveTilesetMetatileLabels(primaryTileset, secondaryTileset);
     saveTilesetMetatileAttributes(primaryTileset);
     saveTilesetMetatileAttributes(secondaryTileset);
     saveTilesetMetatiles(primaryTileset);
     saveTilesetMetatiles(secondaryTileset);
-    saveTilesetTilesImage(primaryTileset);
-    saveTilesetTilesImage(secondaryTileset);
-    saveTilesetPalettes(primaryTileset);
-    saveTilesetPalettes(secondaryTileset);
+
+    for (auto &future : assetWrites)
+        future.waitForFinished();
 }
 
 void Project::updateTilesetMetatileLabels(Tileset *tileset) {
@@ -1121,8 +1195,11 @@ void Project::saveTilesetTilesImage(Tileset *tileset) {
     // Only write the tiles image if it was changed.
     // Porymap will only ever change an existing tiles image by importing a new one.
     if (tileset->hasUnsavedTilesImage) {
-        if (!tileset->tilesImage.save(tileset->tilesImagePath, "PNG")) {
-            logError(QString("Failed to save tiles image '%1'").arg(tileset->tilesImagePath));
+        // Images with no more than 16 colors are saved as 4bpp, like the tiles images in the projects.
+        const int bitDepth = (tileset->tilesImage.colorCount() <= 16) ? 4 : 8;
+        QString error;
+        if (!IndexedPng::write(tileset->tilesImage, tileset->tilesImagePath, bitDepth, &error)) {
+            logError(QString("Failed to save tiles image '%1': %2").arg(tileset->tilesImagePath).arg(error));
             return;
         }
         tileset->hasUnsavedTilesImage = false;
@@ -1138,6 +1215,7 @@ void Project::saveTilesetPalettes(Tileset *tileset) {
 }
 
 bool Project::loadLayoutTilesets(Layout *layout) {
+    TRACE_SCOPE("Project::loadLayoutTilesets");
     layout->tileset_primary = getTileset(layout->tileset_primary_label);
     if (!layout->tileset_primary) {
         QString defaultTileset = this->getDefaultPrimaryTilesetLabel();
@@ -1206,6 +1284,7 @@ Tileset* Project::loadTileset(QString label, Tileset *tileset) {
 }
 
 bool Project::loadBlockdata(Layout *layout) {
+    TRACE_SCOPE("Project::loadBlockdata");
     QString path = QString("%1/%2").arg(root).arg(layout->blockdata_path);
     layout->blockdata = readBlockdata(path);
     layout->lastCommitBlocks.blocks = layout->blockdata;
@@ -1293,11 +1372,13 @@ void Project::writeBlockdata(QString path, const Blockdata &blockdata) {
 }
 
 void Project::saveAllMaps() {
+    TRACE_SCOPE("Project::saveAllMaps");
     for (auto *map : mapCache.values())
         saveMap(map);
 }
 
 void Project::saveMap(Map *map) {
+    TRACE_SCOPE("Project::saveMap");
     // Create/Modify a few collateral files for brand new maps.
     QString basePath = projectConfig.getFilePath(ProjectFilePath::data_map_folders);
     QString mapDataDir = root + "/" + basePath + map->name;
@@ -1443,6 +1524,7 @@ void Project::saveMap(Map *map) {
 }
 
 void Project::saveLayout(Layout *layout) {
+    TRACE_SCOPE("Project::saveLayout");
     //
     saveLayoutBorder(layout);
     saveLayoutBlockdata(layout);
@@ -1467,12 +1549,15 @@ void Project::updateLayout(Layout *layout) {
 }
 
 void Project::saveAllDataStructures() {
+    TRACE_SCOPE("Project::saveAllDataStructures");
     saveMapLayouts();
     saveMapGroups();
     saveRegionMapSections();
     saveMapConstantsHeader();
     saveWildMonData();
-    saveConfig();
+    // Saving is frequent and rarely changes the configs, so they're written once saving stops.
+    projectConfig.saveLater();
+    userConfig.saveLater();
     this->hasUnsavedDataChanges = false;
 }
 
@@ -1486,17 +1571,28 @@ void Project::loadTilesetAssets(Tileset* tileset) {
         return;
     }
     this->readTilesetPaths(tileset);
-    QImage image;
-    if (QFile::exists(tileset->tilesImagePath)) {
-        image = QImage(tileset->tilesImagePath).convertToFormat(QImage::Format_Indexed8, Qt::ThresholdDither);
-        flattenTo4bppImage(&image);
-    } else {
-        image = QImage(8, 8, QImage::Format_Indexed8);
-    }
-    this->loadTilesetTiles(tileset, image);
+
+    // Decoding the tiles image doesn't depend on anything else in the project,
+    // so it's done on a worker thread while the metatile data is read here.
+    QFuture<QImage> tilesImage = QtConcurrent::run(readTilesImage, tileset->tilesImagePath);
     this->loadTilesetMetatiles(tileset);
     this->loadTilesetMetatileLabels(tileset);
     this->loadTilesetPalettes(tileset);
+    this->loadTilesetTiles(tileset, tilesImage.result());
+    tileset->markChanged();
+}
+
+// Tiles images are nearly always paletted PNGs, which are decoded directly into an indexed image.
+// Anything else goes through Qt's image readers and is converted.
+QImage Project::readTilesImage(const QString &path) {
+    if (!QFile::exists(path))
+        return QImage(8, 8, QImage::Format_Indexed8);
+
+    QImage image = IndexedPng::read(path);
+    if (image.isNull())
+        image = QImage(path).convertToFormat(QImage::Format_Indexed8, Qt::ThresholdDither);
+    flattenTo4bppImage(&image);
+    return image;
 }
 
 void Project::readTilesetPaths(Tileset* tileset) {
@@ -1556,24 +1652,22 @@ void Project::readTilesetPaths(Tileset* tileset) {
     }
 }
 
-void Project::loadTilesetPalettes(Tileset* tileset) {
-    QList<QList<QRgb>> palettes;
-    QList<QList<QRgb>> palettePreviews;
-    for (int i = 0; i < tileset->palettePaths.length(); i++) {
-        QString path = tileset->palettePaths.value(i);
-        bool error = false;
-        QList<QRgb> palette = PaletteUtil::parse(path, &error);
-        if (error) {
-            for (int j = 0; j < 16; j++) {
-                palette.append(qRgb(j * 16, j * 16, j * 16));
-            }
+static QList<QRgb> readTilesetPalette(const QString &path) {
+    bool error = false;
+    QList<QRgb> palette = PaletteUtil::parse(path, &error);
+    if (error) {
+        for (int j = 0; j < 16; j++) {
+            palette.append(qRgb(j * 16, j * 16, j * 16));
         }
-
-        palettes.append(palette);
-        palettePreviews.append(palette);
     }
+    return palette;
+}
+
+void Project::loadTilesetPalettes(Tileset* tileset) {
+    // Each palette is in its own file, so they're parsed in parallel.
+    QList<QList<QRgb>> palettes = QtConcurrent::blockingMapped(tileset->palettePaths, readTilesetPalette);
     tileset->palettes = palettes;
-    tileset->palettePreviews = palettePreviews;
+    tileset->palettePreviews = palettes;
 }
 
 void Project::loadTilesetTiles(Tileset *tileset, QImage image) {
@@ -1646,6 +1740,7 @@ QString Project::findMetatileLabelsTileset(QString label) {
 }
 
 bool Project::readTilesetMetatileLabels() {
+    TRACE_SCOPE("Project::readTilesetMetatileLabels");
     metatileLabelsMap.clear();
     unusedMetatileLabels.clear();
 
@@ -1685,19 +1780,14 @@ void Project::loadTilesetMetatileLabels(Tileset* tileset) {
 }
 
 Blockdata Project::readBlockdata(QString path) {
-    Blockdata blockdata;
-    QFile file(path);
-    if (file.open(QIODevice::ReadOnly)) {
-        QByteArray data = file.readAll();
-        for (int i = 0; (i + 1) < data.length(); i += 2) {
-            uint16_t word = static_cast<uint16_t>((data[i] & 0xff) + ((data[i + 1] & 0xff) << 8));
-            blockdata.append(word);
-        }
-    } else {
-        logError(QString("Failed to open blockdata path '%1'").arg(path));
-    }
+    return readBlockdataView(path).toBlockdata();
+}
 
-    return blockdata;
+BlockdataView Project::readBlockdataView(QString path) {
+    BlockdataView view = BlockdataView::fromFile(path);
+    if (!view.isValid())
+        logError(QString("Failed to open blockdata path '%1'").arg(path));
+    return view;
 }
 
 Map* Project::getMap(QString map_name) {
@@ -1749,9 +1839,12 @@ void Project::deleteFile(QString path) {
 }
 
 bool Project::readWildMonData() {
+    TRACE_SCOPE("Project::readWildMonData");
     this->extraEncounterGroups.clear();
     this->wildMonFields.clear();
     this->wildMonData.clear();
+    this->wildMonEntries.clear();
+    this->wildMonEntryIndex.clear();
     this->encounterGroupLabels.clear();
     this->pokemonMinLevel = 0;
     this->pokemonMaxLevel = 100;
@@ -1800,66 +1893,41 @@ bool Project::readWildMonData() {
     // The most common value will be used as the default for new groups.
     QMap<QString, QMap<int, int>> encounterRateFrequencyMaps;
 
-    for (OrderedJson subObjectRef : wildMonObj["wild_encounter_groups"].array_items()) {
-        OrderedJson::object subObject = subObjectRef.object_items();
+    // The parsed document is only read through const references below, so no part of it is copied.
+    const OrderedJson wildMonJson(std::move(wildMonObj));
+    for (const OrderedJson &subObject : wildMonJson["wild_encounter_groups"].array_items()) {
         if (!subObject["for_maps"].bool_value()) {
-            extraEncounterGroups.push_back(subObject);
+            extraEncounterGroups.push_back(subObject.object_items());
             continue;
         }
 
-        for (OrderedJson field : subObject["fields"].array_items()) {
+        for (const OrderedJson &fieldObj : subObject["fields"].array_items()) {
             EncounterField encounterField;
-            OrderedJson::object fieldObj = field.object_items();
             encounterField.name = fieldObj["type"].string_value();
-            for (auto val : fieldObj["encounter_rates"].array_items()) {
+            for (const auto &val : fieldObj["encounter_rates"].array_items()) {
                 encounterField.encounterRates.append(val.int_value());
             }
 
-            QList<QString> subGroups;
-            for (auto groupPair : fieldObj["groups"].object_items()) {
-                subGroups.append(groupPair.first);
-            }
-            for (QString group : subGroups) {
-                OrderedJson::object groupsObj = fieldObj["groups"].object_items();
-                for (auto slotNum : groupsObj[group].array_items()) {
-                    encounterField.groups[group].append(slotNum.int_value());
+            for (const auto &groupPair : fieldObj["groups"].object_items()) {
+                for (const auto &slotNum : groupPair.second.array_items()) {
+                    encounterField.groups[groupPair.first].append(slotNum.int_value());
                 }
             }
             encounterRateFrequencyMaps.insert(encounterField.name, QMap<int, int>());
             wildMonFields.append(encounterField);
         }
 
-        auto encounters = subObject["encounters"].array_items();
-        for (auto encounter : encounters) {
-            OrderedJson::object encounterObj = encounter.object_items();
-            QString mapConstant = encounterObj["map"].string_value();
-
-            WildPokemonHeader header;
-
-            for (EncounterField monField : wildMonFields) {
-                QString field = monField.name;
-                if (!encounterObj[field].is_null()) {
-                    OrderedJson::object encounterFieldObj = encounterObj[field].object_items();
-                    header.wildMons[field].active = true;
-                    header.wildMons[field].encounterRate = encounterFieldObj["encounter_rate"].int_value();
-                    encounterRateFrequencyMaps[field][header.wildMons[field].encounterRate]++;
-                    for (auto mon : encounterFieldObj["mons"].array_items()) {
-                        WildPokemon newMon;
-                        OrderedJson::object monObj = mon.object_items();
-                        newMon.minLevel = monObj["min_level"].int_value();
-                        newMon.maxLevel = monObj["max_level"].int_value();
-                        newMon.species = monObj["species"].string_value();
-                        header.wildMons[field].wildPokemon.append(newMon);
-                    }
-                    // If the user supplied too few pokémon for this group then we fill in the rest.
-                    for (int i = header.wildMons[field].wildPokemon.length(); i < monField.encounterRates.length(); i++) {
-                        WildPokemon newMon; // Keep default values
-                        header.wildMons[field].wildPokemon.append(newMon);
-                    }
-                }
+        // The encounter entries are only indexed by map here. Their pokémon are read the first time the map's encounters are needed.
+        for (const OrderedJson &encounterObj : subObject["encounters"].array_items()) {
+            this->wildMonEntryIndex[encounterObj["map"].string_value()].append(this->wildMonEntries.length());
+            this->wildMonEntries.append(encounterObj);
+            this->encounterGroupLabels.append(encounterObj["base_label"].string_value());
+
+            for (const EncounterField &monField : wildMonFields) {
+                const OrderedJson &encounterFieldObj = encounterObj[monField.name];
+                if (!encounterFieldObj.is_null())
+                    encounterRateFrequencyMaps[monField.name][encounterFieldObj["encounter_rate"].int_value()]++;
             }
-            wildMonData[mapConstant].insert({encounterObj["base_label"].string_value(), header});
-            encounterGroupLabels.append(encounterObj["base_label"].string_value());
         }
     }
 
@@ -1883,7 +1951,73 @@ bool Project::readWildMonData() {
     return true;
 }
 
+WildPokemonHeader Project::readWildMonHeader(const OrderedJson &encounterObj) const {
+    WildPokemonHeader header;
+    for (const EncounterField &monField : this->wildMonFields) {
+        const QString &field = monField.name;
+        const OrderedJson &encounterFieldObj = encounterObj[field];
+        if (encounterFieldObj.is_null())
+            continue;
+
+        WildMonInfo &monInfo = header.wildMons[field];
+        monInfo.active = true;
+        monInfo.encounterRate = encounterFieldObj["encounter_rate"].int_value();
+        for (const OrderedJson &monObj : encounterFieldObj["mons"].array_items()) {
+            WildPokemon newMon;
+            newMon.minLevel = monObj["min_level"].int_value();
+            newMon.maxLevel = monObj["max_level"].int_value();
+            newMon.species = monObj["species"].string_value();
+            monInfo.wildPokemon.append(newMon);
+        }
+        // If the user supplied too few pokémon for this group then we fill in the rest.
+        for (int i = monInfo.wildPokemon.length(); i < monField.encounterRates.length(); i++) {
+            WildPokemon newMon; // Keep default values
+            monInfo.wildPokemon.append(newMon);
+        }
+    }
+    return header;
+}
+
+bool Project::hasWildMonData(const QString &mapConstant) const {
+    return this->wildMonData.find(mapConstant) != this->wildMonData.end()
+        || this->wildMonEntryIndex.contains(mapConstant);
+}
+
+// Returns the encounter groups for the given map, reading them from the wild encounters file if this is the first time they're needed.
+// If the map has no encounters, an empty entry is created for it.
+tsl::ordered_map<QString, WildPokemonHeader> &Project::getWildMonData(const QString &mapConstant) {
+    auto it = this->wildMonData.find(mapConstant);
+    if (it != this->wildMonData.end())
+        return it.value();
+
+    tsl::ordered_map<QString, WildPokemonHeader> &groups = this->wildMonData[mapConstant];
+    groups = readWildMonData(mapConstant);
+    return groups;
+}
+
+// Returns a copy of the encounter groups for the given map. Unlike getWildMonData, encounters that haven't been loaded yet
+// are read without being added to the project, so they won't be rewritten when the project is saved.
+tsl::ordered_map<QString, WildPokemonHeader> Project::readWildMonData(const QString &mapConstant) const {
+    auto it = this->wildMonData.find(mapConstant);
+    if (it != this->wildMonData.end())
+        return it->second;
+
+    tsl::ordered_map<QString, WildPokemonHeader> groups;
+    for (int entryIndex : this->wildMonEntryIndex.value(mapConstant)) {
+        const OrderedJson &encounterObj = this->wildMonEntries.at(entryIndex);
+        groups.insert({encounterObj["base_label"].string_value(), readWildMonHeader(encounterObj)});
+    }
+    return groups;
+}
+
+// Read the encounters of every map. This is needed before changes that affect all maps' encounters (e.g. editing the encounter fields).
+void Project::loadAllWildMonData() {
+    for (auto it = this->wildMonEntryIndex.cbegin(); it != this->wildMonEntryIndex.cend(); it++)
+        getWildMonData(it.key());
+}
+
 bool Project::readMapGroups() {
+    TRACE_SCOPE("Project::readMapGroups");
     this->mapConstantsToMapNames.clear();
     this->mapNamesToMapConstants.clear();
     this->mapGroups.clear();
@@ -2028,6 +2162,7 @@ void Project::appendTilesetLabel(QString label, QString isSecondaryStr) {
 }
 
 bool Project::readTilesetLabels() {
+    TRACE_SCOPE("Project::readTilesetLabels");
     this->primaryTilesetLabels.clear();
     this->secondaryTilesetLabels.clear();
     this->tilesetLabelsOrdered.clear();
@@ -2076,6 +2211,7 @@ bool Project::readTilesetLabels() {
 }
 
 bool Project::readFieldmapProperties() {
+    TRACE_SCOPE("Project::readFieldmapProperties");
     const QString numTilesPrimaryName = projectConfig.getIdentifier(ProjectIdentifier::define_tiles_primary);
     const QString numTilesTotalName = projectConfig.getIdentifier(ProjectIdentifier::define_tiles_total);
     const QString numMetatilesPrimaryName = projectConfig.getIdentifier(ProjectIdentifier::define_metatiles_primary);
@@ -2152,6 +2288,7 @@ bool Project::readFieldmapProperties() {
 
 // Read data masks for Blocks and metatile attributes.
 bool Project::readFieldmapMasks() {
+    TRACE_SCOPE("Project::readFieldmapMasks");
     const QString metatileIdMaskName = projectConfig.getIdentifier(ProjectIdentifier::define_mask_metatile);
     const QString collisionMaskName = projectConfig.getIdentifier(ProjectIdentifier::define_mask_collision);
     const QString elevationMaskName = projectConfig.getIdentifier(ProjectIdentifier::define_mask_elevation);
@@ -2252,6 +2389,7 @@ bool Project::readFieldmapMasks() {
 }
 
 bool Project::readRegionMapSections() {
+    TRACE_SCOPE("Project::readRegionMapSections");
     this->mapSectionIdNames.clear();
     this->regionMapEntries.clear();
     this->saveEmptyMapsec = false;
@@ -2361,6 +2499,7 @@ bool Project::readHealLocationConstants() {
 
 // TODO: Simplify using the new C struct parsing functions (and indexed array parsing functions)
 bool Project::readHealLocations() {
+    TRACE_SCOPE("Project::readHealLocations");
     this->healLocations.clear();
 
     if (!this->readHealLocationConstants())
@@ -2453,6 +2592,7 @@ bool Project::readHealLocations() {
 }
 
 bool Project::readItemNames() {
+    TRACE_SCOPE("Project::readItemNames");
     const QStringList regexList = {projectConfig.getIdentifier(ProjectIdentifier::regex_items)};
     const QString filename = projectConfig.getFilePath(ProjectFilePath::constants_items);
     fileWatcher.addPath(root + "/" + filename);
@@ -2463,6 +2603,7 @@ bool Project::readItemNames() {
 }
 
 bool Project::readFlagNames() {
+    TRACE_SCOPE("Project::readFlagNames");
     const QStringList regexList = {projectConfig.getIdentifier(ProjectIdentifier::regex_flags)};
     const QString filename = projectConfig.getFilePath(ProjectFilePath::constants_flags);
     fileWatcher.addPath(root + "/" + filename);
@@ -2473,6 +2614,7 @@ bool Project::readFlagNames() {
 }
 
 bool Project::readVarNames() {
+    TRACE_SCOPE("Project::readVarNames");
     const QStringList regexList = {projectConfig.getIdentifier(ProjectIdentifier::regex_vars)};
     const QString filename = projectConfig.getFilePath(ProjectFilePath::constants_vars);
     fileWatcher.addPath(root + "/" + filename);
@@ -2483,6 +2625,7 @@ bool Project::readVarNames() {
 }
 
 bool Project::readMovementTypes() {
+    TRACE_SCOPE("Project::readMovementTypes");
     const QStringList regexList = {projectConfig.getIdentifier(ProjectIdentifier::regex_movement_types)};
     const QString filename = projectConfig.getFilePath(ProjectFilePath::constants_obj_event_movement);
     fileWatcher.addPath(root + "/" + filename);
@@ -2493,15 +2636,20 @@ bool Project::readMovementTypes() {
 }
 
 bool Project::readInitialFacingDirections() {
+    TRACE_SCOPE("Project::readInitialFacingDirections");
     QString filename = projectConfig.getFilePath(ProjectFilePath::initial_facing_table);
     fileWatcher.addPath(root + "/" + filename);
-    facingDirections = parser.readNamedIndexCArray(filename, projectConfig.getIdentifier(ProjectIdentifier::symbol_facing_directions));
+    facingDirections.clear();
+    const QMap<QString, QString> directions = parser.readNamedIndexCArray(filename, projectConfig.getIdentifier(ProjectIdentifier::symbol_facing_directions));
+    for (auto it = directions.cbegin(); it != directions.cend(); it++)
+        facingDirections.insert(it.key(), it.value());
     if (facingDirections.isEmpty())
         logWarn(QString("Failed to read initial movement type facing directions from %1").arg(filename));
     return true;
 }
 
 bool Project::readMapTypes() {
+    TRACE_SCOPE("Project::readMapTypes");
     const QStringList regexList = {projectConfig.getIdentifier(ProjectIdentifier::regex_map_types)};
     const QString filename = projectConfig.getFilePath(ProjectFilePath::constants_map_types);
     fileWatcher.addPath(root + "/" + filename);
@@ -2512,6 +2660,7 @@ bool Project::readMapTypes() {
 }
 
 bool Project::readMapBattleScenes() {
+    TRACE_SCOPE("Project::readMapBattleScenes");
     const QStringList regexList = {projectConfig.getIdentifier(ProjectIdentifier::regex_battle_scenes)};
     const QString filename = projectConfig.getFilePath(ProjectFilePath::constants_map_types);
     fileWatcher.addPath(root + "/" + filename);
@@ -2522,6 +2671,7 @@ bool Project::readMapBattleScenes() {
 }
 
 bool Project::readWeatherNames() {
+    TRACE_SCOPE("Project::readWeatherNames");
     const QStringList regexList = {projectConfig.getIdentifier(ProjectIdentifier::regex_weather)};
     const QString filename = projectConfig.getFilePath(ProjectFilePath::constants_weather);
     fileWatcher.addPath(root + "/" + filename);
@@ -2532,6 +2682,7 @@ bool Project::readWeatherNames() {
 }
 
 bool Project::readCoordEventWeatherNames() {
+    TRACE_SCOPE("Project::readCoordEventWeatherNames");
     if (!projectConfig.eventWeatherTriggerEnabled)
         return true;
 
@@ -2545,6 +2696,7 @@ bool Project::readCoordEventWeatherNames() {
 }
 
 bool Project::readSecretBaseIds() {
+    TRACE_SCOPE("Project::readSecretBaseIds");
     if (!projectConfig.eventSecretBaseEnabled)
         return true;
 
@@ -2558,6 +2710,7 @@ bool Project::readSecretBaseIds() {
 }
 
 bool Project::readBgEventFacingDirections() {
+    TRACE_SCOPE("Project::readBgEventFacingDirections");
     const QStringList regexList = {projectConfig.getIdentifier(ProjectIdentifier::regex_sign_facing_directions)};
     const QString filename = projectConfig.getFilePath(ProjectFilePath::constants_event_bg);
     fileWatcher.addPath(root + "/" + filename);
@@ -2568,6 +2721,7 @@ bool Project::readBgEventFacingDirections() {
 }
 
 bool Project::readTrainerTypes() {
+    TRACE_SCOPE("Project::readTrainerTypes");
     const QStringList regexList = {projectConfig.getIdentifier(ProjectIdentifier::regex_trainer_types)};
     const QString filename = projectConfig.getFilePath(ProjectFilePath::constants_trainer_types);
     fileWatcher.addPath(root + "/" + filename);
@@ -2578,6 +2732,7 @@ bool Project::readTrainerTypes() {
 }
 
 bool Project::readMetatileBehaviors() {
+    TRACE_SCOPE("Project::readMetatileBehaviors");
     this->metatileBehaviorMap.clear();
     this->metatileBehaviorMapInverse.clear();
 
@@ -2603,6 +2758,7 @@ bool Project::readMetatileBehaviors() {
 }
 
 bool Project::readSongNames() {
+    TRACE_SCOPE("Project::readSongNames");
     const QStringList regexList = {projectConfig.getIdentifier(ProjectIdentifier::regex_music)};
     const QString filename = projectConfig.getFilePath(ProjectFilePath::constants_songs);
     fileWatcher.addPath(root + "/" + filename);
@@ -2618,16 +2774,19 @@ bool Project::readSongNames() {
 }
 
 bool Project::readObjEventGfxConstants() {
+    TRACE_SCOPE("Project::readObjEventGfxConstants");
     const QStringList regexList = {projectConfig.getIdentifier(ProjectIdentifier::regex_obj_event_gfx)};
     QString filename = projectConfig.getFilePath(ProjectFilePath::constants_obj_events);
     fileWatcher.addPath(root + "/" + filename);
     this->gfxDefines = parser.readCDefinesByRegex(filename, regexList);
+    this->gfxDefineNames = this->gfxDefines.keys();
     if (this->gfxDefines.isEmpty())
         logWarn(QString("Failed to read object event graphics constants from %1.").arg(filename));
     return true;
 }
 
 bool Project::readMiscellaneousConstants() {
+    TRACE_SCOPE("Project::readMiscellaneousConstants");
     const QString filename = projectConfig.getFilePath(ProjectFilePath::constants_global);
     const QString maxObjectEventsName = projectConfig.getIdentifier(ProjectIdentifier::define_obj_event_count);
     fileWatcher.addPath(root + "/" + filename);
@@ -2654,6 +2813,7 @@ bool Project::readMiscellaneousConstants() {
 }
 
 bool Project::readEventScriptLabels() {
+    TRACE_SCOPE("Project::readEventScriptLabels");
     globalScriptLabels.clear();
     for (const auto &filePath : getEventScriptsFilePaths())
         globalScriptLabels << ParseUtil::getGlobalScriptLabels(filePath);
@@ -2727,9 +2887,110 @@ void Project::setEventPixmap(Event *event, bool forceLoad) {
 void Project::clearEventGraphics() {
     qDeleteAll(eventGraphicsMap);
     eventGraphicsMap.clear();
+    qDeleteAll(pendingSpritesheets);
+    pendingSpritesheets.clear();
+    if (!watchedSpritesheets.isEmpty())
+        spritesheetWatcher.removePaths(watchedSpritesheets.values());
+    watchedSpritesheets.clear();
+}
+
+void Project::watchSpritesheet(const QString &filepath) {
+    if (watchedSpritesheets.contains(filepath) || !QFileInfo::exists(filepath))
+        return;
+    if (spritesheetWatcher.addPath(filepath))
+        watchedSpritesheets.insert(filepath);
+}
+
+void Project::reloadSpritesheet(const QString &filepath) {
+    // Some editors save by replacing the file, which stops it from being watched.
+    if (!spritesheetWatcher.files().contains(filepath)) {
+        watchedSpritesheets.remove(filepath);
+        watchSpritesheet(filepath);
+    }
+
+    // Spritesheets that haven't been needed yet will be read when they are.
+    for (const EventGraphics *eventGraphics : eventGraphicsMap) {
+        if (eventGraphics->loaded && eventGraphics->spritesheetPath == filepath) {
+            logInfo(QString("Reloading event spritesheet '%1'").arg(filepath));
+            if (loadSpritesheet(filepath))
+                emit eventGraphicsChanged();
+            return;
+        }
+    }
+}
+
+// Returns true if the spritesheet for these graphics is ready to use. Otherwise it's decoded in the background,
+// and eventGraphicsChanged is emitted once it (and any others being decoded) are ready.
+bool Project::requestEventSpritesheet(EventGraphics *eventGraphics) {
+    if (eventGraphics->loaded)
+        return true;
+    if (eventGraphics->spritesheetPath.isEmpty()) {
+        eventGraphics->setSpritesheet(QImage());
+        return true;
+    }
+    if (pendingSpritesheets.contains(eventGraphics->spritesheetPath))
+        return false;
+    return loadSpritesheet(eventGraphics->spritesheetPath);
+}
+
+// Returns true if the spritesheet was already in the image cache and has been set. Otherwise it's decoded in the background.
+bool Project::loadSpritesheet(const QString &filepath) {
+    // If the file is being read already it may have changed since, so start again.
+    delete pendingSpritesheets.take(filepath);
+
+    const QImage cached = ImageCache::find(filepath);
+    if (!cached.isNull()) {
+        setSpritesheet(filepath, cached);
+        return true;
+    }
+
+    // The image cache can only be used from the GUI thread, so the image is added to it once it's been decoded.
+    auto watcher = new QFutureWatcher<ImageCache::File>(this);
+    connect(watcher, &QFutureWatcher<ImageCache::File>::finished, this, [this, watcher, filepath] {
+        pendingSpritesheets.remove(filepath);
+        watcher->deleteLater();
+        const ImageCache::File file = watcher->result();
+        ImageCache::insert(file);
+        setSpritesheet(filepath, file.image);
+        // Redraw once for all the spritesheets being read, rather than once for each.
+        if (pendingSpritesheets.isEmpty())
+            emit eventGraphicsChanged();
+    });
+    pendingSpritesheets.insert(filepath, watcher);
+    watcher->setFuture(QtConcurrent::run([filepath] { return ImageCache::read(filepath); }));
+    return false;
+}
+
+void Project::setSpritesheet(const QString &filepath, const QImage &spritesheet) {
+    if (spritesheet.isNull())
+        logWarn(QString("Failed to load event spritesheet '%1'").arg(filepath));
+    watchSpritesheet(filepath);
+    // Different graphics can share a spritesheet.
+    for (EventGraphics *eventGraphics : eventGraphicsMap) {
+        if (eventGraphics->spritesheetPath == filepath)
+            eventGraphics->setSpritesheet(spritesheet);
+    }
+}
+
+// Finishes decoding any spritesheets being read in the background, for callers that need the sprites right away.
+void Project::waitForEventSpritesheets() {
+    if (pendingSpritesheets.isEmpty())
+        return;
+
+    const auto pending = pendingSpritesheets;
+    pendingSpritesheets.clear();
+    for (auto it = pending.constBegin(); it != pending.constEnd(); it++) {
+        it.value()->waitForFinished();
+        const ImageCache::File file = it.value()->result();
+        ImageCache::insert(file);
+        setSpritesheet(it.key(), file.image);
+        delete it.value();
+    }
+    emit eventGraphicsChanged();
 }
 
 bool Project::readEventGraphics() {
+    TRACE_SCOPE("Project::readEventGraphics");
     clearEventGraphics();
 
     fileWatcher.addPaths(QStringList() << root + "/" + projectConfig.getFilePath(ProjectFilePath::data_obj_event_gfx_pointers)
@@ -2741,8 +3002,6 @@ bool Project::readEventGraphics() {
     const QString pointersName = projectConfig.getIdentifier(ProjectIdentifier::symbol_obj_event_gfx_pointers);
     QMap<QString, QString> pointerHash = parser.readNamedIndexCArray(pointersFilepath, pointersName);
 
-    QStringList gfxNames = gfxDefines.keys();
-
     // The positions of each of the required members for the gfx info struct.
     // For backwards compatibility if the struct doesn't use initializers.
     static const auto gfxInfoMemberMap = QHash<int, QString>{
@@ -2758,7 +3017,7 @@ bool Project::readEventGraphics() {
     QMap<QString, QStringList> picTables = parser.readCArrayMulti(projectConfig.getFilePath(ProjectFilePath::data_obj_event_pic_tables));
     QMap<QString, QString> graphicIncbins = parser.readCIncbinMulti(projectConfig.getFilePath(ProjectFilePath::data_obj_event_gfx));
 
-    for (QString gfxName : gfxNames) {
+    for (QString gfxName : gfxDefineNames) {
         QString info_label = pointerHash[gfxName].replace("&", "");
         if (!gfxInfos.contains(info_label))
             continue;
@@ -2778,8 +3037,10 @@ bool Project::readEventGraphics() {
 
         if (!path.isNull()) {
             path = fixGraphicPath(path);
-            eventGraphics->spritesheet = QImage(root + "/" + path);
-            if (!eventGraphics->spritesheet.isNull()) {
+            // Only the spritesheet's size is read here. The image is decoded when an event first needs it.
+            eventGraphics->spritesheetPath = root + "/" + path;
+            const QSize spritesheetSize = QImageReader(eventGraphics->spritesheetPath).size();
+            if (spritesheetSize.isValid()) {
                 // Infer the sprite dimensions from the OAM labels.
                 static const QRegularExpression re("\\S+_(\\d+)x(\\d+)");
                 QRegularExpressionMatch dimensionMatch = re.match(dimensions_label);
@@ -2791,12 +3052,12 @@ bool Project::readEventGraphics() {
                     eventGraphics->spriteWidth = dimensionMatch.captured(1).toInt(nullptr, 0);
                     eventGraphics->spriteHeight = dimensionMatch.captured(2).toInt(nullptr, 0);
                 } else {
-                    eventGraphics->spriteWidth = eventGraphics->spritesheet.width();
-                    eventGraphics->spriteHeight = eventGraphics->spritesheet.height();
+                    eventGraphics->spriteWidth = spritesheetSize.width();
+                    eventGraphics->spriteHeight = spritesheetSize.height();
                 }
             }
         } else {
-            eventGraphics->spritesheet = QImage();
+            eventGraphics->setSpritesheet(QImage());
             eventGraphics->spriteWidth = 16;
             eventGraphics->spriteHeight = 16;
         }
@@ -2806,6 +3067,7 @@ bool Project::readEventGraphics() {
 }
 
 bool Project::readSpeciesIconPaths() {
+    TRACE_SCOPE("Project::readSpeciesIconPaths");
     this->speciesToIconPath.clear();
 
     // Read map of species constants to icon names
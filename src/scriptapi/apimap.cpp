@@ -22,7 +22,7 @@ void MainWindow::tryRedrawMapArea(bool forceRedraw) {
         this->editor->collision_item->draw(true);
         this->editor->selected_border_metatiles_item->draw();
         this->editor->updateMapBorder();
-        this->editor->updateMapConnections();
+        this->editor->updateMapConnections(true);
         if (this->tilesetEditor)
             this->tilesetEditor->updateTilesets(this->editor->layout->tileset_primary_label, this->editor->layout->tileset_secondary_label);
         if (this->editor->metatile_selector_item)
@@ -354,6 +354,7 @@ void MainWindow::setTilesetPalette(Tileset *tileset, int paletteIndex, QList<QLi
         tileset->palettes[paletteIndex][i] = qRgb(colors[i][0], colors[i][1], colors[i][2]);
         tileset->palettePreviews[paletteIndex][i] = qRgb(colors[i][0], colors[i][1], colors[i][2]);
     }
+    tileset->markChanged();
 }
 
 void MainWindow::setPrimaryTilesetPalette(int paletteIndex, QList<QList<int>> colors, bool forceRedraw) {
@@ -464,6 +465,7 @@ void MainWindow::setTilesetPalettePreview(Tileset *tileset, int paletteIndex, QL
             continue;
         tileset->palettePreviews[paletteIndex][i] = qRgb(colors[i][0], colors[i][1], colors[i][2]);
     }
+    tileset->markChanged();
 }
 
 void MainWindow::setPrimaryTilesetPalettePreview(int paletteIndex, QList<QList<int>> colors, bool forceRedraw) {
@@ -576,6 +578,8 @@ void MainWindow::setSecondaryTileset(QString tileset) {
 
 void MainWindow::saveMetatilesByMetatileId(int metatileId) {
     Tileset * tileset = Tileset::getMetatileTileset(metatileId, this->editor->layout->tileset_primary, this->editor->layout->tileset_secondary);
+    if (tileset)
+        tileset->markChanged();
     if (this->editor->project && tileset)
         this->editor->project->saveTilesetMetatiles(tileset);
 }
@@ -219,19 +219,46 @@ void MapView::rotate(int degrees) {
     this->scene()->update();
 }
 
+// Only redraw the area covered by the layer's new items.
+void MapView::updateOverlayItems(int layer) {
+    QRectF rect = this->getOverlay(layer)->takeChangedRect();
+    if (!rect.isEmpty())
+        this->scene()->update(rect);
+}
+
+bool MapView::hasOverlayTilesets() {
+    return this->editor && this->editor->layout && this->editor->layout->tileset_primary && this->editor->layout->tileset_secondary;
+}
+
+double MapView::getRenderTime(int layer) {
+    return this->getOverlay(layer)->getRenderTime();
+}
+
 void MapView::addText(QString text, int x, int y, QString color, int fontSize, int layer) {
     this->getOverlay(layer)->addText(text, x, y, color, fontSize);
-    this->scene()->update();
+    this->updateOverlayItems(layer);
+}
+
+void MapView::addTexts(QJSValue textObjs, int layer) {
+    Overlay * overlay = this->getOverlay(layer);
+    int length = textObjs.property("length").toInt();
+    for (int i = 0; i < length; i++) {
+        QJSValue obj = textObjs.property(i);
+        QString color = obj.hasProperty("color") ? obj.property("color").toString() : "#000000";
+        int fontSize = obj.hasProperty("fontSize") ? obj.property("fontSize").toInt() : 12;
+        overlay->addText(obj.property("text").toString(), obj.property("x").toInt(), obj.property("y").toInt(), color, fontSize);
+    }
+    this->updateOverlayItems(layer);
 }
 
 void MapView::addRect(int x, int y, int width, int height, QString borderColor, QString fillColor, int rounding, int layer) {
     if (this->getOverlay(layer)->addRect(x, y, width, height, borderColor, fillColor, rounding))
-        this->scene()->update();
+        this->updateOverlayItems(layer);
 }
 
 void MapView::addPath(QList<int> xCoords, QList<int> yCoords, QString borderColor, QString fillColor, int layer) {
     if (this->getOverlay(layer)->addPath(xCoords, yCoords, borderColor, fillColor))
-        this->scene()->update();
+        this->updateOverlayItems(layer);
 }
 
 void MapView::addPath(QList<QList<int>> coords, QString borderColor, QString fillColor, int layer) {
@@ -250,21 +277,21 @@ void MapView::addPath(QList<QList<int>> coords, QString borderColor, QString fil
 
 void MapView::addImage(int x, int y, QString filepath, int layer, bool useCache) {
     if (this->getOverlay(layer)->addImage(x, y, filepath, useCache))
-        this->scene()->update();
+        this->updateOverlayItems(layer);
 }
 
 void MapView::createImage(int x, int y, QString filepath, int width, int height, int xOffset, int yOffset, qreal hScale, qreal vScale, int paletteId, bool setTransparency, int layer, bool useCache) {
-    if (!this->editor || !this->editor->layout || !this->editor->layout->tileset_primary || !this->editor->layout->tileset_secondary)
+    if (!this->hasOverlayTilesets())
         return;
     QList<QRgb> palette;
     if (paletteId != -1)
         palette = Tileset::getPalette(paletteId, this->editor->layout->tileset_primary, this->editor->layout->tileset_secondary);
     if (this->getOverlay(layer)->addImage(x, y, filepath, useCache, width, height, xOffset, yOffset, hScale, vScale, palette, setTransparency))
-        this->scene()->update();
+        this->updateOverlayItems(layer);
 }
 
 void MapView::addTileImage(int x, int y, int tileId, bool xflip, bool yflip, int paletteId, bool setTransparency, int layer) {
-    if (!this->editor || !this->editor->layout || !this->editor->layout->tileset_primary || !this->editor->layout->tileset_secondary)
+    if (!this->hasOverlayTilesets())
         return;
     QImage image = getPalettedTileImage(tileId,
                                         this->editor->layout->tileset_primary,
@@ -274,7 +301,7 @@ void MapView::addTileImage(int x, int y, int tileId, bool xflip, bool yflip, int
     if (setTransparency)
         image.setColor(0, qRgba(0, 0, 0, 0));
     if (this->getOverlay(layer)->addImage(x, y, image))
-        this->scene()->update();
+        this->updateOverlayItems(layer);
 }
 
 void MapView::addTileImage(int x, int y, QJSValue tileObj, bool setTransparency, int layer) {
@@ -283,7 +310,7 @@ void MapView::addTileImage(int x, int y, QJSValue tileObj, bool setTransparency,
 }
 
 void MapView::addMetatileImage(int x, int y, int metatileId, bool setTransparency, int layer) {
-    if (!this->editor || !this->editor->layout || !this->editor->layout->tileset_primary || !this->editor->layout->tileset_secondary)
+    if (!this->hasOverlayTilesets())
         return;
     QImage image = getMetatileImage(static_cast<uint16_t>(metatileId),
                                     this->editor->layout->tileset_primary,
@@ -293,5 +320,51 @@ void MapView::addMetatileImage(int x, int y, int metatileId, bool setTransparenc
     if (setTransparency)
         image.setColor(0, qRgba(0, 0, 0, 0));
     if (this->getOverlay(layer)->addImage(x, y, image))
-        this->scene()->update();
+        this->updateOverlayItems(layer);
+}
+
+void MapView::addTileImages(QJSValue tileObjs, bool setTransparency, int layer) {
+    if (!this->hasOverlayTilesets())
+        return;
+    Overlay * overlay = this->getOverlay(layer);
+    int length = tileObjs.property("length").toInt();
+    for (int i = 0; i < length; i++) {
+        QJSValue obj = tileObjs.property(i);
+        Tile tile = Scripting::toTile(obj);
+        QImage image = getPalettedTileImage(tile.tileId,
+                                            this->editor->layout->tileset_primary,
+                                            this->editor->layout->tileset_secondary,
+                                            tile.palette)
+                                            .mirrored(tile.xflip, tile.yflip);
+        if (setTransparency)
+            image.setColor(0, qRgba(0, 0, 0, 0));
+        overlay->addImage(obj.property("x").toInt(), obj.property("y").toInt(), image);
+    }
+    this->updateOverlayItems(layer);
+}
+
+void MapView::addMetatileImages(QJSValue metatileObjs, bool setTransparency, int layer) {
+    if (!this->hasOverlayTilesets())
+        return;
+    Overlay * overlay = this->getOverlay(layer);
+    // Scripts often place the same metatile many times, so each one is only drawn once per call.
+    QHash<int, QPixmap> pixmaps;
+    int length = metatileObjs.property("length").toInt();
+    for (int i = 0; i < length; i++) {
+        QJSValue obj = metatileObjs.property(i);
+        int metatileId = obj.property("metatileId").toInt();
+        auto it = pixmaps.find(metatileId);
+        if (it == pixmaps.end()) {
+            QImage image = getMetatileImage(static_cast<uint16_t>(metatileId),
+                                            this->editor->layout->tileset_primary,
+                                            this->editor->layout->tileset_secondary,
+                                            this->editor->layout->metatileLayerOrder,
+                                            this->editor->layout->metatileLayerOpacity);
+            if (setTransparency)
+                image.setColor(0, qRgba(0, 0, 0, 0));
+            it = pixmaps.insert(metatileId, QPixmap::fromImage(image));
+        }
+        overlay->addImage(obj.property("x").toInt(), obj.property("y").toInt(), it.value());
+    }
+    this->updateOverlayItems(layer);
 }
@@ -17,6 +17,8 @@ ScriptUtility::~ScriptUtility() {
         timer->stop();
         delete timer;
     }
+    // Waits for each worker to stop.
+    qDeleteAll(this->activeWorkers);
 }
 
 bool ScriptUtility::registerAction(QString functionName, QString actionName, QString shortcut) {
@@ -81,6 +83,54 @@ void ScriptUtility::callTimeoutFunction(QJSValue callback) {
     Scripting::tryErrorJS(callback.call());
 }
 
+int ScriptUtility::startWorker(QString filepath, QJSValue onMessages, QJSValue onFinished) {
+    if (!window || !window->editor || !window->editor->project)
+        return -1;
+
+    QString validPath = Project::getExistingFilepath(filepath);
+    if (validPath.isEmpty()) {
+        logError(QString("Failed to start worker script. File '%1' does not exist.").arg(filepath));
+        return -1;
+    }
+
+    const int id = this->nextWorkerId++;
+    ScriptWorker *worker = new ScriptWorker(id, validPath, window->editor->project, onMessages, onFinished);
+    connect(worker, &QThread::finished, this, [this, worker] {
+        if (this->activeWorkers.remove(worker->getId()))
+            worker->deleteLater();
+    });
+    this->activeWorkers.insert(id, worker);
+    worker->start();
+    return id;
+}
+
+void ScriptUtility::stopWorker(int workerId) {
+    ScriptWorker *worker = this->activeWorkers.value(workerId, nullptr);
+    if (worker)
+        worker->stop();
+}
+
+QJSValue ScriptUtility::getCallbackStats() {
+    const QList<ScriptProfiler::Stats> statsList = Scripting::getCallbackStats();
+    QJSValue array = Scripting::getEngine()->newArray(statsList.length());
+    for (int i = 0; i < statsList.length(); i++) {
+        const ScriptProfiler::Stats &stats = statsList.at(i);
+        QJSValue obj = Scripting::getEngine()->newObject();
+        obj.setProperty("script", stats.module);
+        obj.setProperty("callback", stats.callback);
+        obj.setProperty("calls", stats.calls);
+        obj.setProperty("skipped", stats.skipped);
+        obj.setProperty("totalMs", stats.totalMs);
+        obj.setProperty("averageMs", stats.averageMs());
+        obj.setProperty("maxMs", stats.maxMs);
+        obj.setProperty("p95Ms", stats.p95Ms);
+        obj.setProperty("debounced", stats.debounced);
+        obj.setProperty("disabled", stats.disabled);
+        array.setProperty(i, obj);
+    }
+    return array;
+}
+
 void ScriptUtility::log(QString message) {
     logInfo(message);
 }
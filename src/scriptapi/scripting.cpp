@@ -50,7 +50,6 @@ Scripting::Scripting(MainWindow *mainWindow) {
 Scripting::~Scripting() {
     if (mainWindow) mainWindow->clearOverlay();
     this->engine->setInterrupted(true);
-    qDeleteAll(this->imageCache);
     delete this->engine;
     delete this->scriptUtility;
 }
@@ -73,6 +72,7 @@ void Scripting::loadModules(QStringList moduleFiles) {
         }
         logInfo(QString("Successfully loaded custom script file '%1'").arg(filepath));
         this->modules.append(module);
+        this->profiler.addModule(QFileInfo(filepath).fileName());
     }
 }
 
@@ -155,16 +155,27 @@ bool Scripting::tryErrorJS(QJSValue js) {
 }
 
 void Scripting::invokeCallback(CallbackType type, QJSValueList args) {
-    for (QJSValue module : this->modules) {
-        QString functionName = callbackFunctions[type];
-        QJSValue callbackFunction = module.property(functionName);
-        if (tryErrorJS(callbackFunction)) continue;
-
-        QJSValue result = callbackFunction.call(args);
-        if (tryErrorJS(result)) continue;
+    const QString functionName = callbackFunctions[type];
+    // The hover callbacks run on every mouse move, so they're debounced if they're too slow.
+    const bool frequent = (type == OnBlockHoverChanged || type == OnBlockHoverCleared);
+    for (int i = 0; i < this->modules.length(); i++) {
+        QJSValue callbackFunction = this->modules.at(i).property(functionName);
+        if (tryErrorJS(callbackFunction) || !callbackFunction.isCallable()) continue;
+
+        this->profiler.invoke(i, functionName, frequent, callbackFunction, args);
     }
 }
 
+QList<ScriptProfiler::Stats> Scripting::getCallbackStats() {
+    if (!instance) return QList<ScriptProfiler::Stats>();
+    return instance->profiler.getStats();
+}
+
+void Scripting::resetCallbackStats() {
+    if (!instance) return;
+    instance->profiler.reset();
+}
+
 void Scripting::invokeAction(int actionIndex) {
     if (!instance || !instance->scriptUtility) return;
     QString functionName = instance->scriptUtility->getActionFunctionName(actionIndex);
@@ -388,22 +399,16 @@ QJSEngine *Scripting::getEngine() {
     return instance->engine;
 }
 
-const QImage * Scripting::getImage(const QString &inputFilepath, bool useCache) {
+QImage Scripting::getImage(const QString &inputFilepath, bool useCache, const ImageCache::Transform &transform) {
     if (inputFilepath.isEmpty())
-        return nullptr;
-
-    const QImage * image;
-    if (useCache) {
-        // Try to retrieve image from the cache
-        image = instance->imageCache.value(inputFilepath, nullptr);
-        if (image) return image;
-    }
+        return QImage();
 
     const QString filepath = Project::getExistingFilepath(inputFilepath);
     if (filepath.isEmpty())
-        return nullptr;
+        return QImage();
 
-    image = new QImage(filepath);
-    instance->imageCache.insert(inputFilepath, image);
-    return image;
+    // Images are shared with the rest of the project, so not using the cache means reloading the file.
+    if (!useCache)
+        ImageCache::remove(filepath);
+    return ImageCache::get(filepath, transform);
 }
@@ -0,0 +1,153 @@
+#include "scriptprofiler.h"
+#include "scripting.h"
+#include "config.h"
+#include "log.h"
+
+#include <QElapsedTimer>
+#include <QTimer>
+#include <algorithm>
+
+// How many calls in a row must go over the budget before a callback is throttled.
+static const int overBudgetLimit = 5;
+// How long the mouse must stay still before a debounced callback runs.
+static const int debounceDelayMs = 150;
+// How many of the most recent calls are used for the 95th percentile.
+static const int recentCallsSize = 200;
+
+ScriptProfiler::~ScriptProfiler() {
+    for (const Module &module : this->modules)
+        delete module.debounceTimer;
+}
+
+void ScriptProfiler::addModule(const QString &name) {
+    Module module;
+    module.name = name;
+    this->modules.append(module);
+}
+
+void ScriptProfiler::invoke(int moduleIndex, const QString &callbackName, bool frequent, QJSValue function, const QJSValueList &args) {
+    if (moduleIndex < 0 || moduleIndex >= this->modules.size())
+        return;
+
+    Module &module = this->modules[moduleIndex];
+    Entry &entry = getEntry(moduleIndex, callbackName);
+    if (entry.stats.disabled) {
+        entry.stats.skipped++;
+        return;
+    }
+    if (entry.stats.debounced) {
+        debounce(moduleIndex, callbackName, function, args);
+        return;
+    }
+
+    // A frequent callback running now replaces any older one still waiting.
+    if (frequent && module.debounceTimer && module.debounceTimer->isActive()) {
+        module.debounceTimer->stop();
+        getEntry(moduleIndex, module.pendingCallback).stats.skipped++;
+    }
+    call(moduleIndex, callbackName, frequent, function, args);
+}
+
+void ScriptProfiler::call(int moduleIndex, const QString &callbackName, bool frequent, QJSValue function, const QJSValueList &args) {
+    QElapsedTimer timer;
+    timer.start();
+    QJSValue result = function.call(args);
+    const double ms = timer.nsecsElapsed() / 1000000.0;
+
+    record(&getEntry(moduleIndex, callbackName), ms, frequent);
+    Scripting::tryErrorJS(result);
+}
+
+ScriptProfiler::Entry &ScriptProfiler::getEntry(int moduleIndex, const QString &callbackName) {
+    Module &module = this->modules[moduleIndex];
+    auto it = module.entries.find(callbackName);
+    if (it == module.entries.end()) {
+        it = module.entries.insert(callbackName, Entry());
+        it->stats.module = module.name;
+        it->stats.callback = callbackName;
+    }
+    return it.value();
+}
+
+void ScriptProfiler::record(Entry *entry, double ms, bool frequent) {
+    Stats &stats = entry->stats;
+    stats.calls++;
+    stats.totalMs += ms;
+    stats.maxMs = qMax(stats.maxMs, ms);
+
+    if (entry->recentMs.size() < recentCallsSize) {
+        entry->recentMs.append(ms);
+    } else {
+        entry->recentMs[entry->nextRecent] = ms;
+        entry->nextRecent = (entry->nextRecent + 1) % recentCallsSize;
+    }
+    QVector<double> sorted = entry->recentMs;
+    const int index = (sorted.size() * 95 - 1) / 100;
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    stats.p95Ms = sorted.at(index);
+
+    const int budget = porymapConfig.scriptCallbackBudget;
+    if (budget <= 0 || ms <= budget) {
+        entry->overBudgetStreak = 0;
+        return;
+    }
+    if (++entry->overBudgetStreak < overBudgetLimit || stats.debounced || stats.disabled)
+        return;
+
+    if (frequent) {
+        stats.debounced = true;
+        logWarn(QString("Custom script callback '%1' in '%2' took longer than %3 ms %4 times in a row. It will now only run once the mouse stops moving.")
+                .arg(stats.callback).arg(stats.module).arg(budget).arg(overBudgetLimit));
+    } else {
+        stats.disabled = true;
+        logWarn(QString("Custom script callback '%1' in '%2' took longer than %3 ms %4 times in a row, and has been disabled. Reload the scripts to enable it again.")
+                .arg(stats.callback).arg(stats.module).arg(budget).arg(overBudgetLimit));
+    }
+}
+
+void ScriptProfiler::debounce(int moduleIndex, const QString &callbackName, QJSValue function, const QJSValueList &args) {
+    Module &module = this->modules[moduleIndex];
+    if (!module.debounceTimer) {
+        module.debounceTimer = new QTimer();
+        module.debounceTimer->setSingleShot(true);
+        module.debounceTimer->setInterval(debounceDelayMs);
+        QObject::connect(module.debounceTimer, &QTimer::timeout, [this, moduleIndex] {
+            Module &module = this->modules[moduleIndex];
+            // Copy the pending call, in case the callback causes another to be debounced.
+            const QString callbackName = module.pendingCallback;
+            const QJSValue function = module.pendingFunction;
+            const QJSValueList args = module.pendingArgs;
+            module.pendingFunction = QJSValue();
+            module.pendingArgs.clear();
+            call(moduleIndex, callbackName, true, function, args);
+        });
+    }
+    if (module.debounceTimer->isActive())
+        getEntry(moduleIndex, module.pendingCallback).stats.skipped++;
+
+    module.pendingCallback = callbackName;
+    module.pendingFunction = function;
+    module.pendingArgs = args;
+    module.debounceTimer->start();
+}
+
+QList<ScriptProfiler::Stats> ScriptProfiler::getStats() const {
+    QList<Stats> list;
+    for (const Module &module : this->modules) {
+        for (const Entry &entry : module.entries) {
+            if (entry.stats.calls > 0 || entry.stats.skipped > 0)
+                list.append(entry.stats);
+        }
+    }
+    return list;
+}
+
+void ScriptProfiler::reset() {
+    for (Module &module : this->modules) {
+        if (module.debounceTimer)
+            module.debounceTimer->stop();
+        module.pendingFunction = QJSValue();
+        module.pendingArgs.clear();
+        module.entries.clear();
+    }
+}
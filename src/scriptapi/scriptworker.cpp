@@ -0,0 +1,280 @@
+#include "scriptworker.h"
+#include "scripting.h"
+#include "project.h"
+#include "log.h"
+
+#include <QJSEngine>
+#include <QJsonDocument>
+#include <QSemaphore>
+#include <memory>
+
+// How often a worker's messages are passed to the main script engine while it's running.
+static const int messageFlushInterval = 100;
+
+ScriptWorker::ScriptWorker(int id, const QString &filepath, Project *project, QJSValue onMessages, QJSValue onFinished)
+    : id(id),
+      filepath(filepath),
+      project(project),
+      onMessages(onMessages),
+      onFinished(onFinished)
+{
+    connect(this, &ScriptWorker::messagesPosted, this, &ScriptWorker::deliverMessages, Qt::QueuedConnection);
+    connect(this, &QThread::finished, this, [this] {
+        if (this->onFinished.isCallable())
+            Scripting::tryErrorJS(this->onFinished.call(QJSValueList{ this->succeeded }));
+    });
+}
+
+ScriptWorker::~ScriptWorker() {
+    stop();
+    wait();
+}
+
+void ScriptWorker::stop() {
+    this->stopping.storeRelease(1);
+    QMutexLocker locker(&this->engineMutex);
+    if (this->engine)
+        this->engine->setInterrupted(true);
+}
+
+void ScriptWorker::run() {
+    QJSEngine engine;
+    engine.installExtensions(QJSEngine::ConsoleExtension);
+
+    ScriptWorkerApi api(this);
+    QJSEngine::setObjectOwnership(&api, QJSEngine::CppOwnership);
+    engine.globalObject().setProperty("worker", engine.newQObject(&api));
+
+    this->engineMutex.lock();
+    this->engine = &engine;
+    if (isStopping())
+        engine.setInterrupted(true);
+    this->engineMutex.unlock();
+
+    this->flushTimer.start();
+    QJSValue module = engine.importModule(this->filepath);
+    if (!Scripting::tryErrorJS(module)) {
+        QJSValue mainFunction = module.property("main");
+        if (mainFunction.isCallable()) {
+            this->succeeded = !Scripting::tryErrorJS(mainFunction.call()) && !isStopping();
+        } else {
+            logError(QString("Worker script '%1' does not export a 'main' function.").arg(this->filepath));
+        }
+    }
+    flushMessages();
+
+    QMutexLocker locker(&this->engineMutex);
+    this->engine = nullptr;
+}
+
+QVariant ScriptWorker::requestProjectData(std::function<QVariant(Project *)> function) {
+    // The request is shared with the GUI thread, which may still answer it after the worker has stopped waiting.
+    struct Request {
+        QVariant result;
+        QSemaphore done;
+    };
+    auto request = std::make_shared<Request>();
+    QMetaObject::invokeMethod(this, [this, function, request] {
+        if (this->project)
+            request->result = function(this->project);
+        request->done.release();
+    }, Qt::QueuedConnection);
+
+    // Check periodically whether the worker was stopped, so the GUI thread is never waiting on a worker that's waiting on it.
+    while (!request->done.tryAcquire(1, 50)) {
+        if (isStopping())
+            return QVariant();
+    }
+    return request->result;
+}
+
+void ScriptWorker::postMessage(const QVariant &message) {
+    this->pendingMessages.append(message);
+    if (this->flushTimer.elapsed() >= messageFlushInterval)
+        flushMessages();
+}
+
+void ScriptWorker::flushMessages() {
+    this->flushTimer.restart();
+    if (this->pendingMessages.isEmpty())
+        return;
+    emit messagesPosted(this->pendingMessages);
+    this->pendingMessages.clear();
+}
+
+void ScriptWorker::deliverMessages(const QVariantList &messages) {
+    if (!this->onMessages.isCallable())
+        return;
+    QJSEngine *engine = Scripting::getEngine();
+    if (engine)
+        Scripting::tryErrorJS(this->onMessages.call(QJSValueList{ engine->toScriptValue(messages) }));
+}
+
+
+
+// Snapshots of project data. These are made on the GUI thread, and only contain plain values so they can be used on the worker thread.
+
+static QVariantList blocksSnapshot(const Blockdata &blocks) {
+    QVariantList list;
+    list.reserve(blocks.size());
+    for (const Block &block : blocks) {
+        QVariantMap obj;
+        obj.insert("metatileId", block.metatileId());
+        obj.insert("collision", block.collision());
+        obj.insert("elevation", block.elevation());
+        obj.insert("rawValue", block.rawValue());
+        list.append(obj);
+    }
+    return list;
+}
+
+static QVariant layoutSnapshot(Project *project, const QString &layoutId) {
+    if (!project->mapLayouts.contains(layoutId))
+        return QVariant();
+    Layout *layout = project->loadLayout(layoutId);
+    if (!layout)
+        return QVariant();
+
+    QVariantMap obj;
+    obj.insert("id", layout->id);
+    obj.insert("name", layout->name);
+    obj.insert("width", layout->getWidth());
+    obj.insert("height", layout->getHeight());
+    obj.insert("borderWidth", layout->getBorderWidth());
+    obj.insert("borderHeight", layout->getBorderHeight());
+    obj.insert("primaryTileset", layout->tileset_primary_label);
+    obj.insert("secondaryTileset", layout->tileset_secondary_label);
+    obj.insert("blocks", blocksSnapshot(layout->blockdata));
+    obj.insert("border", blocksSnapshot(layout->border));
+    return obj;
+}
+
+static QVariantList eventsSnapshot(Project *project, const QList<Event *> &events) {
+    QVariantList list;
+    for (Event *event : events) {
+        const QString json = OrderedJson(event->buildEventJson(project)).dump();
+        list.append(QJsonDocument::fromJson(json.toUtf8()).toVariant());
+    }
+    return list;
+}
+
+static QVariant mapSnapshot(Project *project, const QString &mapName) {
+    if (!project->mapNames.contains(mapName))
+        return QVariant();
+    Map *map = project->getMap(mapName);
+    if (!map)
+        return QVariant();
+
+    QVariantMap obj;
+    obj.insert("name", map->name);
+    obj.insert("constantName", map->constantName);
+    obj.insert("layoutId", map->layoutId);
+    obj.insert("song", map->song);
+    obj.insert("location", map->location);
+    obj.insert("requiresFlash", map->requiresFlash);
+    obj.insert("weather", map->weather);
+    obj.insert("type", map->type);
+    obj.insert("showLocationName", map->show_location);
+    obj.insert("allowRunning", map->allowRunning);
+    obj.insert("allowBiking", map->allowBiking);
+    obj.insert("allowEscaping", map->allowEscaping);
+    obj.insert("floorNumber", map->floorNumber);
+    obj.insert("battleScene", map->battle_scene);
+    obj.insert("objectEvents", eventsSnapshot(project, map->events.value(Event::Group::Object)));
+    obj.insert("warpEvents", eventsSnapshot(project, map->events.value(Event::Group::Warp)));
+    obj.insert("coordEvents", eventsSnapshot(project, map->events.value(Event::Group::Coord)));
+    obj.insert("bgEvents", eventsSnapshot(project, map->events.value(Event::Group::Bg)));
+    return obj;
+}
+
+static QVariant tilesetSnapshot(Project *project, const QString &tilesetName) {
+    if (!project->tilesetLabelsOrdered.contains(tilesetName))
+        return QVariant();
+    Tileset *tileset = project->getTileset(tilesetName);
+    if (!tileset)
+        return QVariant();
+
+    QVariantList metatiles;
+    for (const Metatile *metatile : tileset->metatiles()) {
+        QVariantList tiles;
+        for (const Tile &tile : metatile->tiles) {
+            QVariantMap tileObj;
+            tileObj.insert("tileId", tile.tileId);
+            tileObj.insert("xflip", tile.xflip);
+            tileObj.insert("yflip", tile.yflip);
+            tileObj.insert("palette", tile.palette);
+            tiles.append(tileObj);
+        }
+        QVariantMap obj;
+        obj.insert("behavior", metatile->behavior());
+        obj.insert("terrainType", metatile->terrainType());
+        obj.insert("encounterType", metatile->encounterType());
+        obj.insert("layerType", metatile->layerType());
+        obj.insert("tiles", tiles);
+        metatiles.append(obj);
+    }
+
+    QVariantMap obj;
+    obj.insert("name", tileset->name);
+    obj.insert("isSecondary", tileset->is_secondary);
+    obj.insert("metatiles", metatiles);
+    return obj;
+}
+
+
+
+QList<QString> ScriptWorkerApi::getMapNames() {
+    return this->worker->requestProjectData([](Project *project) {
+        return QVariant(project->mapNames);
+    }).toStringList();
+}
+
+QVariant ScriptWorkerApi::getMap(QString mapName) {
+    return this->worker->requestProjectData([mapName](Project *project) {
+        return mapSnapshot(project, mapName);
+    });
+}
+
+QList<QString> ScriptWorkerApi::getLayoutIds() {
+    return this->worker->requestProjectData([](Project *project) {
+        return QVariant(project->mapLayoutsTable);
+    }).toStringList();
+}
+
+QVariant ScriptWorkerApi::getLayout(QString layoutId) {
+    return this->worker->requestProjectData([layoutId](Project *project) {
+        return layoutSnapshot(project, layoutId);
+    });
+}
+
+QList<QString> ScriptWorkerApi::getTilesetNames() {
+    return this->worker->requestProjectData([](Project *project) {
+        return QVariant(project->tilesetLabelsOrdered);
+    }).toStringList();
+}
+
+QVariant ScriptWorkerApi::getTileset(QString tilesetName) {
+    return this->worker->requestProjectData([tilesetName](Project *project) {
+        return tilesetSnapshot(project, tilesetName);
+    });
+}
+
+void ScriptWorkerApi::postMessage(QJSValue message) {
+    this->worker->postMessage(message.toVariant());
+}
+
+bool ScriptWorkerApi::isStopping() {
+    return this->worker->isStopping();
+}
+
+void ScriptWorkerApi::log(QString message) {
+    logInfo(message);
+}
+
+void ScriptWorkerApi::warn(QString message) {
+    logWarn(message);
+}
+
+void ScriptWorkerApi::error(QString message) {
+    logError(message);
+}
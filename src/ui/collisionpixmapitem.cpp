@@ -1,6 +1,7 @@
 #include "collisionpixmapitem.h"
 #include "editcommands.h"
 #include "metatile.h"
+#include "imageproviders.h"
 
 void CollisionPixmapItem::hoverMoveEvent(QGraphicsSceneHoverEvent *event) {
     QPoint pos = Metatile::coordFromPixmapCoord(event->pos());
@@ -51,11 +52,24 @@ void CollisionPixmapItem::mouseReleaseEvent(QGraphicsSceneMouseEvent *event) {
 void CollisionPixmapItem::draw(bool ignoreCache) {
     if (this->layout) {
         this->layout->setCollisionItem(this);
-        setPixmap(this->layout->renderCollision(ignoreCache));
+        redraw(ignoreCache);
         setOpacity(*this->opacity);
     }
 }
 
+// Only the collision and elevation are compared, so metatile edits don't cause collision chunks to be redrawn.
+bool CollisionPixmapItem::getChunkBlock(int x, int y, Block *block) const {
+    Block layoutBlock;
+    if (!this->layout || !this->layout->getBlock(x, y, &layoutBlock))
+        return false;
+    *block = Block(0, layoutBlock.collision(), layoutBlock.elevation());
+    return true;
+}
+
+void CollisionPixmapItem::drawBlock(QImage *image, const QPoint &origin, const Block &block) {
+    drawCollisionMetatile(image, origin, block.collision(), block.elevation());
+}
+
 void CollisionPixmapItem::paint(QGraphicsSceneMouseEvent *event) {
     if (event->type() == QEvent::GraphicsSceneMouseRelease) {
         actionId_++;
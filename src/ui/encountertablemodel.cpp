@@ -64,7 +64,7 @@ QVariant EncounterTableModel::data(const QModelIndex &index, int role) const {
             return this->groupNames[row];
 
         case ColumnType::Species:
-            return this->monInfo.wildPokemon[row].species;
+            return this->monInfo.wildPokemon[row].species.toString();
 
         case ColumnType::MinLevel:
             return this->monInfo.wildPokemon[row].minLevel;
@@ -92,7 +92,7 @@ QVariant EncounterTableModel::data(const QModelIndex &index, int role) const {
     else if (role == Qt::EditRole) {
         switch (col) {
         case ColumnType::Species:
-            return this->monInfo.wildPokemon[row].species;
+            return this->monInfo.wildPokemon[row].species.toString();
 
         case ColumnType::MinLevel:
             return this->monInfo.wildPokemon[row].minLevel;
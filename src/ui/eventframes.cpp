@@ -169,16 +169,7 @@ void EventFrame::populateScriptDropdown(NoScrollComboBox * combo, Project * proj
         combo->addItems(this->event->getMap()->getScriptLabels(this->event->getEventGroup()));
 
     // The dropdown's autocomplete has all script labels across the full project.
-    auto completer = new QCompleter(project->globalScriptLabels, combo);
-    completer->setCaseSensitivity(Qt::CaseInsensitive);
-    completer->setModelSorting(QCompleter::CaseInsensitivelySortedModel);
-    completer->setFilterMode(Qt::MatchContains);
-
-    // Improve display speed for the autocomplete popup
-    auto popup = (QListView *)completer->popup();
-    if (popup) popup->setUniformItemSizes(true);
-
-    combo->setCompleter(completer);
+    combo->setSharedCompleterModel(project->getIdentifierModel(project->globalScriptLabels));
 }
 
 
@@ -374,10 +365,10 @@ void ObjectFrame::populate(Project *project) {
     const QSignalBlocker blocker(this);
     EventFrame::populate(project);
 
-    this->combo_sprite->addItems(project->gfxDefines.keys());
-    this->combo_movement->addItems(project->movementTypes);
-    this->combo_flag->addItems(project->flagNames);
-    this->combo_trainer_type->addItems(project->trainerTypes);
+    this->combo_sprite->setSharedModel(project->getIdentifierModel(project->gfxDefineNames));
+    this->combo_movement->setSharedModel(project->getIdentifierModel(project->movementTypes));
+    this->combo_flag->setSharedModel(project->getIdentifierModel(project->flagNames));
+    this->combo_trainer_type->setSharedModel(project->getIdentifierModel(project->trainerTypes));
 
     this->populateScriptDropdown(this->combo_script, project);
 }
@@ -467,7 +458,7 @@ void CloneObjectFrame::populate(Project *project) {
     const QSignalBlocker blocker(this);
     EventFrame::populate(project);
 
-    this->combo_target_map->addItems(project->mapNames);
+    this->combo_target_map->setSharedModel(project->getIdentifierModel(project->mapNames));
 }
 
 void WarpFrame::setup() {
@@ -548,7 +539,7 @@ void WarpFrame::populate(Project *project) {
     const QSignalBlocker blocker(this);
     EventFrame::populate(project);
 
-    this->combo_dest_map->addItems(project->mapNames);
+    this->combo_dest_map->setSharedModel(project->getIdentifierModel(project->mapNames));
 }
 
 
@@ -634,7 +625,7 @@ void TriggerFrame::populate(Project *project) {
     EventFrame::populate(project);
 
     // var combo
-    this->combo_var->addItems(project->varNames);
+    this->combo_var->setSharedModel(project->getIdentifierModel(project->varNames));
 
     this->populateScriptDropdown(this->combo_script, project);
 }
@@ -687,7 +678,7 @@ void WeatherTriggerFrame::populate(Project *project) {
     EventFrame::populate(project);
 
     // weather
-    this->combo_weather->addItems(project->coordEventWeatherNames);
+    this->combo_weather->setSharedModel(project->getIdentifierModel(project->coordEventWeatherNames));
 }
 
 
@@ -756,7 +747,7 @@ void SignFrame::populate(Project *project) {
     EventFrame::populate(project);
 
     // facing dir
-    this->combo_facing_dir->addItems(project->bgEventFacingDirections);
+    this->combo_facing_dir->setSharedModel(project->getIdentifierModel(project->bgEventFacingDirections));
 
     this->populateScriptDropdown(this->combo_script, project);
 }
@@ -871,8 +862,8 @@ void HiddenItemFrame::populate(Project *project) {
     const QSignalBlocker blocker(this);
     EventFrame::populate(project);
 
-    this->combo_item->addItems(project->itemNames);
-    this->combo_flag->addItems(project->flagNames);
+    this->combo_item->setSharedModel(project->getIdentifierModel(project->itemNames));
+    this->combo_flag->setSharedModel(project->getIdentifierModel(project->flagNames));
 }
 
 
@@ -925,7 +916,7 @@ void SecretBaseFrame::populate(Project *project) {
     const QSignalBlocker blocker(this);
     EventFrame::populate(project);
 
-    this->combo_base_id->addItems(project->secretBaseIds);
+    this->combo_base_id->setSharedModel(project->getIdentifierModel(project->secretBaseIds));
 }
 
 
@@ -1004,5 +995,5 @@ void HealLocationFrame::populate(Project *project) {
     EventFrame::populate(project);
 
     if (projectConfig.healLocationRespawnDataEnabled)
-        this->combo_respawn_map->addItems(project->mapNames);
+        this->combo_respawn_map->setSharedModel(project->getIdentifierModel(project->mapNames));
 }
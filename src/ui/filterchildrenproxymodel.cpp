@@ -6,6 +6,157 @@ FilterChildrenProxyModel::FilterChildrenProxyModel(QObject *parent) :
 
 }
 
+void FilterChildrenProxyModel::setSourceModel(QAbstractItemModel *model)
+{
+    for (const auto &connection : this->sourceConnections)
+        disconnect(connection);
+    this->sourceConnections.clear();
+    this->indexDirty = true;
+
+    // These are connected before the base class connects to the model, so the index is already
+    // marked out of date when the base class re-filters the rows that changed.
+    if (model) {
+        auto markDirty = [this] { this->indexDirty = true; };
+        this->sourceConnections.append(connect(model, &QAbstractItemModel::rowsInserted, this, markDirty));
+        this->sourceConnections.append(connect(model, &QAbstractItemModel::rowsRemoved, this, markDirty));
+        this->sourceConnections.append(connect(model, &QAbstractItemModel::rowsMoved, this, markDirty));
+        this->sourceConnections.append(connect(model, &QAbstractItemModel::modelReset, this, markDirty));
+        this->sourceConnections.append(connect(model, &QAbstractItemModel::layoutChanged, this, markDirty));
+        this->sourceConnections.append(connect(model, &QAbstractItemModel::dataChanged, this,
+                                       [this](const QModelIndex &, const QModelIndex &, const QVector<int> &roles) {
+            // Icon updates (e.g. the open map changing) don't change the text being searched.
+            if (roles.isEmpty() || roles.contains(filterRole()) || roles.contains(Qt::UserRole))
+                this->indexDirty = true;
+        }));
+    }
+    QSortFilterProxyModel::setSourceModel(model);
+}
+
+void FilterChildrenProxyModel::setHideEmpty(bool hidden)
+{
+    if (this->hideEmpty == hidden)
+        return;
+    this->hideEmpty = hidden;
+    invalidateFilter();
+}
+
+void FilterChildrenProxyModel::setFilterText(const QString &text)
+{
+    const QString newQuery = text.toCaseFolded();
+    if (newQuery == this->query)
+        return;
+
+    const QString oldQuery = this->query;
+    this->query = newQuery;
+
+    if (!this->query.isEmpty() && !this->indexDirty) {
+        if (!oldQuery.isEmpty() && this->query.startsWith(oldQuery)) {
+            // Anything that matches the longer query also matched the shorter one, so only the previous matches need checking.
+            updateMatches(this->matches);
+        } else {
+            QVector<int> all(this->entries.size());
+            for (int i = 0; i < all.size(); i++)
+                all[i] = i;
+            updateMatches(all);
+        }
+    }
+
+    // Re-filtering only inserts/removes the rows whose visibility changed.
+    invalidateFilter();
+    if (this->query.isEmpty())
+        sort(-1);
+    else
+        sort(0);
+}
+
+int FilterChildrenProxyModel::matchScore(const QString &key, const QString &query)
+{
+    if (query.isEmpty())
+        return 0;
+
+    int pos = key.indexOf(query);
+    if (pos >= 0) {
+        // Substring matches rank first, the earlier the better, especially at the start of a word.
+        int score = 2000 - qMin(pos, 999);
+        if (pos == 0 || !key.at(pos - 1).isLetterOrNumber())
+            score += 1000;
+        return score;
+    }
+
+    // Otherwise the query's characters must appear in order. Tighter matches rank higher.
+    int first = -1;
+    int keyIndex = 0;
+    for (const QChar &c : query) {
+        keyIndex = key.indexOf(c, keyIndex);
+        if (keyIndex < 0)
+            return -1;
+        if (first < 0)
+            first = keyIndex;
+        keyIndex++;
+    }
+    const int gaps = (keyIndex - first) - query.length();
+    return qMax(1, 999 - gaps);
+}
+
+const QStandardItem *FilterChildrenProxyModel::itemAt(int source_row, const QModelIndex &source_parent) const
+{
+    auto model = qobject_cast<const QStandardItemModel *>(sourceModel());
+    if (!model)
+        return nullptr;
+    return model->itemFromIndex(model->index(source_row, filterKeyColumn() < 0 ? 0 : filterKeyColumn(), source_parent));
+}
+
+void FilterChildrenProxyModel::buildIndex() const
+{
+    this->indexDirty = false;
+    this->entries.clear();
+
+    auto model = qobject_cast<const QStandardItemModel *>(sourceModel());
+    if (model) {
+        const QStandardItem *root = model->invisibleRootItem();
+        for (int i = 0; i < root->rowCount(); i++) {
+            const QStandardItem *item = root->child(i);
+            if (!item) continue;
+            this->entries.append({item, nullptr, model->data(item->index(), filterRole()).toString().toCaseFolded()});
+            for (int j = 0; j < item->rowCount(); j++) {
+                const QStandardItem *child = item->child(j);
+                if (!child) continue;
+                this->entries.append({child, item, model->data(child->index(), filterRole()).toString().toCaseFolded()});
+            }
+        }
+    }
+
+    QVector<int> all(this->entries.size());
+    for (int i = 0; i < all.size(); i++)
+        all[i] = i;
+    updateMatches(all);
+}
+
+void FilterChildrenProxyModel::updateMatches(const QVector<int> &candidates) const
+{
+    QVector<int> newMatches;
+    this->scores.clear();
+    this->accepted.clear();
+    for (int i : candidates) {
+        const Entry &entry = this->entries.at(i);
+        int score = matchScore(entry.key, this->query);
+        if (score < 0)
+            continue;
+        newMatches.append(i);
+        this->scores.insert(entry.item, score);
+        this->accepted.insert(entry.item);
+        if (entry.parent) {
+            // A folder is shown if any of its children match.
+            this->accepted.insert(entry.parent);
+        } else {
+            // Everything in a matching folder is shown.
+            for (int j = 0; j < entry.item->rowCount(); j++)
+                this->accepted.insert(entry.item->child(j));
+        }
+    }
+    this->matches = newMatches;
+}
+
 bool FilterChildrenProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
 {
     if (this->hideEmpty && source_parent.row() < 0) // want to hide children
@@ -17,28 +168,25 @@ bool FilterChildrenProxyModel::filterAcceptsRow(int source_row, const QModelInde
                 return false;
         }
     }
-    // custom behaviour :
-    if(filterRegularExpression().pattern().isEmpty() == false)
-    {
-        // get source-model index for current row
-        QModelIndex source_index = sourceModel()->index(source_row, this->filterKeyColumn(), source_parent) ;
-        if(source_index.isValid())
-        {
-            // if any of children matches the filter, then current index matches the filter as well
-            int i, nb = sourceModel()->rowCount(source_index);
-            for (i = 0; i < nb; ++i)
-            {
-                if (filterAcceptsRow(i, source_index))
-                {
-                    return true;
-                }
-            }
-            // check current index itself
-            QString key = sourceModel()->data(source_index, filterRole()).toString();
-            QString parentKey = sourceModel()->data(source_parent, filterRole()).toString();
-            return key.contains(filterRegularExpression()) || parentKey.contains(filterRegularExpression());
+    if (this->query.isEmpty())
+        return QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
+
+    if (this->indexDirty)
+        buildIndex();
+    return this->accepted.contains(itemAt(source_row, source_parent));
+}
+
+bool FilterChildrenProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    // Within a folder, better matches first. Folders themselves, and everything when not filtering, keep the source order.
+    if (!this->query.isEmpty() && left.parent().isValid()) {
+        auto model = qobject_cast<const QStandardItemModel *>(sourceModel());
+        if (model) {
+            const int leftScore = this->scores.value(model->itemFromIndex(left), -1);
+            const int rightScore = this->scores.value(model->itemFromIndex(right), -1);
+            if (leftScore != rightScore)
+                return leftScore > rightScore;
         }
     }
-    // parent call for initial behaviour
-    return QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
+    return left.row() < right.row();
 }
@@ -0,0 +1,157 @@
+#include "identifierlistmodel.h"
+
+#include <QListView>
+
+IdentifierListModel::IdentifierListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{}
+
+void IdentifierListModel::setStrings(const QStringList &strings) {
+    // Comparing two lists that share data doesn't need to look at their contents.
+    if (this->m_strings == strings)
+        return;
+
+    beginResetModel();
+    this->m_strings = strings;
+    this->indexed = false;
+    this->folded.clear();
+    this->rows.clear();
+    this->trigrams.clear();
+    endResetModel();
+}
+
+int IdentifierListModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : this->m_strings.size();
+}
+
+QVariant IdentifierListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= this->m_strings.size())
+        return QVariant();
+    if (role == Qt::DisplayRole || role == Qt::EditRole)
+        return this->m_strings.at(index.row());
+    return QVariant();
+}
+
+quint64 IdentifierListModel::trigramKey(const QChar *chars) {
+    return (static_cast<quint64>(chars[0].unicode()) << 32)
+         | (static_cast<quint64>(chars[1].unicode()) << 16)
+         | static_cast<quint64>(chars[2].unicode());
+}
+
+void IdentifierListModel::buildIndex() const {
+    if (this->indexed)
+        return;
+    this->indexed = true;
+
+    this->folded.reserve(this->m_strings.size());
+    this->rows.reserve(this->m_strings.size());
+    for (int row = 0; row < this->m_strings.size(); row++) {
+        const QString &string = this->m_strings.at(row);
+        if (!this->rows.contains(string))
+            this->rows.insert(string, row);
+
+        const QString folded = string.toCaseFolded();
+        this->folded.append(folded);
+        for (int i = 0; i + 3 <= folded.length(); i++) {
+            QVector<int> &postings = this->trigrams[trigramKey(folded.constData() + i)];
+            // Rows are visited in order, so each posting list stays sorted and only needs checking at the end for repeats.
+            if (postings.isEmpty() || postings.last() != row)
+                postings.append(row);
+        }
+    }
+}
+
+int IdentifierListModel::indexOf(const QString &text) const {
+    buildIndex();
+    return this->rows.value(text, -1);
+}
+
+QVector<int> IdentifierListModel::search(const QString &text) const {
+    QVector<int> results;
+    buildIndex();
+    const QString query = text.toCaseFolded();
+    if (query.length() < 3) {
+        // Too short for the trigram index, but short queries also match cheaply.
+        for (int row = 0; row < this->folded.size(); row++) {
+            if (this->folded.at(row).contains(query))
+                results.append(row);
+        }
+        return results;
+    }
+
+    // Every match contains all of the query's trigrams, so only the rows listed for its rarest trigram need to be checked.
+    const QVector<int> *candidates = nullptr;
+    for (int i = 0; i + 3 <= query.length(); i++) {
+        auto it = this->trigrams.constFind(trigramKey(query.constData() + i));
+        if (it == this->trigrams.constEnd())
+            return results;
+        if (!candidates || it->size() < candidates->size())
+            candidates = &it.value();
+    }
+    for (int row : *candidates) {
+        if (this->folded.at(row).contains(query))
+            results.append(row);
+    }
+    return results;
+}
+
+
+
+IdentifierFilterModel::IdentifierFilterModel(IdentifierListModel *source, QObject *parent)
+    : QAbstractListModel(parent),
+      source(source)
+{
+    if (source)
+        connect(source, &QAbstractItemModel::modelReset, this, [this] {
+            beginResetModel();
+            refilter();
+            endResetModel();
+        });
+    refilter();
+}
+
+void IdentifierFilterModel::setFilterText(const QString &text) {
+    if (text == this->filterText)
+        return;
+
+    beginResetModel();
+    this->filterText = text;
+    refilter();
+    endResetModel();
+}
+
+// With no filter text every row is shown as-is, so nothing needs to be searched.
+void IdentifierFilterModel::refilter() {
+    if (this->source && !this->filterText.isEmpty())
+        this->matches = this->source->search(this->filterText);
+    else
+        this->matches.clear();
+}
+
+int IdentifierFilterModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid() || !this->source)
+        return 0;
+    return this->filterText.isEmpty() ? this->source->rowCount() : this->matches.size();
+}
+
+QVariant IdentifierFilterModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount())
+        return QVariant();
+    const int sourceRow = this->filterText.isEmpty() ? index.row() : this->matches.at(index.row());
+    return this->source->data(this->source->index(sourceRow), role);
+}
+
+
+
+IdentifierCompleter::IdentifierCompleter(IdentifierListModel *model, QObject *parent)
+    : QCompleter(parent),
+      m_filterModel(new IdentifierFilterModel(model, this))
+{
+    setModel(this->m_filterModel);
+    setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    setCaseSensitivity(Qt::CaseInsensitive);
+
+    // Improve display speed for the autocomplete popup
+    auto popup = qobject_cast<QListView *>(this->popup());
+    if (popup) popup->setUniformItemSizes(true);
+}
@@ -2,15 +2,54 @@
 #include "imageproviders.h"
 #include "log.h"
 #include "editor.h"
+#include "palettetable.h"
 #include <QPainter>
+#include <algorithm>
+#include <cstring>
 
 QImage getCollisionMetatileImage(Block block) {
     return getCollisionMetatileImage(block.collision(), block.elevation());
 }
 
+static QRect getCollisionIconRect(int collision, int elevation) {
+    QRect rect(collision * 16, elevation * 16, 16, 16);
+    return Editor::collisionAtlas.rect().contains(rect) ? rect : QRect();
+}
+
 QImage getCollisionMetatileImage(int collision, int elevation) {
-    const QImage * image = Editor::collisionIcons.at(collision).at(elevation);
-    return image ? *image : QImage();
+    QRect rect = getCollisionIconRect(collision, elevation);
+    return rect.isValid() ? Editor::collisionAtlas.copy(rect) : QImage();
+}
+
+// Copy a collision icon straight from the atlas into the destination image.
+// The destination must use the atlas' image format (see Editor::setCollisionGraphics).
+void drawCollisionMetatile(QImage *dest, const QPoint &origin, int collision, int elevation) {
+    QRect rect = getCollisionIconRect(collision, elevation);
+    if (rect.isValid())
+        blitImage(dest, origin, Editor::collisionAtlas, rect);
+}
+
+// Copy the pixels in 'sourceRect' of 'source' to 'dest' at 'origin', with no blending.
+// Both images must have the same 32-bit format. The copy is clipped to the bounds of both images.
+void blitImage(QImage *dest, const QPoint &origin, const QImage &source, const QRect &sourceRect) {
+    if (!dest || dest->isNull() || source.isNull() || dest->format() != source.format() || source.depth() != 32)
+        return;
+
+    int srcX = sourceRect.x(), srcY = sourceRect.y();
+    int destX = origin.x(), destY = origin.y();
+    int width = sourceRect.width(), height = sourceRect.height();
+    if (srcX < 0)  { destX -= srcX; width += srcX;  srcX = 0; }
+    if (srcY < 0)  { destY -= srcY; height += srcY; srcY = 0; }
+    if (destX < 0) { srcX -= destX; width += destX;  destX = 0; }
+    if (destY < 0) { srcY -= destY; height += destY; destY = 0; }
+    width = qMin(width, qMin(source.width() - srcX, dest->width() - destX));
+    height = qMin(height, qMin(source.height() - srcY, dest->height() - destY));
+    if (width <= 0 || height <= 0)
+        return;
+
+    for (int y = 0; y < height; y++) {
+        memcpy(dest->scanLine(destY + y) + destX * 4, source.constScanLine(srcY + y) + srcX * 4, width * 4);
+    }
 }
 
 QImage getMetatileImage(
@@ -30,6 +69,34 @@ QImage getMetatileImage(
     return getMetatileImage(metatile, primaryTileset, secondaryTileset, layerOrder, layerOpacity, useTruePalettes);
 }
 
+// Source-over compositing of one premultiplied ARGB color onto another.
+static inline QRgb blendPremultiplied(QRgb src, QRgb dst) {
+    const uint inv = 255 - qAlpha(src);
+    return qRgba(qRed(src) + (qRed(dst) * inv + 127) / 255,
+                 qGreen(src) + (qGreen(dst) * inv + 127) / 255,
+                 qBlue(src) + (qBlue(dst) * inv + 127) / 255,
+                 qAlpha(src) + (qAlpha(dst) * inv + 127) / 255);
+}
+
+// Draws an 8x8 indexed tile onto a premultiplied ARGB image, looking up each pixel in 'colors'.
+static void drawTile(QImage *dest, const QPoint &origin, const QImage &tile, const QRgb *colors, bool xflip, bool yflip) {
+    const int w = qMin(tile.width(), 8);
+    const int h = qMin(tile.height(), 8);
+    for (int y = 0; y < h; y++) {
+        const uchar *src = tile.constScanLine(yflip ? (h - 1 - y) : y);
+        QRgb *out = reinterpret_cast<QRgb*>(dest->scanLine(origin.y() + y)) + origin.x();
+        for (int x = 0; x < w; x++) {
+            const QRgb color = colors[src[xflip ? (w - 1 - x) : x] % PaletteTable::numColors];
+            const int alpha = qAlpha(color);
+            if (alpha == 255) {
+                out[x] = color;
+            } else if (alpha != 0) {
+                out[x] = blendPremultiplied(color, out[x]);
+            }
+        }
+    }
+}
+
 QImage getMetatileImage(
         Metatile *metatile,
         Tileset *primaryTileset,
@@ -38,16 +105,16 @@ QImage getMetatileImage(
         QList<float> layerOpacity,
         bool useTruePalettes)
 {
-    QImage metatile_image(16, 16, QImage::Format_RGBA8888);
+    QImage metatile_image(16, 16, QImage::Format_ARGB32_Premultiplied);
     if (!metatile) {
         metatile_image.fill(Qt::magenta);
         return metatile_image;
     }
     metatile_image.fill(Qt::black);
 
-    QList<QList<QRgb>> palettes = Tileset::getBlockPalettes(primaryTileset, secondaryTileset, useTruePalettes);
+    // The colors for each palette, layer and transparency are computed once per tileset pair, not per tile.
+    QSharedPointer<const PaletteTable> palettes = PaletteTable::get(primaryTileset, secondaryTileset, layerOpacity, useTruePalettes);
 
-    QPainter metatile_painter(&metatile_image);
     const int numLayers = 3; // When rendering, metatiles always have 3 layers
     uint32_t layerType = metatile->layerType();
     for (int layer = 0; layer < numLayers; layer++)
@@ -88,49 +155,36 @@ QImage getMetatileImage(
             }
         }
 
+        QPoint origin = QPoint(x*8, y*8);
         QImage tile_image = getTileImage(tile.tileId, primaryTileset, secondaryTileset);
         if (tile_image.isNull()) {
             // Some metatiles specify tiles that are outside the valid range.
             // These are treated as completely transparent, so they can be skipped without
             // being drawn unless they're on the bottom layer, in which case we need
             // a placeholder because garbage will be drawn otherwise.
-            if (l == bottomLayer) {
-                metatile_painter.fillRect(x * 8, y * 8, 8, 8, palettes.value(0).value(0));
+            const QRgb *colors = palettes->colors(0);
+            if (l == bottomLayer && colors) {
+                for (int i = 0; i < 8; i++)
+                    std::fill_n(reinterpret_cast<QRgb*>(metatile_image.scanLine(origin.y() + i)) + origin.x(), 8, colors[0]);
             }
             continue;
         }
+        if (tile_image.format() != QImage::Format_Indexed8)
+            tile_image = tile_image.convertToFormat(QImage::Format_Indexed8);
 
         // Colorize the metatile tiles with its palette.
-        if (tile.palette < palettes.length()) {
-            QList<QRgb> palette = palettes.value(tile.palette);
-            for (int j = 0; j < palette.length(); j++) {
-                tile_image.setColor(j, palette.value(j));
-            }
-        } else {
-            logWarn(QString("Tile '%1' is referring to invalid palette number: '%2'").arg(tile.tileId).arg(tile.palette));
-        }
-
-        QPoint origin = QPoint(x*8, y*8);
-        float opacity = layerOpacity.size() >= numLayers ? layerOpacity[l] : 1.0;
-        if (opacity < 1.0) {
-            int alpha = 255 * opacity;
-            for (int c = 0; c < tile_image.colorCount(); c++) {
-                QColor color(tile_image.color(c));
-                color.setAlpha(alpha);
-                tile_image.setColor(c, color.rgba());
-            }
-        }
-
         // The top layer of the metatile has its first color displayed at transparent.
-        if (l != bottomLayer) {
-            QColor color(tile_image.color(0));
-            color.setAlpha(0);
-            tile_image.setColor(0, color.rgba());
+        const QRgb *colors = palettes->colors(tile.palette, l, l != bottomLayer);
+        QRgb tileColors[PaletteTable::numColors];
+        if (!colors) {
+            logWarn(QString("Tile '%1' is referring to invalid palette number: '%2'").arg(tile.tileId).arg(tile.palette));
+            float opacity = layerOpacity.size() >= numLayers ? layerOpacity[l] : 1.0;
+            PaletteTable::makeLayerColors(tile_image.colorTable().toList(), opacity, l != bottomLayer, tileColors);
+            colors = tileColors;
         }
 
-        metatile_painter.drawImage(origin, tile_image.mirrored(tile.xflip, tile.yflip));
+        drawTile(&metatile_image, origin, tile_image, colors, tile.xflip, tile.yflip);
     }
-    metatile_painter.end();
 
     return metatile_image;
 }
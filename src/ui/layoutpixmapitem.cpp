@@ -2,11 +2,28 @@
 #include "metatile.h"
 #include "log.h"
 #include "scripting.h"
+#include "imageproviders.h"
 
 #include "editcommands.h"
 
+#include <QStyleOptionGraphicsItem>
+
 #define SWAP(a, b) do { if (a != b) { a ^= b; b ^= a; a ^= b; } } while (0)
 
+LayoutPixmapItem::LayoutPixmapItem(Layout *layout, MetatileSelector *metatileSelector, Settings *settings)
+    : chunks([this](int x, int y, Block *block) { return this->getChunkBlock(x, y, block); },
+             [this](QImage *image, const QPoint &origin, const Block &block) { this->drawBlock(image, origin, block); })
+{
+    this->layout = layout;
+    // this->map->setMapItem(this);
+    this->metatileSelector = metatileSelector;
+    this->settings = settings;
+    this->lockedAxis = LayoutPixmapItem::Axis::None;
+    this->prevStraightPathState = false;
+    setAcceptHoverEvents(true);
+    setFlag(ItemUsesExtendedStyleOption, true);
+}
+
 void LayoutPixmapItem::paint(QGraphicsSceneMouseEvent *event) {
     if (layout) {
         if (event->type() == QEvent::GraphicsSceneMouseRelease) {
@@ -684,8 +701,95 @@ void LayoutPixmapItem::select(QGraphicsSceneMouseEvent *event) {
 void LayoutPixmapItem::draw(bool ignoreCache) {
     if (this->layout) {
         layout->setLayoutItem(this);
-        setPixmap(this->layout->render(ignoreCache));
+        if (ignoreCache)
+            this->metatileImageCache.clear();
+        redraw(ignoreCache);
+    }
+}
+
+// Nothing is rendered here. Chunks that are out of date are re-rendered when they're next painted.
+void LayoutPixmapItem::redraw(bool ignoreCache) {
+    if (!this->layout)
+        return;
+
+    QSize newSize(this->layout->getWidth(), this->layout->getHeight());
+    if (newSize != this->layoutSize) {
+        prepareGeometryChange();
+        this->layoutSize = newSize;
+        ignoreCache = true;
+    }
+    if (ignoreCache)
+        this->chunks.invalidate();
+    update();
+}
+
+bool LayoutPixmapItem::getChunkBlock(int x, int y, Block *block) const {
+    return this->layout && this->layout->getBlock(x, y, block);
+}
+
+void LayoutPixmapItem::drawBlock(QImage *image, const QPoint &origin, const Block &block) {
+    // Most layouts reuse a small number of metatiles, so we hold on to each metatile image after it's first rendered.
+    auto it = this->metatileImageCache.find(block.metatileId());
+    if (it == this->metatileImageCache.end()) {
+        QImage metatileImage = getMetatileImage(
+            block.metatileId(),
+            this->layout->tileset_primary,
+            this->layout->tileset_secondary,
+            this->layout->metatileLayerOrder,
+            this->layout->metatileLayerOpacity
+        ).convertToFormat(ChunkCache::imageFormat);
+        it = this->metatileImageCache.insert(block.metatileId(), metatileImage);
+    }
+    blitImage(image, origin, it.value(), it->rect());
+}
+
+QRectF LayoutPixmapItem::boundingRect() const {
+    return QRectF(0, 0, this->layoutSize.width() * 16, this->layoutSize.height() * 16);
+}
+
+QPainterPath LayoutPixmapItem::shape() const {
+    QPainterPath path;
+    path.addRect(boundingRect());
+    return path;
+}
+
+void LayoutPixmapItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *) {
+    const QRect exposedRect = option->exposedRect.toAlignedRect().intersected(boundingRect().toAlignedRect());
+    this->chunks.draw(painter, exposedRect);
+}
+
+QImage LayoutPixmapItem::thumbnail(int maxSize) {
+    if (!this->layout)
+        return QImage();
+    const int width = this->layout->getWidth();
+    const int height = this->layout->getHeight();
+    if (width <= 0 || height <= 0 || maxSize <= 0)
+        return QImage();
+
+    // Each metatile is drawn as a 'scale'-sized square, and each square shows the block at the matching position in the layout.
+    const int scale = qBound(1, maxSize / qMax(width, height), 16);
+    const int columns = qMin(width, maxSize / scale);
+    const int rows = qMin(height, maxSize / scale);
+    QImage image(columns * scale, rows * scale, ChunkCache::imageFormat);
+    image.fill(Qt::transparent);
+
+    QHash<uint16_t, QImage> scaledMetatiles;
+    for (int row = 0; row < rows; row++)
+    for (int column = 0; column < columns; column++) {
+        Block block;
+        if (!getChunkBlock(column * width / columns, row * height / rows, &block))
+            continue;
+        auto it = scaledMetatiles.find(block.metatileId());
+        if (it == scaledMetatiles.end()) {
+            QImage metatileImage(16, 16, ChunkCache::imageFormat);
+            metatileImage.fill(Qt::transparent);
+            drawBlock(&metatileImage, QPoint(0, 0), block);
+            metatileImage = metatileImage.scaled(scale, scale, Qt::IgnoreAspectRatio, Qt::SmoothTransformation).convertToFormat(ChunkCache::imageFormat);
+            it = scaledMetatiles.insert(block.metatileId(), metatileImage);
+        }
+        blitImage(&image, QPoint(column * scale, row * scale), it.value(), it->rect());
     }
+    return image;
 }
 
 void LayoutPixmapItem::hoverMoveEvent(QGraphicsSceneHoverEvent *event) {
@@ -0,0 +1,89 @@
+#include "mapborderitem.h"
+#include "maplayout.h"
+#include "imageproviders.h"
+#include "editor.h"
+
+#include <QStyleOptionGraphicsItem>
+
+MapBorderItem::MapBorderItem(Layout *layout)
+    : layout(layout),
+      chunks([this](int x, int y, Block *block) { return this->getBlock(x, y, block); },
+             [this](QImage *image, const QPoint &origin, const Block &block) { this->drawBlock(image, origin, block); })
+{
+    setFlag(ItemUsesExtendedStyleOption, true);
+}
+
+// The border is drawn in full repetitions outward from the map's top-left corner
+// until it covers at least BORDER_DISTANCE metatiles on each side of the map.
+void MapBorderItem::draw(bool ignoreCache) {
+    if (!this->layout)
+        return;
+
+    QRect newArea;
+    const int borderWidth = this->layout->getBorderWidth();
+    const int borderHeight = this->layout->getBorderHeight();
+    if (borderWidth > 0 && borderHeight > 0) {
+        const int horzDist = Layout::getBorderDrawDistance(borderWidth);
+        const int vertDist = Layout::getBorderDrawDistance(borderHeight);
+        const int numHorz = (this->layout->getWidth() + horzDist * 2 + borderWidth - 1) / borderWidth;
+        const int numVert = (this->layout->getHeight() + vertDist * 2 + borderHeight - 1) / borderHeight;
+        newArea = QRect(-horzDist, -vertDist, numHorz * borderWidth, numVert * borderHeight);
+    }
+
+    if (newArea != this->area) {
+        prepareGeometryChange();
+        this->area = newArea;
+        ignoreCache = true;
+    }
+    if (ignoreCache) {
+        this->metatileImageCache.clear();
+        this->chunks.invalidate();
+    }
+    update();
+}
+
+bool MapBorderItem::getBlock(int x, int y, Block *block) const {
+    if (!this->layout || !this->area.contains(x, y))
+        return false;
+
+    // The map itself covers the border, no need to draw anything there.
+    if (this->layout->isWithinBounds(x, y))
+        return false;
+
+    const int borderWidth = this->layout->getBorderWidth();
+    const int borderHeight = this->layout->getBorderHeight();
+    int borderX = x % borderWidth;
+    int borderY = y % borderHeight;
+    if (borderX < 0) borderX += borderWidth;
+    if (borderY < 0) borderY += borderHeight;
+
+    const int i = borderY * borderWidth + borderX;
+    if (i >= this->layout->border.length())
+        return false;
+    *block = this->layout->border.at(i);
+    return true;
+}
+
+void MapBorderItem::drawBlock(QImage *image, const QPoint &origin, const Block &block) {
+    auto it = this->metatileImageCache.find(block.metatileId());
+    if (it == this->metatileImageCache.end()) {
+        QImage metatileImage = getMetatileImage(
+            block.metatileId(),
+            this->layout->tileset_primary,
+            this->layout->tileset_secondary,
+            this->layout->metatileLayerOrder,
+            this->layout->metatileLayerOpacity
+        ).convertToFormat(ChunkCache::imageFormat);
+        it = this->metatileImageCache.insert(block.metatileId(), metatileImage);
+    }
+    blitImage(image, origin, it.value(), it->rect());
+}
+
+QRectF MapBorderItem::boundingRect() const {
+    return QRectF(this->area.x() * 16, this->area.y() * 16, this->area.width() * 16, this->area.height() * 16);
+}
+
+void MapBorderItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *) {
+    const QRect exposedRect = option->exposedRect.toAlignedRect().intersected(boundingRect().toAlignedRect());
+    this->chunks.draw(painter, exposedRect);
+}
@@ -3,13 +3,12 @@
 #include "qgifimage.h"
 #include "editcommands.h"
 #include "filedialog.h"
+#include "tracer.h"
 
 #include <QImage>
 #include <QPainter>
 #include <QPoint>
 
-#define STITCH_MODE_BORDER_DISTANCE 2
-
 QString getTitle(ImageExporterMode mode) {
     switch (mode)
     {
@@ -79,6 +78,7 @@ void MapImageExporter::resizeEvent(QResizeEvent *event) {
 }
 
 void MapImageExporter::saveImage() {
+    TRACE_SCOPE("MapImageExporter::saveImage");
     // Make sure preview is up-to-date before we save.
     if (this->preview.isNull())
         updatePreview();
@@ -256,141 +256,26 @@ bool MapImageExporter::historyItemAppliesToFrame(const QUndoCommand *command) {
     }
 }
 
-struct StitchedMap {
-    int x;
-    int y;
-    Map* map;
-};
-
-QPixmap MapImageExporter::getStitchedImage(QProgressDialog *progress, bool includeBorder) {
-    // Do a breadth-first search to gather a collection of
-    // all reachable maps with their relative offsets.
-    QSet<QString> visited;
-    QList<StitchedMap> stitchedMaps;
-    QList<StitchedMap> unvisited;
-    unvisited.append(StitchedMap{0, 0, this->editor->map});
-
-    progress->setLabelText("Gathering stitched maps...");
-    while (!unvisited.isEmpty()) {
-        if (progress->wasCanceled()) {
-            return QPixmap();
-        }
-        progress->setMaximum(visited.size() + unvisited.size());
-        progress->setValue(visited.size());
-
-        StitchedMap cur = unvisited.takeFirst();
-        if (visited.contains(cur.map->name))
-            continue;
-        visited.insert(cur.map->name);
-        stitchedMaps.append(cur);
-
-        for (MapConnection *connection : cur.map->getConnections()) {
-            const QString direction = connection->direction();
-            int x = cur.x;
-            int y = cur.y;
-            int offset = connection->offset();
-            Map *connectionMap = connection->targetMap();
-            if (!connectionMap)
-                continue;
-            if (direction == "up") {
-                x += offset;
-                y -= connectionMap->getHeight();
-            } else if (direction == "down") {
-                x += offset;
-                y += cur.map->getHeight();
-            } else if (direction == "left") {
-                x -= connectionMap->getWidth();
-                y += offset;
-            } else if (direction == "right") {
-                x += cur.map->getWidth();
-                y += offset;
-            } else {
-                // Ignore Dive/Emerge connections and unrecognized directions
-                continue;
-            }
-            unvisited.append(StitchedMap{x, y, connectionMap});
-        }
-    }
-
-    // Determine the overall dimensions of the stitched maps.
-    int maxX = INT_MIN;
-    int minX = INT_MAX;
-    int maxY = INT_MIN;
-    int minY = INT_MAX;
-    for (StitchedMap map : stitchedMaps) {
-        int left = map.x;
-        int right = map.x + map.map->getWidth();
-        int top = map.y;
-        int bottom = map.y + map.map->getHeight();
-        if (left < minX)
-            minX = left;
-        if (right > maxX)
-            maxX = right;
-        if (top < minY)
-            minY = top;
-        if (bottom > maxY)
-            maxY = bottom;
-    }
-
-    if (includeBorder) {
-        minX -= STITCH_MODE_BORDER_DISTANCE;
-        maxX += STITCH_MODE_BORDER_DISTANCE;
-        minY -= STITCH_MODE_BORDER_DISTANCE;
-        maxY += STITCH_MODE_BORDER_DISTANCE;
-    }
-
-    // Draw the maps on the full canvas, while taking
-    // their respective offsets into account.
-    progress->setLabelText("Drawing stitched maps...");
-    progress->setValue(0);
-    progress->setMaximum(stitchedMaps.size());
-    int numDrawn = 0;
-    QPixmap stitchedPixmap((maxX - minX) * 16, (maxY - minY) * 16);
-    stitchedPixmap.fill(Qt::black);
-    QPainter painter(&stitchedPixmap);
-    for (StitchedMap map : stitchedMaps) {
-        if (progress->wasCanceled()) {
-            return QPixmap();
-        }
-        progress->setValue(numDrawn);
-        numDrawn++;
-
-        int pixelX = (map.x - minX) * 16;
-        int pixelY = (map.y - minY) * 16;
-        if (includeBorder) {
-            pixelX -= STITCH_MODE_BORDER_DISTANCE * 16;
-            pixelY -= STITCH_MODE_BORDER_DISTANCE * 16;
-        }
-        QPixmap pixmap = this->getFormattedMapPixmap(map.map);
-        painter.drawPixmap(pixelX, pixelY, pixmap);
-    }
-
-    // When including the borders, we simply draw all the maps again
-    // without their borders, since the first pass results in maps
-    // being occluded by other map borders.
-    if (includeBorder) {
-        progress->setLabelText("Drawing stitched maps without borders...");
-        progress->setValue(0);
-        progress->setMaximum(stitchedMaps.size());
-        numDrawn = 0;
-        for (StitchedMap map : stitchedMaps) {
-            if (progress->wasCanceled()) {
-                return QPixmap();
-            }
-            progress->setValue(numDrawn);
-            numDrawn++;
-
-            int pixelX = (map.x - minX) * 16;
-            int pixelY = (map.y - minY) * 16;
-            QPixmap pixmapWithoutBorders = this->getFormattedMapPixmap(map.map, true);
-            painter.drawPixmap(pixelX, pixelY, pixmapWithoutBorders);
-        }
-    }
+MapImageRenderer MapImageExporter::getRenderer() const {
+    ImageExporterSettings settings = this->settings;
+    settings.collisionOpacity = this->editor->collisionOpacity;
+    int borderDistance = this->mode == ImageExporterMode::Normal ? BORDER_DISTANCE : STITCH_MODE_BORDER_DISTANCE;
+    return MapImageRenderer(this->editor->project, settings, borderDistance);
+}
 
-    return stitchedPixmap;
+QPixmap MapImageExporter::getStitchedImage(QProgressDialog *progress) {
+    return getRenderer().renderStitched(this->editor->map, [progress](const QString &label, int value, int maximum) {
+        if (progress->wasCanceled())
+            return false;
+        progress->setLabelText(label);
+        progress->setMaximum(maximum);
+        progress->setValue(value);
+        return true;
+    });
 }
 
 void MapImageExporter::updatePreview() {
+    TRACE_SCOPE("MapImageExporter::updatePreview");
     if (this->scene) {
         delete this->scene;
         this->scene = nullptr;
@@ -403,7 +288,7 @@ void MapImageExporter::updatePreview() {
         progress.setWindowModality(Qt::WindowModal);
         progress.setModal(true);
         progress.setMinimumDuration(1000);
-        this->preview = getStitchedImage(&progress, this->settings.showBorder);
+        this->preview = getStitchedImage(&progress);
         progress.close();
     } else {
         // Timelapse mode doesn't currently have a real preview. It just displays the current map as in Normal mode.
@@ -420,116 +305,9 @@ void MapImageExporter::scalePreview() {
     }
 }
 
-// THIS
-QPixmap MapImageExporter::getFormattedMapPixmap(Map *map, bool ignoreBorder) {
-    QPixmap pixmap;
-
-    Layout *layout;
-
-    // draw background layer / base image
-    if (!this->map) {
-        layout = this->layout;
-        layout->render(true);
-        pixmap = layout->pixmap;
-    } else {
-        layout = map->layout;
-        map->layout->render(true);
-        pixmap = map->layout->pixmap;
-    }
-
-    if (this->settings.showCollision) {
-        QPainter collisionPainter(&pixmap);
-        layout->renderCollision(true);
-        collisionPainter.setOpacity(editor->collisionOpacity);
-        collisionPainter.drawPixmap(0, 0, layout->collision_pixmap);
-        collisionPainter.end();
-    }
-
-    // draw map border
-    // note: this will break when allowing map to be selected from drop down maybe
-    int borderHeight = 0, borderWidth = 0;
-    if (!ignoreBorder && this->settings.showBorder) {
-        int borderDistance = this->mode ? STITCH_MODE_BORDER_DISTANCE : BORDER_DISTANCE;
-        layout->renderBorder();
-        int borderHorzDist = editor->getBorderDrawDistance(layout->getBorderWidth());
-        int borderVertDist = editor->getBorderDrawDistance(layout->getBorderHeight());
-        borderWidth = borderDistance * 16;
-        borderHeight = borderDistance * 16;
-        QPixmap newPixmap = QPixmap(layout->pixmap.width() + borderWidth * 2, layout->pixmap.height() + borderHeight * 2);
-        QPainter borderPainter(&newPixmap);
-        for (int y = borderDistance - borderVertDist; y < layout->getHeight() + borderVertDist * 2; y += layout->getBorderHeight()) {
-            for (int x = borderDistance - borderHorzDist; x < layout->getWidth() + borderHorzDist * 2; x += layout->getBorderWidth()) {
-                borderPainter.drawPixmap(x * 16, y * 16, layout->border_pixmap);
-            }
-        }
-        borderPainter.drawImage(borderWidth, borderHeight, pixmap.toImage());
-        borderPainter.end();
-        pixmap = newPixmap;
-    }
-
-    if (!this->map) {
-        return pixmap;
-    }
-
-    if (!ignoreBorder && (this->settings.showUpConnections || this->settings.showDownConnections || this->settings.showLeftConnections || this->settings.showRightConnections)) {
-        // if showing connections, draw on outside of image
-        QPainter connectionPainter(&pixmap);
-        // TODO: Reading the connections from the editor and not 'map' is incorrect.
-        for (auto connectionItem : editor->connection_items) {
-            const QString direction = connectionItem->connection->direction();
-            if ((this->settings.showUpConnections && direction == "up")
-             || (this->settings.showDownConnections && direction == "down")
-             || (this->settings.showLeftConnections && direction == "left")
-             || (this->settings.showRightConnections && direction == "right"))
-                connectionPainter.drawImage(connectionItem->x() + borderWidth, connectionItem->y() + borderHeight,
-                                            connectionItem->connection->getPixmap().toImage());
-        }
-        connectionPainter.end();
-    }
-
-    // draw events
-    if (this->settings.showObjects || this->settings.showWarps || this->settings.showBGs || this->settings.showTriggers || this->settings.showHealLocations) {
-        QPainter eventPainter(&pixmap);
-        int pixelOffset = 0;
-        if (!ignoreBorder && this->settings.showBorder) {
-            pixelOffset = this->mode == ImageExporterMode::Normal ? BORDER_DISTANCE * 16 : STITCH_MODE_BORDER_DISTANCE * 16;
-        }
-        const QList<Event *> events = map->getAllEvents();
-        for (const auto &event : events) {
-            Event::Group group = event->getEventGroup();
-            if ((this->settings.showObjects && group == Event::Group::Object)
-             || (this->settings.showWarps && group == Event::Group::Warp)
-             || (this->settings.showBGs && group == Event::Group::Bg)
-             || (this->settings.showTriggers && group == Event::Group::Coord)
-             || (this->settings.showHealLocations && group == Event::Group::Heal)) {
-                editor->project->setEventPixmap(event);
-                eventPainter.drawImage(QPoint(event->getPixelX() + pixelOffset, event->getPixelY() + pixelOffset), event->getPixmap().toImage());
-            }
-        }
-        eventPainter.end();
-    }
-
-    // draw grid directly onto the pixmap
-    // since the last grid lines are outside of the pixmap, add a pixel to the bottom and right
-    if (this->settings.showGrid) {
-        int addX = 1, addY = 1;
-        if (borderHeight) addY = 0;
-        if (borderWidth) addX = 0;
-
-        QPixmap newPixmap= QPixmap(pixmap.width() + addX, pixmap.height() + addY);
-        QPainter gridPainter(&newPixmap);
-        gridPainter.drawImage(QPoint(0, 0), pixmap.toImage());
-        for (int x = 0; x < newPixmap.width(); x += 16) {
-            gridPainter.drawLine(x, 0, x, newPixmap.height());
-        }
-        for (int y = 0; y < newPixmap.height(); y += 16) {
-            gridPainter.drawLine(0, y, newPixmap.width(), y);
-        }
-        gridPainter.end();
-        pixmap = newPixmap;
-    }
-
-    return pixmap;
+QPixmap MapImageExporter::getFormattedMapPixmap(Map *map) {
+    // Without a map, only the layout is drawn.
+    return getRenderer().render(this->map ? map : nullptr, this->layout);
 }
 
 void MapImageExporter::updateShowBorderState() {
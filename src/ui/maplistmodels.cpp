@@ -38,6 +38,17 @@ void MapTree::keyPressEvent(QKeyEvent *event) {
     }
 }
 
+void MapListModel::updateItemIcon(const QString &id) {
+    const QModelIndex index = this->indexOf(id);
+    if (index.isValid())
+        emit dataChanged(index, index, {Qt::DecorationRole});
+}
+
+void MapListModel::updateItemIcons(const QStringList &ids) {
+    for (const auto &id : ids)
+        updateItemIcon(id);
+}
+
 void MapListModel::removeItemAt(const QModelIndex &index) {
     QStandardItem *item = this->getItem(index)->child(index.row(), index.column());
     if (!item)
@@ -322,6 +333,13 @@ QStandardItem *MapGroupModel::getItem(const QModelIndex &index) const {
     return this->root;
 }
 
+void MapGroupModel::setMap(QString mapName) {
+    const QString oldMap = this->openMap;
+    this->openMap = mapName;
+    updateItemIcon(oldMap);
+    updateItemIcon(mapName);
+}
+
 QModelIndex MapGroupModel::indexOf(QString mapName) const {
     if (this->mapItems.contains(mapName)) {
         return this->mapItems[mapName]->index();
@@ -490,6 +508,13 @@ QStandardItem *MapAreaModel::getItem(const QModelIndex &index) const {
     return this->root;
 }
 
+void MapAreaModel::setMap(QString mapName) {
+    const QString oldMap = this->openMap;
+    this->openMap = mapName;
+    updateItemIcon(oldMap);
+    updateItemIcon(mapName);
+}
+
 QModelIndex MapAreaModel::indexOf(QString mapName) const {
     if (this->mapItems.contains(mapName)) {
         return this->mapItems[mapName]->index();
@@ -644,6 +669,13 @@ QStandardItem *LayoutTreeModel::getItem(const QModelIndex &index) const {
     return this->root;
 }
 
+void LayoutTreeModel::setLayout(QString layoutId) {
+    const QString oldLayout = this->openLayout;
+    this->openLayout = layoutId;
+    updateItemIcon(oldLayout);
+    updateItemIcon(layoutId);
+}
+
 QModelIndex LayoutTreeModel::indexOf(QString layoutName) const {
     if (this->layoutItems.contains(layoutName)) {
         return this->layoutItems[layoutName]->index();
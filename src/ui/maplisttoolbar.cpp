@@ -93,7 +93,6 @@ void MapListToolBar::setEmptyFoldersVisible(bool visible) {
         auto model = static_cast<FilterChildrenProxyModel*>(m_list->model());
         if (model) {
             model->setHideEmpty(!visible);
-            model->setFilterRegularExpression(ui->lineEdit_filterBox->text());
         }
     }
 
@@ -125,7 +124,7 @@ void MapListToolBar::applyFilter(const QString &filterText) {
 
     if (m_list) {
         auto model = static_cast<FilterChildrenProxyModel*>(m_list->model());
-        if (model) model->setFilterRegularExpression(QRegularExpression(filterText, QRegularExpression::CaseInsensitiveOption));
+        if (model) model->setFilterText(filterText);
 
         if (filterText.isEmpty()) {
             m_list->collapseAll();
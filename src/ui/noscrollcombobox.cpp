@@ -1,4 +1,5 @@
 #include "noscrollcombobox.h"
+#include "identifierlistmodel.h"
 
 #include <QCompleter>
 #include <QLineEdit>
@@ -72,7 +73,9 @@ void NoScrollComboBox::setItem(int index, const QString &text)
 
 void NoScrollComboBox::setTextItem(const QString &text)
 {
-    this->setItem(this->findText(text), text);
+    // A shared model can find the text without searching every item.
+    int index = (this->sharedModel && this->model() == this->sharedModel) ? this->sharedModel->indexOf(text) : this->findText(text);
+    this->setItem(index, text);
 }
 
 void NoScrollComboBox::setNumberItem(int value)
@@ -89,3 +92,41 @@ void NoScrollComboBox::setClearButtonEnabled(bool enabled) {
     if (this->lineEdit())
         this->lineEdit()->setClearButtonEnabled(enabled);
 }
+
+// Use a model shared with other combo boxes for the items, instead of each combo box having its own copy.
+void NoScrollComboBox::setSharedModel(IdentifierListModel *model) {
+    // Text entered by the user must not be inserted into the shared model.
+    this->setInsertPolicy(QComboBox::NoInsert);
+    if (!model || model == this->sharedModel)
+        return;
+    if (this->sharedModel)
+        disconnect(this->sharedModel.data(), nullptr, this, nullptr);
+    this->setModel(model);
+    this->sharedModel = model;
+    this->setSharedCompleterModel(model);
+
+    // The model is reset if its list changes (e.g. a map was added). That shouldn't look like a user edit
+    // to this combo box, so keep the current text and don't signal anything while that happens.
+    connect(model, &QAbstractItemModel::modelAboutToBeReset, this, [this] {
+        this->textBeforeReset = this->currentText();
+        this->blockSignals(true);
+    });
+    connect(model, &QAbstractItemModel::modelReset, this, [this] {
+        this->setTextItem(this->textBeforeReset);
+        this->blockSignals(false);
+    });
+}
+
+// Autocomplete from a shared model, which may be different from the model used for the items.
+void NoScrollComboBox::setSharedCompleterModel(IdentifierListModel *model) {
+    if (!this->lineEdit())
+        return;
+
+    auto completer = new IdentifierCompleter(model, this);
+    this->setCompleter(completer);
+    // The matches need to be updated before the line edit asks the completer to show them.
+    connect(this->lineEdit(), &QLineEdit::textEdited, completer->filterModel(), &IdentifierFilterModel::setFilterText);
+
+    delete this->sharedCompleter;
+    this->sharedCompleter = completer;
+}
@@ -2,6 +2,12 @@
 #include "scripting.h"
 #include "log.h"
 
+#include <QElapsedTimer>
+#include <QtMath>
+
+// Layers whose cached image would be larger than this many pixels are drawn item by item instead.
+static const qreal maxCachePixels = 4096 * 4096;
+
 void OverlayText::render(QPainter *painter) {
     QFont font = painter->font();
     font.setPixelSize(this->fontSize);
@@ -10,19 +16,75 @@ void OverlayText::render(QPainter *painter) {
     painter->drawStaticText(this->x, this->y, this->text);
 }
 
+QRectF OverlayText::boundingRect() const {
+    QFont font;
+    font.setPixelSize(this->fontSize);
+    QStaticText text = this->text;
+    text.prepare(QTransform(), font);
+    // Leave some room for glyphs that extend outside of the layout, and for differences from the painter's font.
+    return QRectF(QPointF(this->x, this->y), text.size()).adjusted(-4, -4, 4 + this->fontSize, 4 + this->fontSize / 2);
+}
+
 void OverlayPath::render(QPainter *painter) {
     painter->fillPath(this->path, this->fillColor);
     painter->setPen(this->borderColor);
     painter->drawPath(this->path);
 }
 
+QRectF OverlayPath::boundingRect() const {
+    // Include the width of the border.
+    return this->path.boundingRect().adjusted(-1, -1, 1, 1);
+}
+
 void OverlayPixmap::render(QPainter *painter) {
     painter->drawPixmap(this->x, this->y, this->pixmap);
 }
 
+QRectF OverlayPixmap::boundingRect() const {
+    return QRectF(this->x, this->y, this->pixmap.width(), this->pixmap.height());
+}
+
+QTransform Overlay::getTransform() {
+    QTransform transform;
+    transform.translate(this->x, this->y);
+    transform.rotate(this->angle);
+    transform.scale(this->hScale, this->vScale);
+    return transform;
+}
+
+// Redraw the cached image of the items if they or the zoom level have changed.
+// Returns false if the items should be drawn directly instead.
+bool Overlay::updateCache(qreal scale) {
+    if (this->cacheValid && this->cacheScale == scale)
+        return !this->cache.isNull();
+
+    this->cacheValid = true;
+    this->cacheScale = scale;
+    this->cache = QPixmap();
+    this->cacheRect = this->itemsRect.toAlignedRect();
+    if (this->items.isEmpty())
+        return false;
+
+    const QSize size(qCeil(this->cacheRect.width() * scale), qCeil(this->cacheRect.height() * scale));
+    if (size.isEmpty() || static_cast<qreal>(size.width()) * size.height() > maxCachePixels)
+        return false;
+
+    this->cache = QPixmap(size);
+    this->cache.fill(Qt::transparent);
+    QPainter painter(&this->cache);
+    painter.scale(scale, scale);
+    painter.translate(-this->cacheRect.topLeft());
+    for (auto item : this->items)
+        item->render(&painter);
+    return true;
+}
+
 void Overlay::renderItems(QPainter *painter) {
     if (this->hidden) return;
 
+    QElapsedTimer timer;
+    timer.start();
+
     painter->save();
 
     if (this->clippingRect) {
@@ -30,17 +92,43 @@ void Overlay::renderItems(QPainter *painter) {
         painter->setClipRect(*this->clippingRect);
     }
 
-    QTransform transform = painter->transform();
-    transform.translate(this->x, this->y);
-    transform.rotate(this->angle);
-    transform.scale(this->hScale, this->vScale);
-    painter->setTransform(transform);
+    // Cache the items at the view's zoom level, so they're drawn 1:1 on the screen unless the layer itself is scaled or rotated.
+    const QTransform viewTransform = painter->transform();
+    const qreal viewScale = qMax(qSqrt(viewTransform.m11() * viewTransform.m11() + viewTransform.m12() * viewTransform.m12()), 0.01);
 
+    painter->setTransform(getTransform() * viewTransform);
     painter->setOpacity(this->opacity);
-    for (auto item : this->items)
-        item->render(painter);
+    if (updateCache(viewScale)) {
+        painter->drawPixmap(this->cacheRect, this->cache, QRectF(this->cache.rect()));
+    } else {
+        for (auto item : this->items)
+            item->render(painter);
+    }
 
     painter->restore();
+
+    this->renderTime = timer.nsecsElapsed() / 1000000.0;
+}
+
+double Overlay::getRenderTime() {
+    return this->renderTime;
+}
+
+void Overlay::addItem(OverlayItem *item) {
+    const QRectF bounds = item->boundingRect();
+    this->items.append(item);
+    this->itemsRect = this->itemsRect.united(bounds);
+    this->changedRect = this->changedRect.united(bounds);
+    this->cacheValid = false;
+}
+
+// Returns the area in the scene covered by the items added since the last call, and resets it.
+QRectF Overlay::takeChangedRect() {
+    QRectF rect = getTransform().mapRect(this->changedRect);
+    if (this->clippingRect)
+        rect = rect.intersected(*this->clippingRect);
+    this->changedRect = QRectF();
+    return rect;
 }
 
 void Overlay::clearItems() {
@@ -48,6 +136,10 @@ void Overlay::clearItems() {
         delete item;
     }
     this->items.clear();
+    this->itemsRect = QRectF();
+    this->changedRect = QRectF();
+    this->cacheValid = false;
+    this->cache = QPixmap();
 }
 
 QList<OverlayItem*> Overlay::getItems() {
@@ -169,7 +261,7 @@ QColor Overlay::getColor(QString colorStr) {
 }
 
 void Overlay::addText(const QString text, int x, int y, QString colorStr, int fontSize) {
-    this->items.append(new OverlayText(text, x, y, getColor(colorStr), fontSize));
+    addItem(new OverlayText(text, x, y, getColor(colorStr), fontSize));
 }
 
 bool Overlay::addRect(int x, int y, int width, int height, QString borderColorStr, QString fillColorStr, int rounding) {
@@ -180,7 +272,7 @@ bool Overlay::addRect(int x, int y, int width, int height, QString borderColorSt
 
     QPainterPath path;
     path.addRoundedRect(QRectF(x, y, width, height), rounding, rounding, Qt::RelativeSize);
-    this->items.append(new OverlayPath(path, getColor(borderColorStr), getColor(fillColorStr)));
+    addItem(new OverlayPath(path, getColor(borderColorStr), getColor(fillColorStr)));
     return true;
 }
 
@@ -197,20 +289,19 @@ bool Overlay::addPath(QList<int> xCoords, QList<int> yCoords, QString borderColo
     for (int i = 1; i < numPoints; i++)
         path.lineTo(xCoords.at(i), yCoords.at(i));
 
-    this->items.append(new OverlayPath(path, getColor(borderColorStr), getColor(fillColorStr)));
+    addItem(new OverlayPath(path, getColor(borderColorStr), getColor(fillColorStr)));
     return true;
 }
 
 bool Overlay::addImage(int x, int y, QString filepath, bool useCache, int width, int height, int xOffset, int yOffset, qreal hScale, qreal vScale, QList<QRgb> palette, bool setTransparency) {
-    const QImage * baseImage = Scripting::getImage(filepath, useCache);
-    if (!baseImage || baseImage->isNull()) {
+    const QImage baseImage = Scripting::getImage(filepath, useCache);
+    if (baseImage.isNull()) {
         logError(QString("Failed to load image '%1'").arg(filepath));
         return false;
     }
-    QImage image = *baseImage;
 
-    int fullWidth = image.width();
-    int fullHeight = image.height();
+    int fullWidth = baseImage.width();
+    int fullHeight = baseImage.height();
 
     // Negative values used as an indicator for "use full dimension"
     if (width <= 0)
@@ -231,20 +322,17 @@ bool Overlay::addImage(int x, int y, QString filepath, bool useCache, int width,
         return false;
     }
 
-    // Get specified subset of image
+    // The recolored/resized image is cached too, so adding the same image again doesn't redo this.
+    ImageCache::Transform transform;
     if (width != fullWidth || height != fullHeight)
-        image = image.copy(xOffset, yOffset, width, height);
-
-    if (hScale != 1 || vScale != 1)
-        image = image.transformed(QTransform().scale(hScale, vScale));
-
-    for (int i = 0; i < palette.size(); i++)
-        image.setColor(i, palette.at(i));
-
-    if (setTransparency)
-        image.setColor(0, qRgba(0, 0, 0, 0));
-
-    this->items.append(new OverlayPixmap(x, y, QPixmap::fromImage(image)));
+        transform.crop = QRect(xOffset, yOffset, width, height);
+    transform.hScale = hScale;
+    transform.vScale = vScale;
+    transform.palette = palette;
+    transform.setTransparency = setTransparency;
+    const QImage image = Scripting::getImage(filepath, true, transform);
+
+    addItem(new OverlayPixmap(x, y, QPixmap::fromImage(image)));
     return true;
 }
 
@@ -253,6 +341,15 @@ bool Overlay::addImage(int x, int y, QImage image) {
         logError(QString("Failed to load custom image"));
         return false;
     }
-    this->items.append(new OverlayPixmap(x, y, QPixmap::fromImage(image)));
+    addItem(new OverlayPixmap(x, y, QPixmap::fromImage(image)));
+    return true;
+}
+
+bool Overlay::addImage(int x, int y, QPixmap pixmap) {
+    if (pixmap.isNull()) {
+        logError(QString("Failed to load custom image"));
+        return false;
+    }
+    addItem(new OverlayPixmap(x, y, pixmap));
     return true;
 }
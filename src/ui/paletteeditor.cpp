@@ -76,6 +76,7 @@ void PaletteEditor::setRgb(int colorIndex, QRgb rgb) {
     Tileset *tileset = getTileset(paletteId);
     tileset->palettes[paletteId][colorIndex] = rgb;
     tileset->palettePreviews[paletteId][colorIndex] = rgb;
+    tileset->markChanged();
 
     emit changedPaletteColor();
 }
@@ -86,6 +87,7 @@ void PaletteEditor::setPalette(int paletteId, const QList<QRgb> &palette) {
         tileset->palettes[paletteId][i] = palette.at(i);
         tileset->palettePreviews[paletteId][i] = palette.at(i);
     }
+    tileset->markChanged();
     refreshColorInputs();
     emit changedPaletteColor();
 }
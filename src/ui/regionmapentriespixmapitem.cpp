@@ -17,12 +17,7 @@ void RegionMapEntriesPixmapItem::draw() {
         entry_w = entry.width, entry_h = entry.height;
     }
 
-    QImage image(region_map->tilemapWidth() * 8, region_map->tilemapHeight() * 8, QImage::Format_RGBA8888);
-
-    QPainter painter(&image);
-    for (int i = 0; i < region_map->tilemapSize(); i++) {
-        QImage bottom_img = this->tile_selector->tileImg(region_map->getTile(i));
-        QImage top_img(8, 8, QImage::Format_RGBA8888);
+    const QImage &image = this->renderer.render([=](int i) {
         int x = i % region_map->tilemapWidth();
         int y = i / region_map->tilemapWidth();
         bool insideEntry = false;
@@ -33,22 +28,17 @@ void RegionMapEntriesPixmapItem::draw() {
                   && y - this->region_map->padTop() - entry_y < entry_h && y >= entry_y + this->region_map->padTop())
                 insideEntry = true;
         }
+        QColor color;
         if (insideEntry) {
-            top_img.fill(QColor(255, 68, 68));
+            color = QColor(255, 68, 68);
         } else if (region_map->squareHasMap(i)) {
-            top_img.fill(Qt::gray);
+            color = Qt::gray;
         } else {
-            top_img.fill(Qt::black);
+            color = Qt::black;
         }
-        QPoint pos = QPoint(x * 8, y * 8);
-        painter.setOpacity(1);
-        painter.drawImage(pos, bottom_img);
-        painter.save();
-        painter.setOpacity(0.65);
-        painter.drawImage(pos, top_img);
-        painter.restore();
-    }
-    painter.end();
+        color.setAlphaF(0.65);
+        return color.rgba();
+    });
 
     this->selectionOffsetX = entry_w - 1;
     this->selectionOffsetY = entry_h - 1;
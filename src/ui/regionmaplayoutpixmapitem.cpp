@@ -3,33 +3,13 @@
 void RegionMapLayoutPixmapItem::draw() {
     if (!region_map) return;
 
-    QImage image(region_map->pixelWidth(), region_map->pixelHeight(), QImage::Format_RGBA8888);
-
-    QPainter painter(&image);
-    for (int i = 0; i < region_map->tilemapSize(); i++) {
-        QImage bottom_img = this->tile_selector->tileImg(region_map->getTile(i));
-        QImage top_img(8, 8, QImage::Format_RGBA8888);
-        if (region_map->squareHasMap(i)) {
-            top_img.fill(Qt::gray);
-        } else {
-            top_img.fill(Qt::black);
-        }
+    const QImage &image = this->renderer.render([this](int i) {
+        QColor color = region_map->squareHasMap(i) ? QColor(Qt::gray) : QColor(Qt::black);
         int x = i % region_map->tilemapWidth();
         int y = i / region_map->tilemapWidth();
-        QPoint pos = QPoint(x * 8, y * 8);
-        painter.setOpacity(1);
-        painter.drawImage(pos, bottom_img);
-        painter.save();
-        if (region_map->squareInLayout(x, y)) {
-            painter.setOpacity(0.55);
-        } else {
-            painter.setOpacity(0.8);
-        }
-        
-        painter.drawImage(pos, top_img);
-        painter.restore();
-    }
-    painter.end();
+        color.setAlphaF(region_map->squareInLayout(x, y) ? 0.55 : 0.8);
+        return color.rgba();
+    });
 
     this->setPixmap(QPixmap::fromImage(image));
     this->drawSelection();
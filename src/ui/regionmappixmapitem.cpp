@@ -4,19 +4,7 @@
 void RegionMapPixmapItem::draw() {
     if (!region_map) return;
 
-    QImage image(region_map->pixelWidth(), region_map->pixelHeight(), QImage::Format_RGBA8888);
-
-    QPainter painter(&image);
-    for (int i = 0; i < region_map->tilemapSize(); i++) {
-        QImage img = this->tile_selector->tileImg(region_map->getTile(i));
-        int x = i % region_map->tilemapWidth();
-        int y = i / region_map->tilemapWidth();
-        QPoint pos = QPoint(x * 8, y * 8);
-        painter.drawImage(pos, img);
-    }
-    painter.end();
-
-    this->setPixmap(QPixmap::fromImage(image));
+    this->setPixmap(QPixmap::fromImage(this->renderer.render()));
 }
 
 void RegionMapPixmapItem::paint(QGraphicsSceneMouseEvent *event) {
@@ -36,31 +24,42 @@ void RegionMapPixmapItem::paint(QGraphicsSceneMouseEvent *event) {
 }
 
 void RegionMapPixmapItem::floodFill(int x, int y, std::shared_ptr<TilemapTile> oldTile, std::shared_ptr<TilemapTile> newTile) {
-    // out of bounds
-    if (x < 0
-     || y < 0
-     || x >= this->region_map->tilemapWidth()
-     || y >= this->region_map->tilemapHeight()) {
+    if (oldTile->operator==(*newTile))
         return;
-    }
 
-    auto tile = this->region_map->getTile(x, y);
-    if (!tile->operator==(*oldTile) || tile->operator==(*newTile)) {
-        return;
-    }
+    // Fill with an explicit stack rather than recursion, which could overflow on large tilemaps.
+    // The caller redraws the map once the whole area has been filled.
+    QVector<QPoint> toVisit;
+    toVisit.append(QPoint(x, y));
+    while (!toVisit.isEmpty()) {
+        const QPoint point = toVisit.takeLast();
+
+        // out of bounds
+        if (point.x() < 0
+         || point.y() < 0
+         || point.x() >= this->region_map->tilemapWidth()
+         || point.y() >= this->region_map->tilemapHeight()) {
+            continue;
+        }
+
+        auto tile = this->region_map->getTile(point.x(), point.y());
+        if (!tile->operator==(*oldTile)) {
+            continue;
+        }
 
-    int index = x + y * this->region_map->tilemapWidth();
-    this->region_map->setTileData(index,
-        newTile->id(),
-        newTile->hFlip(),
-        newTile->vFlip(),
-        newTile->palette()
-    );
-
-    floodFill(x + 1, y, oldTile, newTile);
-    floodFill(x - 1, y, oldTile, newTile);
-    floodFill(x, y + 1, oldTile, newTile);
-    floodFill(x, y - 1, oldTile, newTile);
+        int index = point.x() + point.y() * this->region_map->tilemapWidth();
+        this->region_map->setTileData(index,
+            newTile->id(),
+            newTile->hFlip(),
+            newTile->vFlip(),
+            newTile->palette()
+        );
+
+        toVisit.append(QPoint(point.x() + 1, point.y()));
+        toVisit.append(QPoint(point.x() - 1, point.y()));
+        toVisit.append(QPoint(point.x(), point.y() + 1));
+        toVisit.append(QPoint(point.x(), point.y() - 1));
+    }
 }
 
 void RegionMapPixmapItem::fill(QGraphicsSceneMouseEvent *event) {
@@ -0,0 +1,46 @@
+#include "regionmaprenderer.h"
+
+#include <QPainter>
+
+const QImage &RegionMapRenderer::getTileImage(shared_ptr<TilemapTile> tile) {
+    auto it = this->tileImages.constFind(tile->raw());
+    if (it == this->tileImages.constEnd())
+        it = this->tileImages.insert(tile->raw(), this->tileSelector->tileImg(tile));
+    return it.value();
+}
+
+const QImage &RegionMapRenderer::render(std::function<QRgb(int index)> overlay) {
+    if (!this->regionMap || !this->tileSelector)
+        return this->image;
+
+    const int width = this->regionMap->tilemapWidth();
+    const int size = this->regionMap->tilemapSize();
+    const QSize imageSize(width * 8, this->regionMap->tilemapHeight() * 8);
+    if (this->image.size() != imageSize || this->drawnTiles.size() != size) {
+        this->image = QImage(imageSize, QImage::Format_RGBA8888);
+        this->image.fill(Qt::transparent);
+        // No tile data has this key, so every tile is drawn.
+        this->drawnTiles.fill(~0ULL, size);
+    }
+
+    QPainter painter(&this->image);
+    for (int i = 0; i < size; i++) {
+        auto tile = this->regionMap->getTile(i);
+        const QRgb overlayColor = overlay ? overlay(i) : 0;
+        const quint64 key = (static_cast<quint64>(tile->raw()) << 32) | overlayColor;
+        if (this->drawnTiles.at(i) == key)
+            continue;
+        this->drawnTiles[i] = key;
+
+        const QPoint pos((i % width) * 8, (i / width) * 8);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.drawImage(pos, getTileImage(tile));
+        if (qAlpha(overlayColor)) {
+            painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+            painter.fillRect(QRect(pos, QSize(8, 8)), QColor::fromRgba(overlayColor));
+        }
+    }
+    painter.end();
+
+    return this->image;
+}
@@ -0,0 +1,87 @@
+#include "scriptstatsdialog.h"
+#include "scripting.h"
+
+#include <QDialogButtonBox>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+ScriptStatsDialog::ScriptStatsDialog(QWidget *parent) :
+    QDialog(parent)
+{
+    setAttribute(Qt::WA_DeleteOnClose);
+    setWindowTitle("Script Callback Stats");
+    resize(800, 300);
+
+    auto label = new QLabel("Callbacks that are too slow too many times in a row are throttled. "
+                            "Hover callbacks then only run once the mouse stops moving, and other callbacks stop running until the scripts are reloaded.");
+    label->setWordWrap(true);
+
+    this->table = new QTableWidget(0, 9);
+    this->table->setHorizontalHeaderLabels({"Script", "Callback", "Calls", "Skipped", "Total (ms)", "Average (ms)", "Max (ms)", "95th % (ms)", "Status"});
+    this->table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    this->table->setSelectionMode(QAbstractItemView::NoSelection);
+    this->table->verticalHeader()->setVisible(false);
+    this->table->horizontalHeader()->setStretchLastSection(true);
+
+    auto buttonBox = new QDialogButtonBox(QDialogButtonBox::Close);
+    QPushButton *resetButton = buttonBox->addButton("Reset", QDialogButtonBox::ResetRole);
+    connect(resetButton, &QPushButton::clicked, [this] {
+        Scripting::resetCallbackStats();
+        refresh();
+    });
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::close);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(label);
+    layout->addWidget(this->table);
+    layout->addWidget(buttonBox);
+
+    this->refreshTimer.setInterval(500);
+    connect(&this->refreshTimer, &QTimer::timeout, this, &ScriptStatsDialog::refresh);
+}
+
+void ScriptStatsDialog::showEvent(QShowEvent *event) {
+    refresh();
+    this->refreshTimer.start();
+    QDialog::showEvent(event);
+}
+
+void ScriptStatsDialog::hideEvent(QHideEvent *event) {
+    this->refreshTimer.stop();
+    QDialog::hideEvent(event);
+}
+
+void ScriptStatsDialog::refresh() {
+    const QList<ScriptProfiler::Stats> statsList = Scripting::getCallbackStats();
+    this->table->setRowCount(statsList.length());
+
+    auto setCell = [this](int row, int column, const QString &text) {
+        QTableWidgetItem *item = this->table->item(row, column);
+        if (!item) {
+            item = new QTableWidgetItem();
+            if (column >= 2 && column <= 7)
+                item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            this->table->setItem(row, column, item);
+        }
+        item->setText(text);
+    };
+
+    for (int row = 0; row < statsList.length(); row++) {
+        const ScriptProfiler::Stats &stats = statsList.at(row);
+        QString status = "OK";
+        if (stats.disabled) status = "Disabled";
+        else if (stats.debounced) status = "Debounced";
+
+        setCell(row, 0, stats.module);
+        setCell(row, 1, stats.callback);
+        setCell(row, 2, QString::number(stats.calls));
+        setCell(row, 3, QString::number(stats.skipped));
+        setCell(row, 4, QString::number(stats.totalMs, 'f', 1));
+        setCell(row, 5, QString::number(stats.averageMs(), 'f', 2));
+        setCell(row, 6, QString::number(stats.maxMs, 'f', 2));
+        setCell(row, 7, QString::number(stats.p95Ms, 'f', 2));
+        setCell(row, 8, status);
+    }
+}
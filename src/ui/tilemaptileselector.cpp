@@ -89,7 +89,11 @@ QImage TilemapTileSelector::tileImg(shared_ptr<TilemapTile> tile) {
     unsigned tileId = tile->id();
     QPoint pos = getTileIdCoords(tileId);
 
-    QImage tilesetImage = setPalette(tile->palette());
+    // Recoloring the tileset is much slower than copying a tile out of it, so it's only done once per palette.
+    auto it = this->palettedTilesets.constFind(tile->palette());
+    if (it == this->palettedTilesets.constEnd())
+        it = this->palettedTilesets.insert(tile->palette(), setPalette(tile->palette()));
+    const QImage &tilesetImage = it.value();
 
     // take a tile from the tileset
     QImage img = tilesetImage.copy(pos.x() * 8, pos.y() * 8, 8, 8);
@@ -1048,6 +1048,19 @@ void TilesetEditor::on_actionLayer_Grid_triggered(bool checked) {
     porymapConfig.showTilesetEditorLayerGrid = checked;
 }
 
+// Works with both loaded blockdata and BlockdataViews of layouts that haven't been loaded.
+template <typename Blocks>
+static void addMetatileUsage(const Blocks &blocks, bool usesPrimary, bool usesSecondary, QVector<uint16_t> *usedMetatiles) {
+    for (int i = 0; i < blocks.length(); i++) {
+        uint16_t metatileId = blocks.at(i).metatileId();
+        if (metatileId < Project::getNumMetatilesPrimary()) {
+            if (usesPrimary) (*usedMetatiles)[metatileId]++;
+        } else {
+            if (usesSecondary) (*usedMetatiles)[metatileId]++;
+        }
+    }
+}
+
 void TilesetEditor::countMetatileUsage() {
     // do not double count
     metatileSelector->usedMetatiles.fill(0);
@@ -1065,25 +1078,15 @@ void TilesetEditor::countMetatileUsage() {
         }
 
         if (usesPrimary || usesSecondary) {
-            this->project->loadLayout(layout);
-
             // for each block in the layout, mark in the vector that it is used
-            for (int i = 0; i < layout->blockdata.length(); i++) {
-                uint16_t metatileId = layout->blockdata.at(i).metatileId();
-                if (metatileId < this->project->getNumMetatilesPrimary()) {
-                    if (usesPrimary) metatileSelector->usedMetatiles[metatileId]++;
-                } else {
-                    if (usesSecondary) metatileSelector->usedMetatiles[metatileId]++;
-                }
-            }
-
-            for (int i = 0; i < layout->border.length(); i++) {
-                uint16_t metatileId = layout->border.at(i).metatileId();
-                if (metatileId < this->project->getNumMetatilesPrimary()) {
-                    if (usesPrimary) metatileSelector->usedMetatiles[metatileId]++;
-                } else {
-                    if (usesSecondary) metatileSelector->usedMetatiles[metatileId]++;
-                }
+            if (layout->loaded) {
+                addMetatileUsage(layout->blockdata, usesPrimary, usesSecondary, &metatileSelector->usedMetatiles);
+                addMetatileUsage(layout->border, usesPrimary, usesSecondary, &metatileSelector->usedMetatiles);
+            } else {
+                // Layouts that aren't open are read straight from their files, rather than being loaded just to be counted.
+                const QString root = this->project->root;
+                addMetatileUsage(this->project->readBlockdataView(root + "/" + layout->blockdata_path), usesPrimary, usesSecondary, &metatileSelector->usedMetatiles);
+                addMetatileUsage(this->project->readBlockdataView(root + "/" + layout->border_path), usesPrimary, usesSecondary, &metatileSelector->usedMetatiles);
             }
         }
     }
@@ -0,0 +1,88 @@
+#include "validationreport.h"
+
+#include <QApplication>
+#include <QDialogButtonBox>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+// The index of each row's issue is stored in its first cell, since sorting changes the row order.
+#define IssueIndexRole (Qt::UserRole + 1)
+
+ValidationReport::ValidationReport(Project *project, QWidget *parent) :
+    QDialog(parent),
+    validator(project)
+{
+    setAttribute(Qt::WA_DeleteOnClose);
+    setWindowTitle("Validation Report");
+    resize(900, 400);
+
+    this->summaryLabel = new QLabel();
+
+    this->table = new QTableWidget(0, 4);
+    this->table->setHorizontalHeaderLabels({"Severity", "Rule", "Location", "Message"});
+    this->table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    this->table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    this->table->setSelectionMode(QAbstractItemView::SingleSelection);
+    this->table->verticalHeader()->setVisible(false);
+    this->table->horizontalHeader()->setStretchLastSection(true);
+    this->table->setSortingEnabled(true);
+    connect(this->table, &QTableWidget::cellDoubleClicked, [this](int row, int) {
+        const int index = this->table->item(row, 0)->data(IssueIndexRole).toInt();
+        if (index >= 0 && index < this->issues.length())
+            emit jumpTo(this->issues.at(index));
+    });
+
+    auto buttonBox = new QDialogButtonBox(QDialogButtonBox::Close);
+    QPushButton *revalidateButton = buttonBox->addButton("Revalidate", QDialogButtonBox::ActionRole);
+    connect(revalidateButton, &QPushButton::clicked, this, &ValidationReport::validateAll);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::close);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(this->summaryLabel);
+    layout->addWidget(this->table);
+    layout->addWidget(buttonBox);
+}
+
+void ValidationReport::validateAll() {
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    this->validator.validateAll();
+    QApplication::restoreOverrideCursor();
+    refresh();
+}
+
+void ValidationReport::revalidateMap(const QString &mapName) {
+    this->validator.revalidateMap(mapName);
+    refresh();
+}
+
+void ValidationReport::refresh() {
+    this->issues = this->validator.getIssues();
+
+    // Sorting is turned off while the rows are filled, otherwise rows move while their cells are being set.
+    this->table->setSortingEnabled(false);
+    this->table->clearContents();
+    this->table->setRowCount(this->issues.length());
+    int numErrors = 0;
+    for (int row = 0; row < this->issues.length(); row++) {
+        const ValidationIssue &issue = this->issues.at(row);
+        const bool isError = issue.severity == ValidationIssue::Severity::Error;
+        if (isError) numErrors++;
+
+        auto severityItem = new QTableWidgetItem(isError ? "Error" : "Warning");
+        severityItem->setData(IssueIndexRole, row);
+        this->table->setItem(row, 0, severityItem);
+        this->table->setItem(row, 1, new QTableWidgetItem(issue.rule));
+        this->table->setItem(row, 2, new QTableWidgetItem(issue.location()));
+        this->table->setItem(row, 3, new QTableWidgetItem(issue.message));
+    }
+    this->table->setSortingEnabled(true);
+    this->table->resizeColumnToContents(0);
+    this->table->resizeColumnToContents(1);
+
+    if (this->issues.isEmpty())
+        this->summaryLabel->setText("No problems were found.");
+    else
+        this->summaryLabel->setText(QString("%1 errors and %2 warnings were found. Double-click a problem to go to it.")
+                                        .arg(numErrors).arg(this->issues.length() - numErrors));
+}
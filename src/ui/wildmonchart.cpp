@@ -119,7 +119,7 @@ void WildMonChart::readTable() {
         const QString groupName = this->tableIndexToGroupName.value(i);
 
         // Create species label (strip 'SPECIES_' prefix).
-        QString label = pokemon.species;
+        QString label = pokemon.species.toString();
         if (label.startsWith(speciesPrefix))
             label.remove(0, speciesPrefix.length());
 